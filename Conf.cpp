@@ -51,6 +51,10 @@ m_displayServerPort(62001),
 m_displayServerType(),
 m_displayServerDebug(false),
 m_displayServerTrace(false),
+m_displayServerTimestamps(false),
+m_displayServerMetricsAddress("127.0.0.1"),
+m_displayServerMetricsPort(0U),
+m_displayServerCaptureFile(),
 m_rxFrequency(0U),
 m_txFrequency(0U),
 m_transparentEnabled(false),
@@ -61,6 +65,11 @@ m_transparentLocalPort(40095U),
 m_transparentSendFrameType(0U),
 m_dmrIdLookupFile(),
 m_dmrIdLookupTime(0U),
+m_dmrIdLookupThreads(1U),
+m_dmrIdLookupTalkgroupFile(),
+m_dmrIdLookupFilter(),
+m_dmrIdLookupMaxEntries(0U),
+m_dmrIdLookupLazy(false),
 m_logLevel(),
 m_syslog(false),
 m_dmrId(0U),
@@ -184,6 +193,16 @@ bool CConf::read()
 			m_dmrIdLookupFile = value;
 		else if (::strcmp(key, "Time") == 0)
 			m_dmrIdLookupTime = (unsigned int)::atoi(value);
+		else if (::strcmp(key, "Threads") == 0)
+			m_dmrIdLookupThreads = (unsigned int)::atoi(value);
+		else if (::strcmp(key, "TalkgroupFile") == 0)
+			m_dmrIdLookupTalkgroupFile = value;
+		else if (::strcmp(key, "Filter") == 0)
+			m_dmrIdLookupFilter = value;
+		else if (::strcmp(key, "MaxEntries") == 0)
+			m_dmrIdLookupMaxEntries = (unsigned int)::atoi(value);
+		else if (::strcmp(key, "Lazy") == 0)
+			m_dmrIdLookupLazy = ::atoi(value) == 1;
 	} else if (section == SECTION_TRANSPARENT) {
 		if (::strcmp(key, "Enable") == 0)
 			m_transparentEnabled = ::atoi(value) == 1;
@@ -220,6 +239,14 @@ bool CConf::read()
 			m_displayServerDebug = ::atoi(value) == 1;
 		else if (::strcmp(key, "Trace") == 0)
 			m_displayServerTrace = ::atoi(value) == 1;
+		else if (::strcmp(key, "Timestamps") == 0)
+			m_displayServerTimestamps = ::atoi(value) == 1;
+		else if (::strcmp(key, "MetricsAddress") == 0)
+			m_displayServerMetricsAddress = value;
+		else if (::strcmp(key, "MetricsPort") == 0)
+			m_displayServerMetricsPort = (unsigned int)::atoi(value);
+		else if (::strcmp(key, "CaptureFile") == 0)
+			m_displayServerCaptureFile = value;
 	} else if (section == SECTION_TFTSERIAL) {
 		if (::strcmp(key, "Port") == 0)
 			m_tftSerialPort = value;
@@ -344,6 +371,31 @@ unsigned int CConf::getDMRIdLookupTime() const
 	return m_dmrIdLookupTime;
 }
 
+unsigned int CConf::getDMRIdLookupThreads() const
+{
+	return m_dmrIdLookupThreads;
+}
+
+std::string CConf::getDMRIdLookupTalkgroupFile() const
+{
+	return m_dmrIdLookupTalkgroupFile;
+}
+
+std::string CConf::getDMRIdLookupFilter() const
+{
+	return m_dmrIdLookupFilter;
+}
+
+unsigned int CConf::getDMRIdLookupMaxEntries() const
+{
+	return m_dmrIdLookupMaxEntries;
+}
+
+bool CConf::getDMRIdLookupLazy() const
+{
+	return m_dmrIdLookupLazy;
+}
+
 unsigned int CConf::getDMRId() const
 {
 	return m_dmrId;
@@ -488,3 +540,23 @@ bool CConf::getDisplayServerTrace() const
 {
 	return m_displayServerTrace;
 }
+
+bool CConf::getDisplayServerTimestamps() const
+{
+	return m_displayServerTimestamps;
+}
+
+std::string CConf::getDisplayServerMetricsAddress() const
+{
+	return m_displayServerMetricsAddress;
+}
+
+unsigned int CConf::getDisplayServerMetricsPort() const
+{
+	return m_displayServerMetricsPort;
+}
+
+std::string CConf::getDisplayServerCaptureFile() const
+{
+	return m_displayServerCaptureFile;
+}
@@ -40,6 +40,11 @@ public:
   // The DMR Id section
   std::string  getDMRIdLookupFile() const;
   unsigned int getDMRIdLookupTime() const;
+  unsigned int getDMRIdLookupThreads() const;
+  std::string  getDMRIdLookupTalkgroupFile() const;
+  std::string  getDMRIdLookupFilter() const;
+  unsigned int getDMRIdLookupMaxEntries() const;
+  bool         getDMRIdLookupLazy() const;
 
   // The Display section
   std::string  getDisplayServerAddress() const;
@@ -47,6 +52,10 @@ public:
   std::string  getDisplayServerType() const;
   bool         getDisplayServerDebug() const;
   bool         getDisplayServerTrace() const;
+  bool         getDisplayServerTimestamps() const;
+  std::string  getDisplayServerMetricsAddress() const;
+  unsigned int getDisplayServerMetricsPort() const;
+  std::string  getDisplayServerCaptureFile() const;
   unsigned int getLogLevel() const;
   bool         getSyslog() const;
 
@@ -105,6 +114,10 @@ private:
   std::string  m_displayServerType;
   bool         m_displayServerDebug;
   bool         m_displayServerTrace;
+  bool         m_displayServerTimestamps;
+  std::string  m_displayServerMetricsAddress;
+  unsigned int m_displayServerMetricsPort;
+  std::string  m_displayServerCaptureFile;
 
   unsigned int m_rxFrequency;
   unsigned int m_txFrequency;
@@ -118,6 +131,11 @@ private:
 
   std::string  m_dmrIdLookupFile;
   unsigned int m_dmrIdLookupTime;
+  unsigned int m_dmrIdLookupThreads;
+  std::string  m_dmrIdLookupTalkgroupFile;
+  std::string  m_dmrIdLookupFilter;
+  unsigned int m_dmrIdLookupMaxEntries;
+  bool         m_dmrIdLookupLazy;
 
   unsigned int m_logLevel;
   bool         m_syslog;
@@ -0,0 +1,289 @@
+/*
+ *   Copyright (C) 2026 by BrandMeister
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "DMRCountry.h"
+
+#include <cstddef>
+
+struct DMRCountry {
+	unsigned short mcc;
+	const char*    name;
+};
+
+// Sorted by code, checked below
+static constexpr DMRCountry COUNTRIES[] = {
+	{ 202U, "Greece" },
+	{ 204U, "Netherlands" },
+	{ 206U, "Belgium" },
+	{ 208U, "France" },
+	{ 212U, "Monaco" },
+	{ 213U, "Andorra" },
+	{ 214U, "Spain" },
+	{ 216U, "Hungary" },
+	{ 218U, "Bosnia and Hercegovina" },
+	{ 219U, "Croatia" },
+	{ 220U, "Serbia" },
+	{ 221U, "Kosovo" },
+	{ 222U, "Italy" },
+	{ 225U, "Vatican" },
+	{ 226U, "Romania" },
+	{ 228U, "Switzerland" },
+	{ 230U, "Czech Republic" },
+	{ 231U, "Slovakia" },
+	{ 232U, "Austria" },
+	{ 234U, "United Kingdom" },
+	{ 235U, "United Kingdom" },
+	{ 238U, "Denmark" },
+	{ 240U, "Sweden" },
+	{ 242U, "Norway" },
+	{ 244U, "Finland" },
+	{ 246U, "Lithuania" },
+	{ 247U, "Latvia" },
+	{ 248U, "Estonia" },
+	{ 250U, "Russia" },
+	{ 255U, "Ukraine" },
+	{ 257U, "Belarus" },
+	{ 259U, "Moldova" },
+	{ 260U, "Poland" },
+	{ 262U, "Germany" },
+	{ 263U, "Germany" },
+	{ 264U, "Germany" },
+	{ 266U, "Gibraltar" },
+	{ 268U, "Portugal" },
+	{ 270U, "Luxembourg" },
+	{ 272U, "Ireland" },
+	{ 274U, "Iceland" },
+	{ 276U, "Albania" },
+	{ 278U, "Malta" },
+	{ 280U, "Cyprus" },
+	{ 282U, "Georgia" },
+	{ 283U, "Armenia" },
+	{ 284U, "Bulgaria" },
+	{ 286U, "Turkey" },
+	{ 288U, "Faroe Islands" },
+	{ 290U, "Greenland" },
+	{ 292U, "San Marino" },
+	{ 293U, "Slovenia" },
+	{ 294U, "North Macedonia" },
+	{ 295U, "Liechtenstein" },
+	{ 297U, "Montenegro" },
+	{ 302U, "Canada" },
+	{ 308U, "Saint Pierre and Miquelon" },
+	{ 310U, "United States" },
+	{ 311U, "United States" },
+	{ 312U, "United States" },
+	{ 313U, "United States" },
+	{ 314U, "United States" },
+	{ 315U, "United States" },
+	{ 316U, "United States" },
+	{ 330U, "Puerto Rico" },
+	{ 334U, "Mexico" },
+	{ 338U, "Jamaica" },
+	{ 340U, "French Antilles" },
+	{ 342U, "Barbados" },
+	{ 344U, "Antigua and Barbuda" },
+	{ 346U, "Cayman Islands" },
+	{ 348U, "British Virgin Islands" },
+	{ 350U, "Bermuda" },
+	{ 352U, "Grenada" },
+	{ 354U, "Montserrat" },
+	{ 356U, "Saint Kitts and Nevis" },
+	{ 358U, "Saint Lucia" },
+	{ 360U, "Saint Vincent and the Grenadines" },
+	{ 362U, "Curacao" },
+	{ 363U, "Aruba" },
+	{ 364U, "Bahamas" },
+	{ 365U, "Anguilla" },
+	{ 366U, "Dominica" },
+	{ 368U, "Cuba" },
+	{ 370U, "Dominican Republic" },
+	{ 372U, "Haiti" },
+	{ 374U, "Trinidad and Tobago" },
+	{ 376U, "Turks and Caicos Islands" },
+	{ 400U, "Azerbaijan" },
+	{ 401U, "Kazakhstan" },
+	{ 402U, "Bhutan" },
+	{ 404U, "India" },
+	{ 405U, "India" },
+	{ 410U, "Pakistan" },
+	{ 412U, "Afghanistan" },
+	{ 413U, "Sri Lanka" },
+	{ 414U, "Myanmar" },
+	{ 415U, "Lebanon" },
+	{ 416U, "Jordan" },
+	{ 417U, "Syria" },
+	{ 418U, "Iraq" },
+	{ 419U, "Kuwait" },
+	{ 420U, "Saudi Arabia" },
+	{ 421U, "Yemen" },
+	{ 422U, "Oman" },
+	{ 424U, "United Arab Emirates" },
+	{ 425U, "Israel" },
+	{ 426U, "Bahrain" },
+	{ 427U, "Qatar" },
+	{ 428U, "Mongolia" },
+	{ 429U, "Nepal" },
+	{ 432U, "Iran" },
+	{ 434U, "Uzbekistan" },
+	{ 436U, "Tajikistan" },
+	{ 437U, "Kyrgyzstan" },
+	{ 438U, "Turkmenistan" },
+	{ 440U, "Japan" },
+	{ 441U, "Japan" },
+	{ 450U, "Korea Republic of" },
+	{ 452U, "Vietnam" },
+	{ 454U, "Hong Kong" },
+	{ 455U, "Macao" },
+	{ 456U, "Cambodia" },
+	{ 457U, "Laos" },
+	{ 460U, "China" },
+	{ 466U, "Taiwan" },
+	{ 470U, "Bangladesh" },
+	{ 472U, "Maldives" },
+	{ 502U, "Malaysia" },
+	{ 505U, "Australia" },
+	{ 510U, "Indonesia" },
+	{ 514U, "Timor-Leste" },
+	{ 515U, "Philippines" },
+	{ 520U, "Thailand" },
+	{ 525U, "Singapore" },
+	{ 528U, "Brunei Darussalam" },
+	{ 530U, "New Zealand" },
+	{ 536U, "Nauru" },
+	{ 537U, "Papua New Guinea" },
+	{ 539U, "Tonga" },
+	{ 540U, "Solomon Islands" },
+	{ 541U, "Vanuatu" },
+	{ 542U, "Fiji" },
+	{ 544U, "American Samoa" },
+	{ 545U, "Kiribati" },
+	{ 546U, "New Caledonia" },
+	{ 547U, "French Polynesia" },
+	{ 548U, "Cook Islands" },
+	{ 549U, "Samoa" },
+	{ 550U, "Micronesia" },
+	{ 551U, "Marshall Islands" },
+	{ 552U, "Palau" },
+	{ 602U, "Egypt" },
+	{ 603U, "Algeria" },
+	{ 604U, "Morocco" },
+	{ 605U, "Tunisia" },
+	{ 606U, "Libya" },
+	{ 607U, "Gambia" },
+	{ 608U, "Senegal" },
+	{ 609U, "Mauritania" },
+	{ 610U, "Mali" },
+	{ 611U, "Guinea" },
+	{ 612U, "Ivory Coast" },
+	{ 613U, "Burkina Faso" },
+	{ 614U, "Niger" },
+	{ 615U, "Togo" },
+	{ 616U, "Benin" },
+	{ 617U, "Mauritius" },
+	{ 618U, "Liberia" },
+	{ 619U, "Sierra Leone" },
+	{ 620U, "Ghana" },
+	{ 621U, "Nigeria" },
+	{ 622U, "Chad" },
+	{ 623U, "Central African Republic" },
+	{ 624U, "Cameroon" },
+	{ 625U, "Cape Verde" },
+	{ 626U, "Sao Tome and Principe" },
+	{ 627U, "Equatorial Guinea" },
+	{ 628U, "Gabon" },
+	{ 629U, "Congo" },
+	{ 630U, "Democratic Republic of the Congo" },
+	{ 631U, "Angola" },
+	{ 632U, "Guinea-Bissau" },
+	{ 633U, "Seychelles" },
+	{ 634U, "Sudan" },
+	{ 635U, "Rwanda" },
+	{ 636U, "Ethiopia" },
+	{ 637U, "Somalia" },
+	{ 638U, "Djibouti" },
+	{ 639U, "Kenya" },
+	{ 640U, "Tanzania" },
+	{ 641U, "Uganda" },
+	{ 642U, "Burundi" },
+	{ 643U, "Mozambique" },
+	{ 645U, "Zambia" },
+	{ 646U, "Madagascar" },
+	{ 647U, "Reunion" },
+	{ 648U, "Zimbabwe" },
+	{ 649U, "Namibia" },
+	{ 650U, "Malawi" },
+	{ 651U, "Lesotho" },
+	{ 652U, "Botswana" },
+	{ 653U, "Eswatini" },
+	{ 654U, "Comoros" },
+	{ 655U, "South Africa" },
+	{ 657U, "Eritrea" },
+	{ 659U, "South Sudan" },
+	{ 702U, "Belize" },
+	{ 704U, "Guatemala" },
+	{ 706U, "El Salvador" },
+	{ 708U, "Honduras" },
+	{ 710U, "Nicaragua" },
+	{ 712U, "Costa Rica" },
+	{ 714U, "Panama" },
+	{ 716U, "Peru" },
+	{ 722U, "Argentina" },
+	{ 724U, "Brazil" },
+	{ 730U, "Chile" },
+	{ 732U, "Colombia" },
+	{ 734U, "Venezuela" },
+	{ 736U, "Bolivia" },
+	{ 738U, "Guyana" },
+	{ 740U, "Ecuador" },
+	{ 742U, "French Guiana" },
+	{ 744U, "Paraguay" },
+	{ 746U, "Suriname" },
+	{ 748U, "Uruguay" },
+	{ 750U, "Falkland Islands" }
+};
+
+const size_t COUNTRY_COUNT = sizeof(COUNTRIES) / sizeof(COUNTRIES[0U]);
+
+static constexpr bool isSorted(size_t i)
+{
+	return i + 1U >= COUNTRY_COUNT || (COUNTRIES[i].mcc < COUNTRIES[i + 1U].mcc && isSorted(i + 1U));
+}
+
+static_assert(isSorted(0U), "COUNTRIES must be sorted by code");
+
+const char* CDMRCountry::find(unsigned int id)
+{
+	if (id < 100000U)
+		return NULL;
+
+	// 6 digit repeater, 7 digit user and 9 digit hotspot IDs alike
+	while (id >= 1000U)
+		id /= 10U;
+
+	size_t lo = 0U, hi = COUNTRY_COUNT;
+	while (lo < hi) {
+		size_t mid = (lo + hi) / 2U;
+
+		if (COUNTRIES[mid].mcc < id)
+			lo = mid + 1U;
+		else
+			hi = mid;
+	}
+
+	return lo < COUNTRY_COUNT && COUNTRIES[lo].mcc == id ? COUNTRIES[lo].name : NULL;
+}
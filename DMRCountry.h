@@ -0,0 +1,28 @@
+/*
+ *   Copyright (C) 2026 by BrandMeister
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#pragma once
+
+// The country a DMR ID is registered in, from the Mobile Country Code its
+// first three digits hold (e.g. 262 Germany, 310 - 316 United States).
+// The names are spelled as in the RadioID database.
+class CDMRCountry {
+public:
+	// NULL for IDs shorter than six digits (talkgroups) or an unknown code
+	static const char* find(unsigned int id);
+};
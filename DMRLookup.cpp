@@ -17,55 +17,152 @@
 */
 
 #include "DMRLookup.h"
-#include "Timer.h"
 #include "Log.h"
 
+#include <algorithm>
+
+#include <cerrno>
+#include <climits>
+#include <cstdint>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <cctype>
+#include <ctime>
+
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// After a change is seen, wait this long for the writer to finish
+const unsigned long long RELOAD_SETTLE_MS = 1000ULL;
 
-CDMRLookup::CDMRLookup(const std::string& filename, unsigned int reloadTime) :
+CDMRLookup::CDMRLookup(const std::string& filename, unsigned int reloadTime, unsigned int threads, bool talkgroups) :
 CThread(),
 m_filename(filename),
+m_name(filename),
 m_reloadTime(reloadTime),
-m_table(),
-m_stop(false)
+m_talkgroups(talkgroups),
+m_label(talkgroups ? "talkgroup" : "DMR Id"),
+m_table(threads, !talkgroups),
+m_cache(),
+m_stop(false),
+m_reactor(),
+m_stopFd(-1),
+m_inotifyFd(-1),
+m_changed(false),
+m_settleAt(0ULL),
+m_mtime(0ULL),
+m_size(0)
 {
+	size_t pos = filename.find_last_of('/');
+	if (pos != std::string::npos)
+		m_name = filename.substr(pos + 1U);
 }
 
 CDMRLookup::~CDMRLookup()
 {
 }
 
+bool CDMRLookup::setFilter(const std::string& filter, unsigned int maxEntries)
+{
+	return m_table.setFilter(filter, maxEntries);
+}
+
+void CDMRLookup::setLazy(bool lazy)
+{
+	m_table.setLazy(lazy);
+}
+
 bool CDMRLookup::read()
 {
+	unsigned long long mtime = 0ULL;
+	off_t size = 0;
+	bool found = getStatus(mtime, size);
+
 	bool ret = m_table.load(m_filename);
+	if (ret && found) {
+		m_mtime = mtime;
+		m_size  = size;
+	}
 
-	if (m_reloadTime > 0U)
-		run();
+	if (m_reloadTime > 0U) {
+		m_stopFd = ::eventfd(0U, EFD_NONBLOCK | EFD_CLOEXEC);
+
+		if (m_stopFd < 0 || !m_reactor.open() || !m_reactor.add(m_stopFd, this)) {
+			LogError("Cannot set up the %s lookup reload thread, err: %d, the file will not be reloaded", m_label, errno);
+			closeReload();
+			return ret;
+		}
+
+		watch();
+
+		if (!run()) {
+			LogError("Cannot start the %s lookup reload thread, the file will not be reloaded", m_label);
+			closeReload();
+		}
+	}
 
 	return ret;
 }
 
 void CDMRLookup::entry()
 {
-	LogInfo("Started the DMR Id lookup reload thread");
+	LogInfo("Started the %s lookup reload thread", m_label);
 
-	CTimer timer(1U, 3600U * m_reloadTime);
-	timer.start();
+	// Also checked every reloadTime hours, in case inotify misses a change
+	// (e.g. on a network filesystem). The deadline is kept across wakeups,
+	// so events for other files in the directory don't put it off.
+	unsigned long long period  = 3600000ULL * m_reloadTime;
+	unsigned long long checkAt = getTime() + period;
 
 	while (!m_stop) {
-		sleep(1000U);
+		unsigned long long now    = getTime();
+		unsigned long long wakeAt = m_changed ? std::min(m_settleAt, checkAt) : checkAt;
+		unsigned long long wait   = wakeAt > now ? wakeAt - now : 0ULL;
 
-		timer.clock();
-		if (timer.hasExpired()) {
-			m_table.load(m_filename);
-			timer.start();
+		if (m_reactor.wait(wait > INT_MAX ? INT_MAX : int(wait)) < 0)
+			break;
+
+		now = getTime();
+		if ((m_changed && now >= m_settleAt) || now >= checkAt) {
+			m_changed = false;
+			checkAt   = now + period;
+			reload();
 		}
 	}
 
-	LogInfo("Stopped the DMR Id lookup reload thread");
+	LogInfo("Stopped the %s lookup reload thread", m_label);
+}
+
+bool CDMRLookup::readable(int fd)
+{
+	if (fd == m_stopFd) {
+		uint64_t value;
+		while (::read(m_stopFd, &value, sizeof(value)) > 0)
+			;
+		return true;
+	}
+
+	char buffer[4096U] __attribute__((aligned(__alignof__(struct inotify_event))));
+
+	ssize_t len;
+	while ((len = ::read(m_inotifyFd, buffer, sizeof(buffer))) > 0) {
+		for (char* p = buffer; p < buffer + len; ) {
+			const struct inotify_event* event = (const struct inotify_event*)p;
+
+			// Writes keep putting the reload off until the file settles
+			if (event->len > 0U && m_name == event->name) {
+				m_changed  = true;
+				m_settleAt = getTime() + RELOAD_SETTLE_MS;
+			}
+
+			p += sizeof(struct inotify_event) + event->len;
+		}
+	}
+
+	return true;
 }
 
 void CDMRLookup::stop()
@@ -77,24 +174,157 @@ void CDMRLookup::stop()
 
 	m_stop = true;
 
+	uint64_t value = 1U;
+	if (m_stopFd >= 0 && ::write(m_stopFd, &value, sizeof(value)) < 0)
+		LogError("Cannot wake the %s lookup reload thread, err: %d", m_label, errno);
+
 	wait();
+
+	closeReload();
+}
+
+const char* CDMRLookup::find(unsigned int id)
+{
+	return lookup(id).get(UDF_CALLSIGN);
+}
+
+void CDMRLookup::findUser(unsigned int id, class CUserDBentry& entry)
+{
+	entry = lookup(id);
+}
+
+unsigned long long CDMRLookup::getCacheHits() const
+{
+	return m_cache.getHits();
+}
+
+unsigned long long CDMRLookup::getCacheMisses() const
+{
+	return m_cache.getMisses();
 }
 
-std::string CDMRLookup::find(unsigned int id)
+unsigned int CDMRLookup::getSize() const
 {
-	std::string callsign;
+	return m_table.getSize();
+}
+
+size_t CDMRLookup::getMemory() const
+{
+	return m_table.getMemory();
+}
 
-	if (id == 0xFFFFFFU)
-		return std::string("ALL");
+unsigned int CDMRLookup::getLoadTime() const
+{
+	return m_table.getLoadTime();
+}
+
+// The returned entry is only valid until the next lookup
+const CUserDBentry& CDMRLookup::lookup(unsigned int id)
+{
+	const CUserDBentry* cached = m_cache.find(id, m_table.getGeneration());
+	if (cached != NULL)
+		return *cached;
 
 	class CUserDBentry entry;
-	if (m_table.lookup(id, &entry)) {
-		callsign = entry.get(keyCALLSIGN);
-	} else {
+
+	if (id == 0xFFFFFFU) {
+		entry.set(UDF_CALLSIGN, "ALL");
+	} else if (!m_table.lookup(id, &entry)) {
 		char text[10U];
 		::snprintf(text, sizeof(text), "%u", id);
-		callsign = std::string(text);
+
+		entry.clear();
+		entry.set(UDF_CALLSIGN, text);
+	} else if (m_talkgroups) {
+		// The cache keeps the formatted name, so it's only built once
+		char text[USERDB_ENTRY_LENGTH];
+		::snprintf(text, sizeof(text), "%u %s", id, entry.get(UDF_CALLSIGN));
+
+		entry.clear();
+		entry.set(UDF_CALLSIGN, text);
+	}
+
+	// Cached with the lines the displays draw, so they are only built once
+	entry.format();
+
+	return m_cache.add(id, entry);
+}
+
+// The directory is watched rather than the file, download scripts usually
+// replace the file by renaming a new one over it
+bool CDMRLookup::watch()
+{
+	std::string dir = ".";
+
+	size_t pos = m_filename.find_last_of('/');
+	if (pos != std::string::npos)
+		dir = pos == 0U ? "/" : m_filename.substr(0U, pos);
+
+	m_inotifyFd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+	if (m_inotifyFd < 0 || ::inotify_add_watch(m_inotifyFd, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+		LogWarning("Cannot watch %s for changes, checking it every %u hours", dir.c_str(), m_reloadTime);
+
+		if (m_inotifyFd >= 0)
+			::close(m_inotifyFd);
+		m_inotifyFd = -1;
+
+		return false;
 	}
 
-	return callsign;
+	m_reactor.add(m_inotifyFd, this);
+
+	return true;
+}
+
+// Without a reload thread, stop() then only deletes the lookup
+void CDMRLookup::closeReload()
+{
+	m_reactor.close();
+
+	if (m_inotifyFd >= 0)
+		::close(m_inotifyFd);
+	if (m_stopFd >= 0)
+		::close(m_stopFd);
+
+	m_inotifyFd  = -1;
+	m_stopFd     = -1;
+	m_reloadTime = 0U;
+}
+
+// The new modification time and size are only recorded once the file has
+// loaded, so a failed load is tried again at the next check
+void CDMRLookup::reload()
+{
+	unsigned long long mtime;
+	off_t size;
+	if (!getStatus(mtime, size) || (mtime == m_mtime && size == m_size))
+		return;
+
+	if (m_table.load(m_filename)) {
+		m_mtime = mtime;
+		m_size  = size;
+	}
+}
+
+// CLOCK_MONOTONIC in ms
+unsigned long long CDMRLookup::getTime()
+{
+	struct timespec now;
+	::clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return now.tv_sec * 1000ULL + now.tv_nsec / 1000000ULL;
+}
+
+// The file's modification time in ns and its size, false if it is missing
+bool CDMRLookup::getStatus(unsigned long long& mtime, off_t& size) const
+{
+	struct stat st;
+	if (::stat(m_filename.c_str(), &st) < 0)
+		return false;
+
+	mtime = st.st_mtim.tv_sec * 1000000000ULL + st.st_mtim.tv_nsec;
+	size  = st.st_size;
+
+	return true;
 }
@@ -18,27 +18,71 @@
 
 #pragma once
 
+#include "Reactor.h"
 #include "Thread.h"
 #include "UserDB.h"
+#include "UserDBCache.h"
 
+#include <atomic>
 #include <string>
 
-class CDMRLookup : public CThread {
+#include <sys/types.h>
+
+class CDMRLookup : public CThread, public IReactorHandler {
 public:
-	CDMRLookup(const std::string& filename, unsigned int reloadTime);
+	// With talkgroups set the file holds ID,Name rows and find() returns
+	// "91 Worldwide" rather than a callsign
+	CDMRLookup(const std::string& filename, unsigned int reloadTime, unsigned int threads = 1U, bool talkgroups = false);
 	virtual ~CDMRLookup();
 
+	// Before read(), see CUserDB::setFilter()
+	bool setFilter(const std::string& filter, unsigned int maxEntries);
+	void setLazy(bool lazy);
+
 	bool read();
 
 	virtual void entry() override;
 
-	std::string find(unsigned int id);
+	virtual bool readable(int fd) override;
+
+	// Borrowed from the lookup cache, only valid until the next lookup
+	const char* find(unsigned int id);
+
+	// Fills in every known field, unknown IDs get the ID as the callsign
+	void findUser(unsigned int id, class CUserDBentry& entry);
 
 	void stop();
 
+	unsigned long long getCacheHits() const;
+	unsigned long long getCacheMisses() const;
+
+	// Of the table last loaded, see CUserDB
+	unsigned int getSize() const;
+	size_t       getMemory() const;
+	unsigned int getLoadTime() const;
+
 private:
-	std::string     m_filename;
-	unsigned int    m_reloadTime;
-	class CUserDB   m_table;
-	bool            m_stop;
+	std::string        m_filename;
+	std::string        m_name;		// m_filename without the directory
+	unsigned int       m_reloadTime;
+	bool               m_talkgroups;
+	const char*        m_label;		// for the log
+	class CUserDB      m_table;
+	CUserDBCache       m_cache;		// only used by the thread calling find()
+	std::atomic<bool>  m_stop;
+	CReactor           m_reactor;
+	int                m_stopFd;
+	int                m_inotifyFd;
+	bool               m_changed;
+	unsigned long long m_settleAt;		// ms, when to reload after a change
+	unsigned long long m_mtime;		// ns
+	off_t              m_size;
+
+	const CUserDBentry& lookup(unsigned int id);
+	bool watch();
+	void closeReload();
+	void reload();
+	bool getStatus(unsigned long long& mtime, off_t& size) const;
+
+	static unsigned long long getTime();
 };
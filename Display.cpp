@@ -22,6 +22,7 @@
 #include "NullDisplay.h"
 #include "TransparentDataPort.h"
 #include "TFTSurenoo.h"
+#include "UserDBentry.h"
 #include "LCDproc.h"
 #include "Nextion.h"
 #include "Conf.h"
@@ -39,7 +40,8 @@ CDisplay::CDisplay() :
 m_timer1(3000U, 3U),
 m_timer2(3000U, 3U),
 m_mode1(MODE_IDLE),
-m_mode2(MODE_IDLE)
+m_mode2(MODE_IDLE),
+m_written(0ULL)
 {
 }
 
@@ -82,8 +84,9 @@ void CDisplay::setQuit()
 	setQuitInt();
 }
 
-void CDisplay::writeDMR(unsigned int slotNo, const std::string& src, bool group, const std::string& dst, const char* type)
+void CDisplay::writeDMR(unsigned int slotNo, const class CUserDBentry& src, bool group, const char* dst, const char* type)
 {
+	assert(dst != NULL);
 	assert(type != NULL);
 
 	if (slotNo == 1U) {
@@ -93,7 +96,9 @@ void CDisplay::writeDMR(unsigned int slotNo, const std::string& src, bool group,
 		m_timer2.start();
 		m_mode2 = MODE_IDLE;
 	}
-	writeDMRInt(slotNo, src, group, dst, type);
+
+	if (writeDMRIntEx(slotNo, src, group, dst, type))
+		writeDMRInt(slotNo, src.get(UDF_CALLSIGN), group, dst, type);
 }
 
 void CDisplay::writeDMRRSSI(unsigned int slotNo, unsigned char rssi)
@@ -199,10 +204,53 @@ void CDisplay::clock(unsigned int ms)
 	clockInt(ms);
 }
 
+unsigned int CDisplay::getTimeout()
+{
+	unsigned int timeout = getTimeoutInt();
+
+	timeout = nextTimeout(timeout, m_timer1);
+	timeout = nextTimeout(timeout, m_timer2);
+
+	return timeout;
+}
+
+unsigned int CDisplay::nextTimeout(unsigned int timeout, CTimer& timer)
+{
+	// Expired timers that are still running only matter to the next clearXXX()
+	unsigned int remaining = timer.getRemainingMS();
+	if (remaining == 0U)
+		return timeout;
+
+	if (timeout == 0U || remaining < timeout)
+		return remaining;
+
+	return timeout;
+}
+
+int CDisplay::getFd()
+{
+	return -1;
+}
+
+bool CDisplay::read()
+{
+	return false;
+}
+
 void CDisplay::clockInt(unsigned int ms)
 {
 }
 
+unsigned int CDisplay::getTimeoutInt()
+{
+	return 0U;
+}
+
+int CDisplay::writeDMRIntEx(unsigned int slotNo, const class CUserDBentry& src, bool group, const char* dst, const char* type)
+{
+	return -1;
+}
+
 void CDisplay::writeDMRRSSIInt(unsigned int slotNo, unsigned char rssi)
 {
 }
@@ -215,6 +263,16 @@ void CDisplay::writeDMRBERInt(unsigned int slotNo, float ber)
 {
 }
 
+unsigned long long CDisplay::getWritten() const
+{
+	return m_written.load(std::memory_order_relaxed);
+}
+
+void CDisplay::addWritten(unsigned int bytes)
+{
+	m_written.fetch_add(bytes, std::memory_order_relaxed);
+}
+
 /* Factory method extracted from MMDVMHost.cpp - BG5HHP */
 CDisplay* CDisplay::createDisplay(const CConf& conf)
 {
@@ -20,6 +20,7 @@
 
 #include "Timer.h"
 
+#include <atomic>
 #include <string>
 
 #include <cstdint>
@@ -38,7 +39,7 @@ public:
 	void setError(const char* text);
 	void setQuit();
 
-	void writeDMR(unsigned int slotNo, const std::string& src, bool group, const std::string& dst, const char* type);
+	void writeDMR(unsigned int slotNo, const class CUserDBentry& src, bool group, const char* dst, const char* type);
 	void writeDMRRSSI(unsigned int slotNo, unsigned char rssi);
 	void writeDMRBER(unsigned int slotNo, float ber);
 	void writeDMRTA(unsigned int slotNo, unsigned char* talkerAlias, const char* type);
@@ -53,6 +54,18 @@ public:
 
 	void clock(unsigned int ms);
 
+	// Time in ms until clock() has work to do, 0 if nothing is pending
+	unsigned int getTimeout();
+
+	// Descriptor the display wants to read from, -1 if none
+	virtual int getFd();
+
+	// Called when getFd() is readable, return false to stop watching it
+	virtual bool read();
+
+	// Bytes sent to the panel so far, may be read from any thread
+	unsigned long long getWritten() const;
+
 	static CDisplay* createDisplay(const CConf& conf);
 
 protected:
@@ -60,7 +73,9 @@ protected:
 	virtual void setErrorInt(const char* text) = 0;
 	virtual void setQuitInt() = 0;
 
-	virtual void writeDMRInt(unsigned int slotNo, const std::string& src, bool group, const std::string& dst, const char* type) = 0;
+	virtual void writeDMRInt(unsigned int slotNo, const char* src, bool group, const char* dst, const char* type) = 0;
+	// Displays that can show more than the callsign, return non zero to have writeDMRInt() called as well
+	virtual int writeDMRIntEx(unsigned int slotNo, const class CUserDBentry& src, bool group, const char* dst, const char* type);
 	virtual void writeDMRRSSIInt(unsigned int slotNo, unsigned char rssi);
 	virtual void writeDMRTAInt(unsigned int slotNo, unsigned char* talkerAlias, const char* type);
 	virtual void writeDMRBERInt(unsigned int slotNo, float ber);
@@ -73,10 +88,17 @@ protected:
 	virtual void clearCWInt() = 0;
 
 	virtual void clockInt(unsigned int ms);
+	virtual unsigned int getTimeoutInt();
+
+	static unsigned int nextTimeout(unsigned int timeout, CTimer& timer);
+
+	// Drivers count what they send to the panel
+	void addWritten(unsigned int bytes);
 
 private:
 	CTimer        m_timer1;
 	CTimer        m_timer2;
 	unsigned char m_mode1;
 	unsigned char m_mode2;
+	std::atomic<unsigned long long> m_written;
 };
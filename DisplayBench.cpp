@@ -0,0 +1,1587 @@
+/*
+ *   Copyright (C) 2026 by BrandMeister
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+// Benchmarks of the ID tables, the protocol decoder and the display
+// drivers, run against synthetic data and mock ports so that they need no
+// display hardware. Each result is printed as one JSON object per line.
+
+#include "DisplayDecoder.h"
+#include "DisplayEncoder.h"
+#include "DisplayProtocol.h"
+#include "DMRLookup.h"
+#include "GitVersion.h"
+#include "LCDproc.h"
+#include "Log.h"
+#include "MockSerialPort.h"
+#include "Nextion.h"
+#include "TFTSurenoo.h"
+#include "Thread.h"
+#include "UserDB.h"
+#include "UserDBentry.h"
+#include "UserDBParser.h"
+#include "Version.h"
+
+// Replaces new and delete, only this file of the bench may include it
+#include "tests/AllocCounter.h"
+
+#if defined(HAVE_ZLIB)
+#include <zlib.h>
+#endif
+#if defined(HAVE_ZSTD)
+#include <zstd.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+#include <malloc.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Last, its min() and max() macros break the standard headers
+#if defined(OLED)
+#include "ArduiPi_OLED_lib.h"
+#include "Adafruit_GFX.h"
+#include "ArduiPi_OLED.h"
+#endif
+
+const uint64_t NS_PER_SECOND = 1000000000ULL;
+
+static uint64_t now()
+{
+	struct timespec ts;
+	::clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return uint64_t(ts.tv_sec) * NS_PER_SECOND + ts.tv_nsec;
+}
+
+// One result, printed as {"name":"decode.valid","ops":1000000,"ns_per_op":12.3}
+class CBenchResult {
+public:
+	CBenchResult(const char* name) :
+	m_text()
+	{
+		add("name", name);
+	}
+
+	CBenchResult& add(const char* key, const char* value)
+	{
+		addKey(key);
+
+		m_text += '"';
+		for (const char* p = value; *p != '\0'; p++) {
+			if (*p == '"' || *p == '\\')
+				m_text += '\\';
+			if ((unsigned char)*p >= 0x20U)
+				m_text += *p;
+		}
+		m_text += '"';
+
+		return *this;
+	}
+
+	CBenchResult& add(const char* key, unsigned long long value)
+	{
+		char text[32U];
+		::snprintf(text, sizeof(text), "%llu", value);
+
+		addKey(key);
+		m_text += text;
+
+		return *this;
+	}
+
+	CBenchResult& add(const char* key, double value)
+	{
+		char text[32U];
+		::snprintf(text, sizeof(text), "%.4g", value);
+
+		addKey(key);
+		m_text += text;
+
+		return *this;
+	}
+
+	void print()
+	{
+		::fprintf(stdout, "{%s}\n", m_text.c_str());
+		::fflush(stdout);
+	}
+
+private:
+	std::string m_text;
+
+	void addKey(const char* key)
+	{
+		if (!m_text.empty())
+			m_text += ',';
+
+		m_text += '"';
+		m_text += key;
+		m_text += "\":";
+	}
+};
+
+// Plays the LCDd server for CLCDproc on a loopback port, announcing a 20x4
+// display and then reading whatever is sent
+class CMockLCDd : public CThread {
+public:
+	CMockLCDd() :
+	m_listenFd(-1),
+	m_fd(-1),
+	m_port(0U),
+	m_bytes(0ULL)
+	{
+	}
+
+	virtual ~CMockLCDd()
+	{
+		if (m_listenFd != -1)
+			::close(m_listenFd);
+	}
+
+	bool open()
+	{
+		m_listenFd = ::socket(AF_INET, SOCK_STREAM, 0);
+		if (m_listenFd == -1)
+			return false;
+
+		struct sockaddr_in addr;
+		::memset(&addr, 0, sizeof(addr));
+		addr.sin_family      = AF_INET;
+		addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		addr.sin_port        = 0U;
+
+		socklen_t length = sizeof(addr);
+		if (::bind(m_listenFd, (struct sockaddr*)&addr, sizeof(addr)) == -1 ||
+		    ::listen(m_listenFd, 1) == -1 ||
+		    ::getsockname(m_listenFd, (struct sockaddr*)&addr, &length) == -1)
+			return false;
+
+		m_port = ntohs(addr.sin_port);
+
+		return run();
+	}
+
+	virtual void entry() override
+	{
+		m_fd = ::accept(m_listenFd, NULL, NULL);
+		if (m_fd == -1)
+			return;
+
+		static const char CONNECT[] = "connect LCDproc 0.5.9 protocol 0.3 lcd wid 20 hgt 4 cellwid 5 cellhgt 8\n";
+		if (::send(m_fd, CONNECT, ::strlen(CONNECT), 0) == -1)
+			return;
+
+		char buffer[4096U];
+		ssize_t n;
+		while ((n = ::recv(m_fd, buffer, sizeof(buffer), 0)) > 0)
+			m_bytes.fetch_add((unsigned long long)n, std::memory_order_relaxed);
+
+		::close(m_fd);
+	}
+
+	// CLCDproc never closes its socket, the connection is ended from here
+	void stop()
+	{
+		if (m_fd != -1)
+			::shutdown(m_fd, SHUT_RDWR);
+
+		wait();
+	}
+
+	unsigned short getPort() const
+	{
+		return m_port;
+	}
+
+	unsigned long long getBytes() const
+	{
+		return m_bytes.load(std::memory_order_relaxed);
+	}
+
+private:
+	int                             m_listenFd;
+	int                             m_fd;
+	unsigned short                  m_port;
+	std::atomic<unsigned long long> m_bytes;
+};
+
+// Looks up IDs while the table is reloaded under it, counting the misses
+class CBenchReader : public CThread {
+public:
+	CBenchReader(CUserDB& userDB, const std::vector<uint32_t>& ids) :
+	m_userDB(userDB),
+	m_ids(ids),
+	m_stop(false),
+	m_lookups(0ULL),
+	m_misses(0ULL),
+	m_maxTime(0ULL)
+	{
+	}
+
+	virtual void entry() override
+	{
+		CUserDBentry entry;
+
+		for (unsigned int n = 0U; !m_stop.load(std::memory_order_relaxed); n++) {
+			uint64_t start = now();
+			bool found = m_userDB.lookup(m_ids[n % m_ids.size()], &entry);
+			uint64_t time = now() - start;
+
+			m_lookups++;
+			if (!found)
+				m_misses++;
+			if (time > m_maxTime)
+				m_maxTime = time;
+		}
+	}
+
+	void stop()
+	{
+		m_stop.store(true, std::memory_order_relaxed);
+		wait();
+	}
+
+	unsigned long long getLookups() const { return m_lookups; }
+	unsigned long long getMisses() const  { return m_misses; }
+	unsigned long long getMaxTime() const { return m_maxTime; }
+
+private:
+	CUserDB&                     m_userDB;
+	const std::vector<uint32_t>& m_ids;
+	std::atomic<bool>            m_stop;
+	unsigned long long           m_lookups;
+	unsigned long long           m_misses;
+	unsigned long long           m_maxTime;
+};
+
+// The user database as it was before CUserDBTable, kept to compare against:
+// a hash map of entries, each a hash map of column name to value, loaded
+// with fgets() and strpbrk() and copied out whole by a lookup
+class CLegacyUserDB {
+public:
+	typedef std::unordered_map<std::string, std::string> Entry;
+
+	bool load(const std::string& filename)
+	{
+		FILE* fp = ::fopen(filename.c_str(), "r");
+		if (fp == NULL)
+			return false;
+
+		m_table.clear();
+
+		char buffer[256U];
+		if (::fgets(buffer, sizeof(buffer), fp) == NULL) {
+			::fclose(fp);
+			return false;
+		}
+
+		std::unordered_map<std::string, int> index;
+		if (!makeindex(buffer, index)) {
+			::strncpy(buffer, keyRADIO_ID "," keyCALLSIGN "," keyFIRST_NAME, sizeof(buffer));
+			makeindex(buffer, index);
+			::rewind(fp);
+		}
+
+		while (::fgets(buffer, sizeof(buffer), fp) != NULL) {
+			if (buffer[0U] != '#')
+				parse(buffer, index);
+		}
+
+		::fclose(fp);
+
+		return !m_table.empty();
+	}
+
+	bool lookup(unsigned int id, Entry* entry) const
+	{
+		std::unordered_map<unsigned int, Entry>::const_iterator it = m_table.find(id);
+		if (it == m_table.end())
+			return false;
+
+		*entry = it->second;
+		return true;
+	}
+
+	size_t size() const
+	{
+		return m_table.size();
+	}
+
+private:
+	std::unordered_map<unsigned int, Entry> m_table;
+
+	bool makeindex(char* buf, std::unordered_map<std::string, int>& index)
+	{
+		index.clear();
+
+		char* next;
+		int i = 0;
+		for (char* p = tokenize(buf, &next); p != NULL; p = tokenize(next, &next), i++) {
+			if (CUserDBentry::getField(p) >= 0 || ::strcmp(p, keyRADIO_ID) == 0)
+				index[p] = i;
+		}
+
+		return index.count(keyRADIO_ID) > 0U && index.count(keyCALLSIGN) > 0U;
+	}
+
+	void parse(char* buf, const std::unordered_map<std::string, int>& index)
+	{
+		std::unordered_map<std::string, char*> ptr;
+
+		char* next;
+		int i = 0;
+		for (char* p = tokenize(buf, &next); p != NULL; p = tokenize(next, &next), i++) {
+			for (std::unordered_map<std::string, int>::const_iterator it = index.begin(); it != index.end(); ++it) {
+				if (it->second == i) {
+					ptr[it->first] = p;
+					break;
+				}
+			}
+		}
+
+		if (ptr.count(keyRADIO_ID) == 0U || ptr.count(keyCALLSIGN) == 0U)
+			return;
+
+		unsigned int id = (unsigned int)::atoi(ptr[keyRADIO_ID]);
+		for (char* p = ptr[keyCALLSIGN]; *p != '\0'; p++)
+			*p = ::toupper(*p);
+
+		for (std::unordered_map<std::string, char*>::const_iterator it = ptr.begin(); it != ptr.end(); ++it) {
+			if (it->first != keyRADIO_ID)
+				m_table[id][it->first] = it->second;
+		}
+	}
+
+	static char* tokenize(char* str, char** next)
+	{
+		if (*str == '\0')
+			return NULL;
+
+		char* p = ::strpbrk(str, ",\t\r\n");
+		if (p == NULL) {
+			*next = str + ::strlen(str);
+		} else {
+			*p = '\0';
+			*next = p + 1;
+		}
+
+		return str;
+	}
+};
+
+// Bytes of heap in use, every thread's arenas
+static size_t getHeapUsed()
+{
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+	struct mallinfo2 info = ::mallinfo2();
+	return info.uordblks + info.hblkhd;
+#else
+	return 0U;
+#endif
+}
+
+class CBench {
+public:
+	CBench() :
+	m_minTime(200000000ULL),
+	m_rows(250000U),
+	m_idsFile(),
+	m_dir(),
+	m_csvFile(),
+	m_files(),
+	m_ids(),
+	m_missIds(),
+	m_random(1U)
+	{
+	}
+
+	~CBench()
+	{
+		for (std::vector<std::string>::const_iterator it = m_files.begin(); it != m_files.end(); ++it)
+			::unlink(it->c_str());
+
+		if (!m_dir.empty())
+			::rmdir(m_dir.c_str());
+	}
+
+	void setTime(unsigned int ms)
+	{
+		m_minTime = ms * 1000000ULL;
+	}
+
+	void setRows(unsigned int rows)
+	{
+		m_rows = rows;
+	}
+
+	void setIds(const std::string& filename)
+	{
+		m_idsFile = filename;
+	}
+
+	bool open();
+
+	void runDecode();
+	void runLoad();
+	void runLookup();
+	void runLegacy();
+	void runReload();
+	void runAlloc();
+	void runNextion();
+	void runSurenoo();
+	void runLCDproc();
+	void runSerial();
+#if defined(OLED)
+	void runOLED();
+#endif
+
+	static void makeValid(std::vector<std::string>& packets);
+	static void makeCorpus(std::vector<std::string>& corpus);
+
+private:
+	uint64_t                 m_minTime;
+	unsigned int             m_rows;
+	std::string              m_idsFile;
+	std::string              m_dir;
+	std::string              m_csvFile;
+	std::vector<std::string> m_files;		// removed at the end
+	std::vector<uint32_t>    m_ids;			// in the table, shuffled
+	std::vector<uint32_t>    m_missIds;		// not in the table
+	std::mt19937             m_random;
+
+	std::string addFile(const char* name);
+	bool writeCSV(const std::string& filename);
+	bool writeJSON(const std::string& filename);
+	bool readIds(const std::string& filename);
+	void makeMissIds();
+
+	// Calls fn(n) with a growing n until it takes m_minTime, returns ns per op
+	template <typename F> double measure(F fn, unsigned long long& ops)
+	{
+		for (unsigned long long n = 1ULL; ; n *= 4ULL) {
+			uint64_t start = now();
+			fn(n);
+			uint64_t time = now() - start;
+
+			if (time >= m_minTime || n >= (1ULL << 40)) {
+				ops = n;
+				return double(time) / double(n);
+			}
+		}
+	}
+
+	// Repeats fn, at least three times and for m_minTime, for the best and mean ms
+	template <typename F> unsigned int repeat(F fn, double& best, double& mean)
+	{
+		uint64_t total = 0ULL;
+		uint64_t min   = UINT64_MAX;
+
+		unsigned int runs;
+		for (runs = 0U; runs < 3U || total < m_minTime; runs++) {
+			uint64_t start = now();
+			fn();
+			uint64_t time = now() - start;
+
+			total += time;
+			min = (std::min)(min, time);
+		}
+
+		best = double(min) / 1000000.0;
+		mean = double(total) / double(runs) / 1000000.0;
+
+		return runs;
+	}
+
+	static off_t getSize(const std::string& filename)
+	{
+		struct stat st;
+		return ::stat(filename.c_str(), &st) == 0 ? st.st_size : 0;
+	}
+
+	// One DMR call as the server shows it, clock() is what redraws the Surenoo
+	static void showCall(CDisplay& display, const CUserDBentry& entry, unsigned int slotNo)
+	{
+		unsigned char alias[] = "DL1ABC Hans";
+
+		display.writeDMR(slotNo, entry, true, "91 Worldwide", "R");
+		display.writeDMRTA(slotNo, alias, "R");
+		display.writeDMRRSSI(slotNo, 80U);
+		display.writeDMRBER(slotNo, 1.5F);
+		display.clock(3000U);
+		display.clearDMR(slotNo);
+		display.clock(3000U);
+	}
+
+	static void setEntry(CUserDBentry& entry)
+	{
+		entry.set(UDF_CALLSIGN, "DL1ABC");
+		entry.set(UDF_FIRST_NAME, "Hans");
+		entry.set(UDF_LAST_NAME, "Mustermann");
+		entry.set(UDF_CITY, "Berlin");
+		entry.set(UDF_STATE, "Berlin");
+		entry.set(UDF_COUNTRY, "Germany");
+		entry.format();
+	}
+};
+
+std::string CBench::addFile(const char* name)
+{
+	std::string filename = m_dir + "/" + name;
+	m_files.push_back(filename);
+
+	return filename;
+}
+
+bool CBench::open()
+{
+	char dir[] = "/tmp/DisplayServer-bench.XXXXXX";
+	if (::mkdtemp(dir) == NULL) {
+		::fprintf(stderr, "Cannot create a temporary directory: %s\n", ::strerror(errno));
+		return false;
+	}
+
+	m_dir = dir;
+
+	if (!m_idsFile.empty()) {
+		m_csvFile = m_idsFile;
+		return readIds(m_idsFile);
+	}
+
+	// Distinct 7 digit IDs a few apart, in no particular order like the real file
+	m_ids.reserve(m_rows);
+	for (unsigned int i = 0U; i < m_rows; i++)
+		m_ids.push_back(1000000U + i * 32U + m_random() % 32U);
+	std::shuffle(m_ids.begin(), m_ids.end(), m_random);
+
+	m_csvFile = addFile("DMRIds.dat");
+	if (!writeCSV(m_csvFile))
+		return false;
+
+	makeMissIds();
+
+	return true;
+}
+
+bool CBench::writeCSV(const std::string& filename)
+{
+	FILE* fp = ::fopen(filename.c_str(), "w");
+	if (fp == NULL) {
+		::fprintf(stderr, "Cannot create %s: %s\n", filename.c_str(), ::strerror(errno));
+		return false;
+	}
+
+	static const char* COUNTRIES[] = {"Germany", "United Kingdom", "United States", "France", "Italy", "Netherlands", "Australia"};
+
+	::fprintf(fp, "RADIO_ID,CALLSIGN,FIRST_NAME,LAST_NAME,CITY,STATE,COUNTRY\n");
+	for (std::vector<uint32_t>::const_iterator it = m_ids.begin(); it != m_ids.end(); ++it) {
+		uint32_t id = *it;
+		::fprintf(fp, "%u,DL%u%c%c%c,Name%u,Surname%u,City %u,State %u,%s\n", id, id % 10U,
+			'A' + id % 26U, 'A' + id / 26U % 26U, 'A' + id / 676U % 26U,
+			id % 5000U, id % 20000U, id % 9000U, id % 50U, COUNTRIES[id % 7U]);
+	}
+
+	return ::fclose(fp) == 0;
+}
+
+bool CBench::writeJSON(const std::string& filename)
+{
+	FILE* fp = ::fopen(filename.c_str(), "w");
+	if (fp == NULL)
+		return false;
+
+	// The radioid.net dump, with its one key per line
+	::fprintf(fp, "{\n \"users\": [\n");
+	for (std::vector<uint32_t>::const_iterator it = m_ids.begin(); it != m_ids.end(); ++it) {
+		uint32_t id = *it;
+		::fprintf(fp, "  {\n   \"id\": %u,\n   \"callsign\": \"DL%u%c%c%c\",\n   \"fname\": \"Name%u\",\n   \"surname\": \"Surname%u\",\n"
+			"   \"city\": \"City %u\",\n   \"state\": \"State %u\",\n   \"country\": \"Germany\"\n  }%s\n", id, id % 10U,
+			'A' + id % 26U, 'A' + id / 26U % 26U, 'A' + id / 676U % 26U,
+			id % 5000U, id % 20000U, id % 9000U, id % 50U, it + 1 != m_ids.end() ? "," : "");
+	}
+	::fprintf(fp, " ]\n}\n");
+
+	return ::fclose(fp) == 0;
+}
+
+bool CBench::readIds(const std::string& filename)
+{
+	FILE* fp = ::fopen(filename.c_str(), "r");
+	if (fp == NULL) {
+		::fprintf(stderr, "Cannot open %s: %s\n", filename.c_str(), ::strerror(errno));
+		return false;
+	}
+
+	// The first column of a CSV, the header has no leading digit
+	char line[512U];
+	while (::fgets(line, sizeof(line), fp) != NULL) {
+		if (line[0U] >= '0' && line[0U] <= '9')
+			m_ids.push_back(uint32_t(::strtoul(line, NULL, 10)));
+	}
+
+	::fclose(fp);
+
+	if (m_ids.empty()) {
+		::fprintf(stderr, "No IDs found in %s, only a CSV file can be given\n", filename.c_str());
+		return false;
+	}
+
+	m_rows = m_ids.size();
+	std::shuffle(m_ids.begin(), m_ids.end(), m_random);
+
+	makeMissIds();
+
+	return true;
+}
+
+void CBench::makeMissIds()
+{
+	std::vector<uint32_t> sorted(m_ids);
+	std::sort(sorted.begin(), sorted.end());
+
+	while (m_missIds.size() < 65536U) {
+		uint32_t id = 1000000U + m_random() % 9000000U;
+		if (!std::binary_search(sorted.begin(), sorted.end(), id))
+			m_missIds.push_back(id);
+	}
+}
+
+// One of each update, as v1 datagrams
+void CBench::makeValid(std::vector<std::string>& packets)
+{
+	unsigned char buffer[DISPLAY_FRAME_MAX_LENGTH];
+	CDisplayEncoder encoder(buffer, sizeof(buffer));
+
+	for (unsigned int i = 0U; i < 10U; i++) {
+		encoder.begin();
+
+		switch (i) {
+		case 0U: encoder.writeDMR(1U, 2621234U, true, 91U, 'R'); break;
+		case 1U: encoder.writeDMRRSSI(1U, 87U); break;
+		case 2U: encoder.writeDMRBER(1U, 1.5F); break;
+		case 3U: encoder.writeDMRTA(1U, 'R', "DL1ABC Hans"); break;
+		case 4U: encoder.clearDMR(1U); break;
+		case 5U: encoder.writeDMR(2U, 3100001U, false, 2621234U, 'N'); break;
+		case 6U: encoder.writePOCSAG(224U, "YYYYMMDDHHMMSS260101120000"); break;
+		case 7U: encoder.clearPOCSAG(); break;
+		case 8U: encoder.setError("Modem not responding"); break;
+		default: encoder.setIdle(); break;
+		}
+
+		// A frame of one update holds the v1 datagram after the header and the length byte
+		unsigned int length = encoder.end();
+		packets.push_back(std::string((const char*)buffer + DISPLAY_FRAME_HEADER_LENGTH + 1U, length - DISPLAY_FRAME_HEADER_LENGTH - 1U));
+	}
+}
+
+// Every truncation of each valid update, every opcode with short and long
+// tails, text counts past the end, bad slots and frames that don't add up
+void CBench::makeCorpus(std::vector<std::string>& corpus)
+{
+	std::vector<std::string> valid;
+	makeValid(valid);
+
+	for (std::vector<std::string>::const_iterator it = valid.begin(); it != valid.end(); ++it) {
+		for (unsigned int length = 0U; length < it->size(); length++)
+			corpus.push_back(it->substr(0U, length));
+
+		// The text count one past the bytes there are
+		if (it->at(0U) == char(DISPLAY_DMR_TA) || it->at(0U) == char(DISPLAY_POCSAG) || it->at(0U) == char(DISPLAY_ERROR)) {
+			std::string packet = *it;
+			unsigned int offset = packet[0U] == char(DISPLAY_DMR_TA) ? 3U : packet[0U] == char(DISPLAY_POCSAG) ? 5U : 1U;
+			packet[offset] = char((unsigned char)packet[offset] + 1U);
+			corpus.push_back(packet);
+			packet[offset] = char(0xFFU);
+			corpus.push_back(packet);
+		}
+	}
+
+	std::mt19937 random(5U);
+	for (unsigned int opcode = 0U; opcode < 256U; opcode++) {
+		for (unsigned int length = 1U; length <= 16U; length *= 2U) {
+			std::string packet(1U, char(opcode));
+			for (unsigned int i = 1U; i < length; i++)
+				packet += char(random() & 0xFFU);
+			corpus.push_back(packet);
+		}
+	}
+
+	static const unsigned char SLOTS[] = {0U, 3U, 0xFFU};
+	for (unsigned int i = 0U; i < 3U; i++) {
+		const unsigned char RSSI[]  = {DISPLAY_DMR_RSSI, SLOTS[i], 80U};
+		const unsigned char CLEAR[] = {DISPLAY_DMR_CLEAR, SLOTS[i]};
+		corpus.push_back(std::string((const char*)RSSI, sizeof(RSSI)));
+		corpus.push_back(std::string((const char*)CLEAR, sizeof(CLEAR)));
+	}
+
+	// Counts and lengths running past the end, an update of length 0, another version
+	static const unsigned char FRAMES[][9U] = {
+		{DISPLAY_FRAME, DISPLAY_FRAME_VERSION, 0U, 1U, 255U, 3U, DISPLAY_DMR_RSSI, 1U, 80U},
+		{DISPLAY_FRAME, DISPLAY_FRAME_VERSION, 0U, 2U, 1U, 200U, DISPLAY_DMR_RSSI, 1U, 80U},
+		{DISPLAY_FRAME, DISPLAY_FRAME_VERSION, 0U, 3U, 2U, 0U, 1U, DISPLAY_IDLE, 0U},
+		{DISPLAY_FRAME, DISPLAY_FRAME_VERSION + 1U, 0U, 4U, 1U, 1U, DISPLAY_IDLE, 0U, 0U},
+		{DISPLAY_FRAME, DISPLAY_FRAME_VERSION, 0U, 5U, 1U, 3U, DISPLAY_DMR_RSSI, 7U, 80U}
+	};
+	for (unsigned int i = 0U; i < sizeof(FRAMES) / sizeof(FRAMES[0U]); i++) {
+		for (unsigned int length = 1U; length <= sizeof(FRAMES[0U]); length++)
+			corpus.push_back(std::string((const char*)FRAMES[i], length));
+	}
+}
+
+void CBench::runDecode()
+{
+	CDisplayDecoder decoder;
+	CDisplayMessage message;
+
+	std::vector<std::string> valid;
+	makeValid(valid);
+
+	unsigned long long rejected = 0ULL;
+	unsigned long long ops;
+	double ns = measure([&](unsigned long long n) {
+		for (unsigned long long i = 0ULL; i < n; i++) {
+			const std::string& packet = valid[i % valid.size()];
+			if (!decoder.decode((const unsigned char*)packet.data(), packet.size(), message))
+				rejected++;
+		}
+	}, ops);
+
+	CBenchResult("decode.valid").add("ops", ops).add("ns_per_op", ns).add("rejected", rejected).print();
+
+	// A full frame of the same updates
+	unsigned char buffer[DISPLAY_FRAME_MAX_LENGTH];
+	CDisplayEncoder encoder(buffer, sizeof(buffer));
+	encoder.begin();
+	for (unsigned int i = 0U; encoder.writeDMRBER(1U + i % 2U, 0.1F * i) && encoder.writeDMRRSSI(1U + i % 2U, 80U + i % 20U); i++)
+		;
+	unsigned int length  = encoder.end();
+	unsigned int updates = encoder.getCount();
+
+	ns = measure([&](unsigned long long n) {
+		CDisplayFrame frame;
+		for (unsigned long long i = 0ULL; i < n; i++) {
+			if (!decoder.decodeFrame(buffer, length, frame)) {
+				rejected++;
+				continue;
+			}
+
+			const unsigned char* data;
+			unsigned int size;
+			while (frame.next(data, size)) {
+				if (!decoder.decode(data, size, message))
+					rejected++;
+			}
+		}
+	}, ops);
+
+	CBenchResult("decode.frame").add("ops", ops).add("updates", (unsigned long long)updates).add("ns_per_update", ns / updates).add("rejected", rejected).print();
+
+	std::vector<std::string> corpus;
+	makeCorpus(corpus);
+
+	// Every datagram is decoded in full, frames included, as the server would
+	unsigned long long accepted = 0ULL;
+	rejected = 0ULL;
+	ns = measure([&](unsigned long long n) {
+		CDisplayFrame frame;
+		for (unsigned long long i = 0ULL; i < n; i++) {
+			const std::string& packet = corpus[i % corpus.size()];
+			const unsigned char* data = (const unsigned char*)packet.data();
+
+			bool ok;
+			if (!packet.empty() && data[0U] == DISPLAY_FRAME) {
+				ok = decoder.decodeFrame(data, packet.size(), frame);
+
+				const unsigned char* update;
+				unsigned int size;
+				while (ok && frame.next(update, size))
+					ok = decoder.decode(update, size, message);
+			} else {
+				ok = decoder.decode(data, packet.size(), message);
+			}
+
+			if (ok)
+				accepted++;
+			else
+				rejected++;
+		}
+	}, ops);
+
+	CBenchResult("decode.malformed").add("ops", ops).add("ns_per_op", ns).add("corpus", (unsigned long long)corpus.size())
+		.add("accepted", accepted).add("rejected", rejected).print();
+}
+
+void CBench::runLoad()
+{
+	off_t size = getSize(m_csvFile);
+
+	double best, mean;
+	unsigned int runs;
+
+	// The delimiter scan alone, as built for this target and as the scalar
+	// loop, over the file in memory
+	{
+		std::string text;
+		FILE* fp = ::fopen(m_csvFile.c_str(), "rb");
+		if (fp != NULL) {
+			char buffer[65536U];
+			size_t n;
+			while ((n = ::fread(buffer, 1U, sizeof(buffer), fp)) > 0U)
+				text.append(buffer, n);
+			::fclose(fp);
+		}
+
+		const char* begin = text.data();
+		const char* end   = begin + text.size();
+
+		for (unsigned int scalar = 0U; scalar < 2U; scalar++) {
+			unsigned long long delimiters = 0ULL;
+
+			runs = repeat([&]() {
+				delimiters = 0ULL;
+				for (const char* p = begin; p < end; p++) {
+					p = scalar == 1U ? CUserDBParser::findDelimiterScalar(p, end) : CUserDBParser::findDelimiter(p, end);
+					delimiters++;
+				}
+			}, best, mean);
+
+			CBenchResult("load.scan").add("scanner", scalar == 1U ? "scalar" : CUserDBParser::getScanner())
+				.add("runs", (unsigned long long)runs).add("ms", best).add("mb_per_s", double(text.size()) / 1000.0 / best)
+				.add("delimiters", delimiters).print();
+		}
+	}
+
+	static const unsigned int THREADS[] = {1U, 2U, 4U};
+	for (unsigned int i = 0U; i < sizeof(THREADS) / sizeof(THREADS[0U]); i++) {
+		size_t memory = 0U;
+		unsigned int entries = 0U;
+
+		runs = repeat([&]() {
+			CUserDB userDB(THREADS[i]);
+			userDB.load(m_csvFile);
+			memory  = userDB.getMemory();
+			entries = userDB.getSize();
+		}, best, mean);
+
+		CBenchResult("load.csv").add("threads", (unsigned long long)THREADS[i]).add("runs", (unsigned long long)runs)
+			.add("ms", best).add("mean_ms", mean).add("mb_per_s", double(size) / 1000.0 / best)
+			.add("entries", (unsigned long long)entries).add("bytes", (unsigned long long)memory)
+			.add("bytes_per_entry", entries > 0U ? double(memory) / entries : 0.0).print();
+	}
+
+	// A reload of an unchanged file, into a table that is in use
+	{
+		CUserDB userDB;
+		userDB.load(m_csvFile);
+
+		runs = repeat([&]() { userDB.load(m_csvFile); }, best, mean);
+
+		CBenchResult("load.reload").add("runs", (unsigned long long)runs).add("ms", best).add("mean_ms", mean).print();
+	}
+
+	{
+		size_t memory = 0U;
+
+		runs = repeat([&]() {
+			CUserDB userDB;
+			userDB.setLazy(true);
+			userDB.load(m_csvFile);
+			memory = userDB.getMemory();
+		}, best, mean);
+
+		CBenchResult("load.lazy").add("runs", (unsigned long long)runs).add("ms", best).add("mean_ms", mean)
+			.add("bytes", (unsigned long long)memory).add("bytes_per_entry", double(memory) / m_rows).print();
+	}
+
+	std::string compiled = addFile("DMRIds.bin");
+	{
+		CUserDB userDB;
+		if (userDB.load(m_csvFile) && userDB.save(compiled)) {
+			runs = repeat([&]() {
+				CUserDB userDB;
+				userDB.load(compiled);
+			}, best, mean);
+
+			CBenchResult("load.compiled").add("runs", (unsigned long long)runs).add("ms", best).add("mean_ms", mean)
+				.add("file_bytes", (unsigned long long)getSize(compiled)).print();
+		}
+	}
+
+	// The other formats are only made from the synthetic IDs
+	if (!m_idsFile.empty())
+		return;
+
+	std::string json = addFile("users.json");
+	if (writeJSON(json)) {
+		runs = repeat([&]() {
+			CUserDB userDB;
+			userDB.load(json);
+		}, best, mean);
+
+		CBenchResult("load.json").add("runs", (unsigned long long)runs).add("ms", best).add("mean_ms", mean)
+			.add("mb_per_s", double(getSize(json)) / 1000.0 / best).print();
+	}
+
+#if defined(HAVE_ZLIB)
+	std::string gz = addFile("DMRIds.dat.gz");
+	gzFile out = ::gzopen(gz.c_str(), "wb6");
+	if (out != NULL) {
+		FILE* in = ::fopen(m_csvFile.c_str(), "r");
+		if (in != NULL) {
+			char buffer[65536U];
+			size_t n;
+			while ((n = ::fread(buffer, 1U, sizeof(buffer), in)) > 0U)
+				::gzwrite(out, buffer, (unsigned int)n);
+			::fclose(in);
+		}
+		::gzclose(out);
+
+		runs = repeat([&]() {
+			CUserDB userDB;
+			userDB.load(gz);
+		}, best, mean);
+
+		CBenchResult("load.csv_gz").add("runs", (unsigned long long)runs).add("ms", best).add("mean_ms", mean)
+			.add("file_bytes", (unsigned long long)getSize(gz)).print();
+	}
+#endif
+
+#if defined(HAVE_ZSTD)
+	std::string zst = addFile("DMRIds.dat.zst");
+	FILE* csv = ::fopen(m_csvFile.c_str(), "r");
+	FILE* file = ::fopen(zst.c_str(), "wb");
+	ZSTD_CCtx* ctx = ::ZSTD_createCCtx();
+	if (csv != NULL && file != NULL && ctx != NULL) {
+		::ZSTD_CCtx_setParameter(ctx, ZSTD_c_compressionLevel, 3);
+		::ZSTD_CCtx_setParameter(ctx, ZSTD_c_checksumFlag, 1);
+
+		std::vector<char> input(::ZSTD_CStreamInSize());
+		std::vector<char> output(::ZSTD_CStreamOutSize());
+
+		bool ok = true;
+		bool eof = false;
+		while (ok && !eof) {
+			size_t n = ::fread(input.data(), 1U, input.size(), csv);
+			eof = n < input.size();
+
+			ZSTD_inBuffer inBuffer = { input.data(), n, 0U };
+			size_t left;
+			do {
+				ZSTD_outBuffer outBuffer = { output.data(), output.size(), 0U };
+				left = ::ZSTD_compressStream2(ctx, &outBuffer, &inBuffer, eof ? ZSTD_e_end : ZSTD_e_continue);
+				ok = !::ZSTD_isError(left) && ::fwrite(output.data(), 1U, outBuffer.pos, file) == outBuffer.pos;
+			} while (ok && (eof ? left != 0U : inBuffer.pos < inBuffer.size));
+		}
+
+		::fclose(file);
+		file = NULL;
+
+		if (ok) {
+			runs = repeat([&]() {
+				CUserDB userDB;
+				userDB.load(zst);
+			}, best, mean);
+
+			CBenchResult("load.csv_zst").add("runs", (unsigned long long)runs).add("ms", best).add("mean_ms", mean)
+				.add("file_bytes", (unsigned long long)getSize(zst)).print();
+		}
+	}
+
+	if (csv != NULL)
+		::fclose(csv);
+	if (file != NULL)
+		::fclose(file);
+	::ZSTD_freeCCtx(ctx);
+#endif
+}
+
+void CBench::runLookup()
+{
+	CUserDB userDB;
+	userDB.load(m_csvFile);
+
+	CUserDBentry entry;
+	unsigned long long misses = 0ULL;
+	unsigned long long ops;
+
+	double ns = measure([&](unsigned long long n) {
+		for (unsigned long long i = 0ULL; i < n; i++) {
+			if (!userDB.lookup(m_ids[i % m_ids.size()], &entry))
+				misses++;
+		}
+	}, ops);
+
+	CBenchResult("lookup.table_hit").add("ops", ops).add("ns_per_op", ns).add("misses", misses).print();
+
+	unsigned long long hits = 0ULL;
+	ns = measure([&](unsigned long long n) {
+		for (unsigned long long i = 0ULL; i < n; i++) {
+			if (userDB.lookup(m_missIds[i % m_missIds.size()], &entry))
+				hits++;
+		}
+	}, ops);
+
+	CBenchResult("lookup.table_miss").add("ops", ops).add("ns_per_op", ns).add("hits", hits).print();
+
+	// Through CDMRLookup and its cache, as the server looks IDs up
+	for (unsigned int lazy = 0U; lazy < 2U; lazy++) {
+		CDMRLookup* lookup = new CDMRLookup(m_csvFile, 0U);
+		lookup->setLazy(lazy == 1U);
+		lookup->read();
+
+		const char* suffix = lazy == 1U ? "_lazy" : "";
+		std::string name;
+
+		// The first sight of each ID, a lazy table parses its line then
+		uint64_t start = now();
+		unsigned int first = (std::min)(m_ids.size(), size_t(65536U));
+		for (unsigned int i = 0U; i < first; i++)
+			lookup->find(m_ids[i]);
+		double firstNs = double(now() - start) / first;
+
+		name = std::string("lookup.find_first") + suffix;
+		CBenchResult(name.c_str()).add("ops", (unsigned long long)first).add("ns_per_op", firstNs).print();
+
+		unsigned long long cacheHits = lookup->getCacheHits();
+		ns = measure([&](unsigned long long n) {
+			for (unsigned long long i = 0ULL; i < n; i++)
+				lookup->find(m_ids[i % m_ids.size()]);
+		}, ops);
+
+		name = std::string("lookup.find_hit") + suffix;
+		CBenchResult(name.c_str()).add("ops", ops).add("ns_per_op", ns)
+			.add("cache_hit_ratio", double(lookup->getCacheHits() - cacheHits) / ops).print();
+
+		// A handful of IDs, as on the air, served from the cache
+		ns = measure([&](unsigned long long n) {
+			for (unsigned long long i = 0ULL; i < n; i++)
+				lookup->find(m_ids[i % 8U]);
+		}, ops);
+
+		name = std::string("lookup.find_cached") + suffix;
+		CBenchResult(name.c_str()).add("ops", ops).add("ns_per_op", ns).print();
+
+		ns = measure([&](unsigned long long n) {
+			for (unsigned long long i = 0ULL; i < n; i++)
+				lookup->find(m_missIds[i % m_missIds.size()]);
+		}, ops);
+
+		name = std::string("lookup.find_miss") + suffix;
+		CBenchResult(name.c_str()).add("ops", ops).add("ns_per_op", ns).print();
+
+		lookup->stop();
+	}
+}
+
+// Lookups from another thread during reloads must all succeed
+// The flat table against the hash maps it replaced, on the same file
+void CBench::runLegacy()
+{
+	size_t heap = getHeapUsed();
+	uint64_t start = now();
+
+	CLegacyUserDB* legacy = new CLegacyUserDB;
+	legacy->load(m_csvFile);
+
+	double ms = double(now() - start) / 1000000.0;
+	size_t memory = getHeapUsed() - heap;
+
+	CBenchResult("legacy.load").add("ms", ms).add("entries", (unsigned long long)legacy->size())
+		.add("heap_bytes", (unsigned long long)memory).add("bytes_per_entry", double(memory) / legacy->size()).print();
+
+	CLegacyUserDB::Entry legacyEntry;
+	unsigned long long misses = 0ULL;
+	unsigned long long ops;
+	double ns = measure([&](unsigned long long n) {
+		for (unsigned long long i = 0ULL; i < n; i++) {
+			if (!legacy->lookup(m_ids[i % m_ids.size()], &legacyEntry))
+				misses++;
+		}
+	}, ops);
+
+	CBenchResult("legacy.lookup").add("ops", ops).add("ns_per_op", ns).add("misses", misses).print();
+
+	delete legacy;
+	legacyEntry.clear();
+	::malloc_trim(0U);
+
+	// The same for CUserDB, the heap counted the same way
+	heap  = getHeapUsed();
+	start = now();
+
+	CUserDB* userDB = new CUserDB;
+	userDB->load(m_csvFile);
+
+	ms = double(now() - start) / 1000000.0;
+	memory = getHeapUsed() - heap;
+
+	CBenchResult("legacy.table_load").add("ms", ms).add("entries", (unsigned long long)userDB->getSize())
+		.add("heap_bytes", (unsigned long long)memory).add("bytes_per_entry", double(memory) / userDB->getSize()).print();
+
+	CUserDBentry entry;
+	misses = 0ULL;
+	ns = measure([&](unsigned long long n) {
+		for (unsigned long long i = 0ULL; i < n; i++) {
+			if (!userDB->lookup(m_ids[i % m_ids.size()], &entry))
+				misses++;
+		}
+	}, ops);
+
+	CBenchResult("legacy.table_lookup").add("ops", ops).add("ns_per_op", ns).add("misses", misses).print();
+
+	delete userDB;
+}
+
+void CBench::runReload()
+{
+	CUserDB userDB;
+	userDB.load(m_csvFile);
+
+	CBenchReader reader(userDB, m_ids);
+	reader.run();
+
+	unsigned int reloads = 0U;
+	uint64_t start = now();
+	while (reloads < 3U || now() - start < m_minTime) {
+		userDB.load(m_csvFile);
+		reloads++;
+	}
+
+	reader.stop();
+
+	CBenchResult("reload.lookups").add("reloads", (unsigned long long)reloads).add("lookups", reader.getLookups())
+		.add("misses", reader.getMisses()).add("max_ns", reader.getMaxTime()).print();
+}
+
+// Allocations from a datagram to the entry a display is given
+void CBench::runAlloc()
+{
+	CDMRLookup* lookup = new CDMRLookup(m_csvFile, 0U);
+	lookup->read();
+
+	CDisplayDecoder decoder;
+	CDisplayMessage message;
+	CUserDBentry entry;
+
+	unsigned char packets[256U][12U];
+	for (unsigned int i = 0U; i < 256U; i++) {
+		uint32_t id = i % 2U == 0U ? m_ids[i] : m_missIds[i];
+		unsigned char packet[] = {DISPLAY_DMR, 1U, uint8_t(id >> 24), uint8_t(id >> 16), uint8_t(id >> 8), uint8_t(id), 1U, 0U, 0U, 0U, 91U, 'R'};
+		::memcpy(packets[i], packet, sizeof(packet));
+	}
+
+	unsigned long long ops;
+	unsigned long long before = getAllocations();
+	double ns = measure([&](unsigned long long n) {
+		for (unsigned long long i = 0ULL; i < n; i++) {
+			if (decoder.decode(packets[i % 256U], 12U, message)) {
+				lookup->find(message.m_srcId);
+				lookup->findUser(message.m_srcId, entry);
+			}
+		}
+	}, ops);
+	unsigned long long count = getAllocations() - before;
+
+	CBenchResult("alloc.lookup").add("ops", ops).add("ns_per_op", ns).add("allocs_per_op", double(count) / ops).print();
+
+	lookup->stop();
+}
+
+void CBench::runNextion()
+{
+	CMockSerialPort* port = new CMockSerialPort;
+
+	// ON7LDS layout, talker alias shown
+	CNextion nextion("N0CALL", 1234567U, port, 50U, false, false, 20U, 2U, 438000000U, 430000000U, false);
+	nextion.setCommandDelay(0U);
+	if (!nextion.open())
+		return;
+
+	CUserDBentry entry;
+	setEntry(entry);
+
+	unsigned long long bytes  = port->getBytes();
+	unsigned long long writes = port->getWrites();
+
+	unsigned long long ops;
+	double ns = measure([&](unsigned long long n) {
+		for (unsigned long long i = 0ULL; i < n; i++) {
+			showCall(nextion, entry, 1U + i % 2U);
+			port->clear();
+		}
+	}, ops);
+
+	// Each command is written as the text, then the three 0xFF terminator bytes
+	double perCall  = double(port->getBytes() - bytes) / ops;
+	double commands = double(port->getWrites() - writes) / 2.0 / ops;
+
+	CBenchResult("nextion.call").add("ops", ops).add("ns_per_op", ns).add("bytes_per_op", perCall).add("commands_per_op", commands)
+		.add("ms_at_9600", perCall * 10.0 / 9.6).add("ms_at_115200", perCall * 10.0 / 115.2).add("ms_paced_10", commands * 10.0).print();
+
+	nextion.close();
+}
+
+void CBench::runSurenoo()
+{
+	CMockSerialPort* port = new CMockSerialPort;
+
+	CTFTSurenoo surenoo("N0CALL", 1234567U, port, 50U, false);
+	surenoo.setCommandDelay(0U);
+	if (!surenoo.open())
+		return;
+
+	CUserDBentry entry;
+	setEntry(entry);
+
+	unsigned long long bytes = port->getBytes();
+
+	unsigned long long ops;
+	double ns = measure([&](unsigned long long n) {
+		for (unsigned long long i = 0ULL; i < n; i++) {
+			showCall(surenoo, entry, 1U + i % 2U);
+			port->clear();
+		}
+	}, ops);
+
+	double perCall = double(port->getBytes() - bytes) / ops;
+
+	CBenchResult("surenoo.call").add("ops", ops).add("ns_per_op", ns).add("bytes_per_op", perCall)
+		.add("ms_at_9600", perCall * 10.0 / 9.6).add("ms_at_115200", perCall * 10.0 / 115.2).print();
+
+	surenoo.close();
+}
+
+void CBench::runLCDproc()
+{
+	CMockLCDd lcdd;
+	if (!lcdd.open()) {
+		::fprintf(stderr, "Cannot start the mock LCDd: %s\n", ::strerror(errno));
+		return;
+	}
+
+	CLCDproc lcdproc("127.0.0.1", lcdd.getPort(), 0U, "N0CALL", 1234567U, false, false, true, false);
+	if (!lcdproc.open()) {
+		lcdd.stop();
+		return;
+	}
+
+	// The screens are defined once the connect line from LCDd has been read
+	struct pollfd fds;
+	fds.fd     = lcdproc.getFd();
+	fds.events = POLLIN;
+	if (::poll(&fds, 1, 1000) == 1)
+		lcdproc.read();
+
+	CUserDBentry entry;
+	setEntry(entry);
+
+	unsigned long long bytes = lcdproc.getWritten();
+
+	unsigned long long ops;
+	double ns = measure([&](unsigned long long n) {
+		for (unsigned long long i = 0ULL; i < n; i++)
+			showCall(lcdproc, entry, 1U + i % 2U);
+	}, ops);
+
+	CBenchResult("lcdproc.call").add("ops", ops).add("ns_per_op", ns)
+		.add("bytes_per_op", double(lcdproc.getWritten() - bytes) / ops).print();
+
+	lcdproc.close();
+	lcdd.stop();
+}
+
+// A few calls each, every one taking up to a third of a second at 9600 baud
+const unsigned int SERIAL_CALLS = 4U;
+
+// How long a screen update takes over a serial link, from the first byte
+// written to the last one on the wire, and what pacing does to it
+void CBench::runSerial()
+{
+	static const struct {
+		const char*  m_name;
+		bool         m_delay;		// the driver's own pause after commands
+		unsigned int m_fifoSize;
+		unsigned int m_latency;		// us per write
+	} PACINGS[] = {
+		{"delay", true,  4096U, 0U},		// as shipped, into the tty buffer
+		{"none",  false, 4096U, 0U},		// left to the tty buffer
+		{"uart",  false, 16U,   0U},		// a 16550 FIFO and nothing else
+		{"usb",   false, 4096U, 1000U}		// a USB adapter's 1 ms frames
+	};
+
+	static const unsigned int BAUDS[] = {9600U, 115200U};
+
+	CUserDBentry entry;
+	setEntry(entry);
+
+	// With maxWrite set, the bytes short writes left out, which nobody retries
+	for (unsigned int run = 0U; run < 2U * 2U * (sizeof(PACINGS) / sizeof(PACINGS[0U]) + 1U); run++) {
+		unsigned int driver = run % 2U;
+		unsigned int baud   = BAUDS[run / 2U % 2U];
+		unsigned int pacing = run / 4U;
+		bool partial        = pacing == sizeof(PACINGS) / sizeof(PACINGS[0U]);
+		if (partial)
+			pacing = 1U;
+
+		CMockSerialPort* port = new CMockSerialPort;
+
+		CDisplay* display;
+		if (driver == 0U) {
+			CNextion* nextion = new CNextion("N0CALL", 1234567U, port, 50U, false, false, 20U, 2U, 438000000U, 430000000U, false);
+			if (!PACINGS[pacing].m_delay)
+				nextion->setCommandDelay(0U);
+			display = nextion;
+		} else {
+			CTFTSurenoo* surenoo = new CTFTSurenoo("N0CALL", 1234567U, port, 50U, false);
+			if (!PACINGS[pacing].m_delay)
+				surenoo->setCommandDelay(0U);
+			display = surenoo;
+		}
+
+		// The start up isn't timed
+		if (!display->open()) {
+			delete display;
+			continue;
+		}
+
+		port->setBaudRate(baud, PACINGS[pacing].m_fifoSize);
+		port->setLatency(PACINGS[pacing].m_latency);
+		if (partial)
+			port->setMaxWrite(8U);
+
+		unsigned long long bytes   = port->getBytes();
+		unsigned long long blocked = port->getBlockedTime();
+		unsigned long long refused = port->getRefused();
+		uint64_t callTime   = 0ULL;
+		uint64_t screenTime = 0ULL;
+
+		for (unsigned int i = 0U; i < SERIAL_CALLS; i++) {
+			port->drain();
+
+			uint64_t start = now();
+			showCall(*display, entry, 1U + i % 2U);
+			uint64_t end = now();
+
+			port->drain();
+
+			callTime   += end - start;
+			screenTime += now() - start;
+
+			port->clear();
+		}
+
+		std::string name = std::string("serial.") + (driver == 0U ? "nextion" : "surenoo");
+		CBenchResult result(name.c_str());
+		result.add("baud", (unsigned long long)baud).add("pacing", partial ? "short_writes" : PACINGS[pacing].m_name)
+			.add("ops", (unsigned long long)SERIAL_CALLS)
+			.add("call_ms", double(callTime) / 1000000.0 / SERIAL_CALLS)
+			.add("screen_ms", double(screenTime) / 1000000.0 / SERIAL_CALLS)
+			.add("blocked_ms", double(port->getBlockedTime() - blocked) / 1000000.0 / SERIAL_CALLS)
+			.add("bytes_per_op", double(port->getBytes() - bytes) / SERIAL_CALLS)
+			.add("max_queued", (unsigned long long)port->getMaxQueued());
+		if (partial)
+			result.add("refused_per_op", double(port->getRefused() - refused) / SERIAL_CALLS);
+		result.print();
+
+		display->close();
+		delete display;
+	}
+}
+
+#if defined(OLED)
+void CBench::runOLED()
+{
+	// Both panels benchmarked are 128x64
+	const unsigned int OLED_WIDTH  = 128U;
+	const unsigned int OLED_HEIGHT = 64U;
+
+	static const struct {
+		const char*   m_name;
+		unsigned char m_type;
+	} TYPES[] = {
+		{"ssd1306", OLED_ADAFRUIT_I2C_128x64},
+		{"sh1106",  OLED_SH1106_I2C_128x64}
+	};
+
+	for (unsigned int t = 0U; t < sizeof(TYPES) / sizeof(TYPES[0U]); t++) {
+		// Without /dev/mem init() fails once the buffer is set up for I2C, the
+		// writes then fail at once and display() is left with packing the
+		// buffer. Run as root on a Pi it writes to the I2C bus.
+		ArduiPi_OLED display;
+		bool hardware = display.init(OLED_I2C_RESET, TYPES[t].m_type);
+
+		// begin() would drive the reset pin, only the GFX part is set up
+		display.constructor(OLED_WIDTH, OLED_HEIGHT);
+		display.setTextSize(1U);
+		display.setTextColor(WHITE);
+
+		unsigned long long ops;
+		double ns;
+		std::string name;
+
+		if (t == 0U) {
+			// The DMR screen of COLED::writeDMRIntEx()
+			ns = measure([&](unsigned long long n) {
+				for (unsigned long long i = 0ULL; i < n; i++) {
+					display.clearDisplay();
+					display.setCursor(0, 8);
+					display.printf("%s %s", "DL1ABC", "Hans");
+					display.setCursor(0, 18);
+					display.printf("Slot: %i %s %s%s", 1, "R", "TG: ", "91 Worldwide");
+					display.setCursor(0, 28);
+					display.printf("%s", "Mustermann");
+					display.setCursor(0, 37);
+					display.printf("%s", "Berlin");
+					display.setCursor(0, 47);
+					display.printf("%s", "Germany");
+					display.setCursor(0, 57);
+					display.printf("%s", "192.168.1.10");
+				}
+			}, ops);
+
+			CBenchResult("gfx.text").add("ops", ops).add("ns_per_op", ns).add("ns_per_char", ns / 72.0).print();
+		}
+
+		ns = measure([&](unsigned long long n) {
+			for (unsigned long long i = 0ULL; i < n; i++)
+				display.display();
+		}, ops);
+
+		name = std::string("oled.display_") + TYPES[t].m_name;
+		CBenchResult(name.c_str()).add("ops", ops).add("ns_per_op", ns)
+			.add("bytes", (unsigned long long)(OLED_WIDTH * OLED_HEIGHT / 8U)).add("i2c", hardware ? 1ULL : 0ULL).print();
+
+		display.close();
+	}
+}
+#endif
+
+static const struct {
+	const char* m_name;
+	void (CBench::*m_run)();
+} BENCHES[] = {
+	{"decode",  &CBench::runDecode},
+	{"load",    &CBench::runLoad},
+	{"lookup",  &CBench::runLookup},
+	{"legacy",  &CBench::runLegacy},
+	{"reload",  &CBench::runReload},
+	{"alloc",   &CBench::runAlloc},
+	{"nextion", &CBench::runNextion},
+	{"surenoo", &CBench::runSurenoo},
+	{"lcdproc", &CBench::runLCDproc},
+	{"serial",  &CBench::runSerial},
+#if defined(OLED)
+	{"oled",    &CBench::runOLED},
+#endif
+};
+
+static bool writeCorpus(const char* dir)
+{
+	if (::mkdir(dir, 0755) == -1 && errno != EEXIST) {
+		::fprintf(stderr, "Cannot create %s: %s\n", dir, ::strerror(errno));
+		return false;
+	}
+
+	std::vector<std::string> corpus;
+	CBench::makeCorpus(corpus);
+
+	for (unsigned int i = 0U; i < corpus.size(); i++) {
+		char filename[512U];
+		::snprintf(filename, sizeof(filename), "%s/malformed-%04u.bin", dir, i);
+
+		FILE* fp = ::fopen(filename, "wb");
+		if (fp == NULL) {
+			::fprintf(stderr, "Cannot create %s: %s\n", filename, ::strerror(errno));
+			return false;
+		}
+
+		::fwrite(corpus[i].data(), 1U, corpus[i].size(), fp);
+		::fclose(fp);
+	}
+
+	::fprintf(stderr, "Wrote %u datagrams to %s\n", (unsigned int)corpus.size(), dir);
+	return true;
+}
+
+int main(int argc, char** argv)
+{
+	CBench bench;
+	std::vector<std::string> filters;
+
+	for (int currentArg = 1; currentArg < argc; ++currentArg) {
+		std::string arg = argv[currentArg];
+		const char* value = currentArg + 1 < argc ? argv[currentArg + 1] : NULL;
+
+		if (arg == "--list") {
+			for (unsigned int i = 0U; i < sizeof(BENCHES) / sizeof(BENCHES[0U]); i++)
+				::fprintf(stdout, "%s\n", BENCHES[i].m_name);
+			return 0;
+		} else if (arg == "--filter" && value != NULL) {
+			filters.push_back(value);
+		} else if (arg == "--time" && value != NULL) {
+			bench.setTime((unsigned int)::atoi(value));
+		} else if (arg == "--rows" && value != NULL && ::atoi(value) > 0) {
+			bench.setRows((unsigned int)::atoi(value));
+		} else if (arg == "--ids" && value != NULL) {
+			bench.setIds(value);
+		} else if (arg == "--write-corpus" && value != NULL) {
+			return writeCorpus(value) ? 0 : 1;
+		} else {
+			::fprintf(stderr, "Usage: DisplayServer-bench [--list] [--filter name]... [--time ms] [--rows N] [--ids file.csv] [--write-corpus dir]\n");
+			return 1;
+		}
+
+		currentArg++;
+	}
+
+	// Nothing is logged, the output is only the results
+	LogInitialise(0U, false);
+
+	if (!bench.open())
+		return 1;
+
+	CBenchResult("info").add("version", VERSION).add("git", gitversion)
+		.add("cpus", (unsigned long long)::sysconf(_SC_NPROCESSORS_ONLN)).print();
+
+	for (unsigned int i = 0U; i < sizeof(BENCHES) / sizeof(BENCHES[0U]); i++) {
+		bool run = filters.empty();
+		for (std::vector<std::string>::const_iterator it = filters.begin(); it != filters.end(); ++it)
+			run |= *it == BENCHES[i].m_name;
+
+		if (run)
+			(bench.*BENCHES[i].m_run)();
+	}
+
+	LogFinalise();
+
+	return 0;
+}
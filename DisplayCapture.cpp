@@ -0,0 +1,177 @@
+/*
+ *   Copyright (C) 2026 by BrandMeister
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "DisplayCapture.h"
+#include "Log.h"
+
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+
+static const char CAPTURE_MAGIC[] = "DSCP";
+
+// Big enough that the disk is written a few times a minute at most
+const size_t CAPTURE_BUFFER_SIZE = 64U * 1024U;
+
+CDisplayCapture::CDisplayCapture() :
+m_filename(),
+m_fp(NULL),
+m_last(0ULL),
+m_count(0ULL)
+{
+}
+
+CDisplayCapture::~CDisplayCapture()
+{
+	close();
+}
+
+bool CDisplayCapture::create(const std::string& filename)
+{
+	assert(m_fp == NULL);
+
+	m_fp = ::fopen(filename.c_str(), "wb");
+	if (m_fp == NULL) {
+		LogError("Cannot create the capture file %s, err: %d", filename.c_str(), errno);
+		return false;
+	}
+
+	::setvbuf(m_fp, NULL, _IOFBF, CAPTURE_BUFFER_SIZE);
+
+	unsigned char header[CAPTURE_HEADER_LENGTH];
+	::memcpy(header, CAPTURE_MAGIC, 4U);
+	header[4U] = CAPTURE_VERSION & 0xFFU;
+	header[5U] = CAPTURE_VERSION >> 8;
+	header[6U] = 0U;
+	header[7U] = 0U;
+
+	if (::fwrite(header, 1U, sizeof(header), m_fp) != sizeof(header)) {
+		LogError("Cannot write the capture file %s, err: %d", filename.c_str(), errno);
+		close();
+		return false;
+	}
+
+	m_filename = filename;
+	m_last     = 0ULL;
+	m_count    = 0ULL;
+
+	LogInfo("Capturing the display protocol to %s", filename.c_str());
+
+	return true;
+}
+
+void CDisplayCapture::write(const unsigned char* data, unsigned int length, uint64_t timestamp)
+{
+	assert(data != NULL);
+
+	if (m_fp == NULL)
+		return;
+
+	// The first datagram is the start of the capture
+	uint64_t gap = m_count > 0ULL && timestamp > m_last ? (timestamp - m_last) / 1000ULL : 0ULL;
+	if (gap > 0xFFFFFFFFULL)
+		gap = 0xFFFFFFFFULL;
+
+	m_last = timestamp;
+
+	unsigned char record[CAPTURE_RECORD_LENGTH];
+	record[0U] = gap & 0xFFU;
+	record[1U] = (gap >> 8) & 0xFFU;
+	record[2U] = (gap >> 16) & 0xFFU;
+	record[3U] = (gap >> 24) & 0xFFU;
+	record[4U] = length & 0xFFU;
+	record[5U] = (length >> 8) & 0xFFU;
+
+	if (::fwrite(record, 1U, sizeof(record), m_fp) != sizeof(record) || ::fwrite(data, 1U, length, m_fp) != length) {
+		LogError("Cannot write the capture file %s, err: %d, capture stopped", m_filename.c_str(), errno);
+		close();
+		return;
+	}
+
+	m_count++;
+}
+
+bool CDisplayCapture::open(const std::string& filename)
+{
+	assert(m_fp == NULL);
+
+	m_fp = ::fopen(filename.c_str(), "rb");
+	if (m_fp == NULL) {
+		LogError("Cannot open the capture file %s, err: %d", filename.c_str(), errno);
+		return false;
+	}
+
+	unsigned char header[CAPTURE_HEADER_LENGTH];
+	if (::fread(header, 1U, sizeof(header), m_fp) != sizeof(header) || ::memcmp(header, CAPTURE_MAGIC, 4U) != 0) {
+		LogError("%s isn't a capture file", filename.c_str());
+		close();
+		return false;
+	}
+
+	uint16_t version = header[4U] | (header[5U] << 8);
+	if (version != CAPTURE_VERSION) {
+		LogError("Capture file %s is version %u, not %u", filename.c_str(), version, CAPTURE_VERSION);
+		close();
+		return false;
+	}
+
+	m_filename = filename;
+	m_count    = 0ULL;
+
+	return true;
+}
+
+bool CDisplayCapture::read(unsigned char* data, unsigned int size, unsigned int& length, unsigned int& gap)
+{
+	assert(data != NULL);
+
+	if (m_fp == NULL)
+		return false;
+
+	unsigned char record[CAPTURE_RECORD_LENGTH];
+	size_t n = ::fread(record, 1U, sizeof(record), m_fp);
+	if (n == 0U)
+		return false;
+
+	if (n == sizeof(record)) {
+		gap    = record[0U] | (record[1U] << 8) | (record[2U] << 16) | ((unsigned int)record[3U] << 24);
+		length = record[4U] | (record[5U] << 8);
+
+		if (length <= size && ::fread(data, 1U, length, m_fp) == length) {
+			m_count++;
+			return true;
+		}
+	}
+
+	LogWarning("Capture file %s is corrupt or ends part way through a datagram", m_filename.c_str());
+	return false;
+}
+
+void CDisplayCapture::close()
+{
+	if (m_fp == NULL)
+		return;
+
+	::fclose(m_fp);
+	m_fp = NULL;
+}
+
+unsigned long long CDisplayCapture::getCount() const
+{
+	return m_count;
+}
@@ -0,0 +1,62 @@
+/*
+ *   Copyright (C) 2026 by BrandMeister
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+// A capture file is a header, "DSCP" and a 16 bit version, followed by a
+// record per datagram: the time since the previous datagram in us (32 bit),
+// the datagram's length (16 bit) and the datagram itself. All numbers are
+// little endian.
+const unsigned int CAPTURE_HEADER_LENGTH = 8U;
+const unsigned int CAPTURE_RECORD_LENGTH = 6U;		// before the datagram
+const uint16_t     CAPTURE_VERSION       = 1U;
+
+// Records the display protocol datagrams exactly as received, with their
+// timing, so they can be replayed with DisplayServer --replay
+class CDisplayCapture {
+public:
+	CDisplayCapture();
+	~CDisplayCapture();
+
+	// For writing, replaces any existing file
+	bool create(const std::string& filename);
+
+	// timestamp is CLOCK_MONOTONIC in ns
+	void write(const unsigned char* data, unsigned int length, uint64_t timestamp);
+
+	// For reading
+	bool open(const std::string& filename);
+
+	// Returns false at the end of the file, or if it ends part way through
+	// a record. gap is the time in us since the previous datagram.
+	bool read(unsigned char* data, unsigned int size, unsigned int& length, unsigned int& gap);
+
+	void close();
+
+	unsigned long long getCount() const;
+
+private:
+	std::string        m_filename;
+	FILE*              m_fp;
+	uint64_t           m_last;		// timestamp of the last datagram written
+	unsigned long long m_count;
+};
@@ -0,0 +1,134 @@
+/*
+ *   Copyright (C) 2026 by BrandMeister
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "DisplayCoalescer.h"
+#include "DisplayProtocol.h"
+
+#include <cassert>
+#include <cstdio>
+
+// Marks an event that has been merged into a newer one
+const unsigned char DISPLAY_MERGED = 0x00U;
+
+CDisplayCoalescer::CDisplayCoalescer(unsigned int size) :
+m_events(NULL),
+m_size(size),
+m_head(0U),
+m_count(0U),
+m_merged(0ULL)
+{
+	assert(size > 0U);
+
+	m_events = new CDisplayEvent[size];
+}
+
+CDisplayCoalescer::~CDisplayCoalescer()
+{
+	delete[] m_events;
+}
+
+bool CDisplayCoalescer::add(const CDisplayEvent& event)
+{
+	if (m_count >= m_size)
+		return false;
+
+	if (!isBarrier(event.m_type)) {
+		// Walk back from the newest pending event to the last barrier
+		for (unsigned int i = m_count; i > 0U; i--) {
+			CDisplayEvent& pending = m_events[(m_head + i - 1U) % m_size];
+
+			// Merged events are gaps, not barriers
+			if (pending.m_type == DISPLAY_MERGED)
+				continue;
+
+			if (isBarrier(pending.m_type))
+				break;
+
+			if (supersedes(event, pending)) {
+				pending.m_type = DISPLAY_MERGED;
+				m_merged.fetch_add(1U, std::memory_order_relaxed);
+			}
+		}
+	}
+
+	m_events[(m_head + m_count) % m_size] = event;
+	m_count++;
+
+	return true;
+}
+
+bool CDisplayCoalescer::get(CDisplayEvent& event)
+{
+	while (m_count > 0U) {
+		CDisplayEvent& pending = m_events[m_head];
+
+		m_head = (m_head + 1U) % m_size;
+		m_count--;
+
+		if (pending.m_type != DISPLAY_MERGED) {
+			event = pending;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool CDisplayCoalescer::isFull() const
+{
+	return m_count >= m_size;
+}
+
+unsigned long long CDisplayCoalescer::getMerged() const
+{
+	return m_merged.load(std::memory_order_relaxed);
+}
+
+bool CDisplayCoalescer::isBarrier(unsigned char type)
+{
+	switch (type) {
+		case DISPLAY_DMR:
+		case DISPLAY_DMR_RSSI:
+		case DISPLAY_DMR_TA:
+		case DISPLAY_DMR_BER:
+		case DISPLAY_DMR_CLEAR:
+			return false;
+		default:
+			return true;
+	}
+}
+
+bool CDisplayCoalescer::supersedes(const CDisplayEvent& newer, const CDisplayEvent& older)
+{
+	if (newer.m_slotNo != older.m_slotNo)
+		return false;
+
+	switch (newer.m_type) {
+		case DISPLAY_DMR:
+			// A new call replaces everything still pending for the previous one
+			return true;
+
+		case DISPLAY_DMR_CLEAR:
+			// The call has ended, its signal reports and alias are stale. The
+			// call itself must still be shown for the display hold time.
+			return older.m_type != DISPLAY_DMR;
+
+		default:
+			return newer.m_type == older.m_type;
+	}
+}
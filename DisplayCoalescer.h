@@ -0,0 +1,54 @@
+/*
+ *   Copyright (C) 2026 by BrandMeister
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#pragma once
+
+#include "DisplayEvent.h"
+
+#include <atomic>
+
+// Pending display updates between the queue and the display. A newer
+// update replaces older ones with the same (opcode, slot) key, and a
+// new call or clear on a slot drops that slot's stale per-call updates.
+// Mode changes (idle, error, quit, POCSAG, CW) are barriers that nothing
+// is merged across.
+class CDisplayCoalescer {
+public:
+	CDisplayCoalescer(unsigned int size);
+	~CDisplayCoalescer();
+
+	// Returns false when full, the caller should get() first
+	bool add(const CDisplayEvent& event);
+
+	// Oldest pending event
+	bool get(CDisplayEvent& event);
+
+	bool isFull() const;
+
+	unsigned long long getMerged() const;
+
+private:
+	CDisplayEvent*                  m_events;
+	unsigned int                    m_size;
+	unsigned int                    m_head;
+	unsigned int                    m_count;
+	std::atomic<unsigned long long> m_merged;
+
+	static bool isBarrier(unsigned char type);
+	static bool supersedes(const CDisplayEvent& newer, const CDisplayEvent& older);
+};
@@ -0,0 +1,388 @@
+/*
+ *   Copyright (C) 2026 by BrandMeister
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "DisplayDecoder.h"
+#include "DisplayProtocol.h"
+
+#include <cassert>
+#include <cstdio>
+
+CDisplayMessage::CDisplayMessage() :
+m_type(0U),
+m_slotNo(0U),
+m_srcId(0U),
+m_dstId(0U),
+m_group(false),
+m_dmrType(0),
+m_rssi(0U),
+m_ber(0.0F),
+m_ric(0U),
+m_text(NULL),
+m_textLength(0U)
+{
+}
+
+CDisplayFrame::CDisplayFrame() :
+m_version(0U),
+m_sequence(0U),
+m_count(0U),
+m_data(NULL),
+m_length(0U),
+m_offset(0U)
+{
+}
+
+bool CDisplayFrame::next(const unsigned char*& data, unsigned int& length)
+{
+	// decodeFrame() has already checked that every update fits
+	if (m_offset >= m_length)
+		return false;
+
+	length = m_data[m_offset];
+	data   = m_data + m_offset + 1U;
+
+	m_offset += length + 1U;
+
+	return true;
+}
+
+// Indexed by opcode, minLength includes the opcode byte itself
+const CDisplayDecoder::Opcode CDisplayDecoder::s_opcodes[DISPLAY_OPCODE_COUNT] = {
+	{ 0U,  NULL },					// 0x00 unused
+	{ 1U,  &CDisplayDecoder::decodeEmpty },		// DISPLAY_IDLE
+	{ 2U,  &CDisplayDecoder::decodeError },		// DISPLAY_ERROR: count, text
+	{ 1U,  &CDisplayDecoder::decodeEmpty },		// DISPLAY_QUIT
+	{ 12U, &CDisplayDecoder::decodeDMR },		// DISPLAY_DMR: slot, src[4], group, dst[4], type
+	{ 3U,  &CDisplayDecoder::decodeDMRRSSI },	// DISPLAY_DMR_RSSI: slot, rssi
+	{ 4U,  &CDisplayDecoder::decodeDMRTA },		// DISPLAY_DMR_TA: slot, type, count, text
+	{ 3U,  &CDisplayDecoder::decodeDMRBER },	// DISPLAY_DMR_BER: slot, count, ASCII ber
+	{ 2U,  &CDisplayDecoder::decodeDMRSlot },	// DISPLAY_DMR_CLEAR: slot
+	{ 6U,  &CDisplayDecoder::decodePOCSAG },	// DISPLAY_POCSAG: ric[4], count, text
+	{ 1U,  &CDisplayDecoder::decodeEmpty },		// DISPLAY_POCSAG_CLEAR
+	{ 1U,  &CDisplayDecoder::decodeEmpty },		// DISPLAY_CW
+	{ 1U,  &CDisplayDecoder::decodeEmpty },		// DISPLAY_CW_CLEAR
+	{ 1U,  &CDisplayDecoder::decodeEmpty }		// DISPLAY_CLOSE
+};
+
+CDisplayDecoder::CDisplayDecoder() :
+m_decoded(),
+m_errors(0ULL),
+m_frames(0ULL),
+m_lost(0ULL),
+m_reordered(0ULL),
+m_duplicates(0ULL),
+m_resyncs(0ULL),
+m_sequenceValid(false),
+m_nextSequence(0U),
+m_seen(0U)
+{
+}
+
+CDisplayDecoder::~CDisplayDecoder()
+{
+}
+
+bool CDisplayDecoder::decode(const unsigned char* data, unsigned int length, CDisplayMessage& message)
+{
+	assert(data != NULL);
+
+	if (length == 0U || data[0U] >= DISPLAY_OPCODE_COUNT) {
+		m_errors.fetch_add(1U, std::memory_order_relaxed);
+		return false;
+	}
+
+	const Opcode& opcode = s_opcodes[data[0U]];
+
+	if (opcode.decoder == NULL || length < opcode.minLength) {
+		m_errors.fetch_add(1U, std::memory_order_relaxed);
+		return false;
+	}
+
+	message.m_type       = data[0U];
+	message.m_text       = NULL;
+	message.m_textLength = 0U;
+
+	if (!(this->*opcode.decoder)(data, length, message)) {
+		m_errors.fetch_add(1U, std::memory_order_relaxed);
+		return false;
+	}
+
+	m_decoded[data[0U]].fetch_add(1U, std::memory_order_relaxed);
+
+	return true;
+}
+
+bool CDisplayDecoder::decodeFrame(const unsigned char* data, unsigned int length, CDisplayFrame& frame)
+{
+	assert(data != NULL);
+
+	if (length < DISPLAY_FRAME_HEADER_LENGTH || data[0U] != DISPLAY_FRAME || data[1U] != DISPLAY_FRAME_VERSION) {
+		m_errors.fetch_add(1U, std::memory_order_relaxed);
+		return false;
+	}
+
+	unsigned int count  = data[4U];
+	unsigned int offset = DISPLAY_FRAME_HEADER_LENGTH;
+
+	for (unsigned int i = 0U; i < count; i++) {
+		if (offset >= length) {
+			m_errors.fetch_add(1U, std::memory_order_relaxed);
+			return false;
+		}
+
+		unsigned int n = data[offset];
+		if (n == 0U || n > length - offset - 1U) {
+			m_errors.fetch_add(1U, std::memory_order_relaxed);
+			return false;
+		}
+
+		offset += n + 1U;
+	}
+
+	// Trailing bytes mean the count and the contents disagree
+	if (offset != length) {
+		m_errors.fetch_add(1U, std::memory_order_relaxed);
+		return false;
+	}
+
+	frame.m_version  = data[1U];
+	frame.m_sequence = (uint16_t(data[2U]) << 8) | uint16_t(data[3U]);
+	frame.m_count    = count;
+	frame.m_data     = data;
+	frame.m_length   = length;
+	frame.m_offset   = DISPLAY_FRAME_HEADER_LENGTH;
+
+	m_frames.fetch_add(1U, std::memory_order_relaxed);
+
+	return true;
+}
+
+bool CDisplayDecoder::checkSequence(uint16_t sequence)
+{
+	if (!m_sequenceValid) {
+		m_sequenceValid = true;
+		m_nextSequence  = sequence + 1U;
+		m_seen          = 1U;
+		return true;
+	}
+
+	uint16_t ahead = sequence - m_nextSequence;
+
+	// In order, or newer with the frames in between missing so far
+	if (ahead <= DISPLAY_SEQUENCE_WINDOW) {
+		m_lost.fetch_add(ahead, std::memory_order_relaxed);
+
+		unsigned int shift = ahead + 1U;
+		m_seen = shift >= 32U ? 1U : (m_seen << shift) | 1U;
+
+		m_nextSequence = sequence + 1U;
+		return true;
+	}
+
+	uint16_t behind = uint16_t(m_nextSequence - 1U) - sequence;
+
+	if (behind < 32U) {
+		uint32_t bit = 1U << behind;
+
+		if ((m_seen & bit) != 0U) {
+			m_duplicates.fetch_add(1U, std::memory_order_relaxed);
+			return false;
+		}
+
+		// A late frame, it was counted as lost when the newer one arrived
+		m_seen |= bit;
+		m_reordered.fetch_add(1U, std::memory_order_relaxed);
+		if (m_lost.load(std::memory_order_relaxed) > 0ULL)
+			m_lost.fetch_sub(1U, std::memory_order_relaxed);
+
+		return true;
+	}
+
+	// Too far either way to be loss or a late frame, e.g. MMDVMHost
+	// restarting from 0, so the sender has restarted: start over from here
+	m_resyncs.fetch_add(1U, std::memory_order_relaxed);
+
+	m_nextSequence = sequence + 1U;
+	m_seen         = 1U;
+
+	return true;
+}
+
+unsigned long long CDisplayDecoder::getDecoded(unsigned char type) const
+{
+	if (type >= DISPLAY_OPCODE_COUNT)
+		return 0ULL;
+
+	return m_decoded[type].load(std::memory_order_relaxed);
+}
+
+unsigned long long CDisplayDecoder::getErrors() const
+{
+	return m_errors.load(std::memory_order_relaxed);
+}
+
+unsigned long long CDisplayDecoder::getFrames() const
+{
+	return m_frames.load(std::memory_order_relaxed);
+}
+
+unsigned long long CDisplayDecoder::getLost() const
+{
+	return m_lost.load(std::memory_order_relaxed);
+}
+
+unsigned long long CDisplayDecoder::getReordered() const
+{
+	return m_reordered.load(std::memory_order_relaxed);
+}
+
+unsigned long long CDisplayDecoder::getDuplicates() const
+{
+	return m_duplicates.load(std::memory_order_relaxed);
+}
+
+unsigned long long CDisplayDecoder::getResyncs() const
+{
+	return m_resyncs.load(std::memory_order_relaxed);
+}
+
+bool CDisplayDecoder::decodeEmpty(const unsigned char* data, unsigned int length, CDisplayMessage& message) const
+{
+	return true;
+}
+
+bool CDisplayDecoder::decodeError(const unsigned char* data, unsigned int length, CDisplayMessage& message) const
+{
+	return getText(data, length, 1U, message);
+}
+
+bool CDisplayDecoder::decodeDMR(const unsigned char* data, unsigned int length, CDisplayMessage& message) const
+{
+	if (!getSlot(data[1U], message))
+		return false;
+
+	message.m_srcId   = get32(data + 2U);
+	message.m_group   = data[6U] != 0U;
+	message.m_dstId   = get32(data + 7U);
+	message.m_dmrType = char(data[11U]);
+
+	return true;
+}
+
+bool CDisplayDecoder::decodeDMRRSSI(const unsigned char* data, unsigned int length, CDisplayMessage& message) const
+{
+	message.m_rssi = data[2U];
+
+	return getSlot(data[1U], message);
+}
+
+bool CDisplayDecoder::decodeDMRTA(const unsigned char* data, unsigned int length, CDisplayMessage& message) const
+{
+	message.m_dmrType = char(data[2U]);
+
+	return getSlot(data[1U], message) && getText(data, length, 3U, message);
+}
+
+bool CDisplayDecoder::decodeDMRBER(const unsigned char* data, unsigned int length, CDisplayMessage& message) const
+{
+	if (!getSlot(data[1U], message) || !getText(data, length, 2U, message))
+		return false;
+
+	return parseBER(message.m_text, message.m_textLength, message.m_ber);
+}
+
+bool CDisplayDecoder::decodeDMRSlot(const unsigned char* data, unsigned int length, CDisplayMessage& message) const
+{
+	return getSlot(data[1U], message);
+}
+
+bool CDisplayDecoder::decodePOCSAG(const unsigned char* data, unsigned int length, CDisplayMessage& message) const
+{
+	message.m_ric = get32(data + 1U);
+
+	return getText(data, length, 5U, message);
+}
+
+// The byte at offset is a count of the text bytes that follow it
+bool CDisplayDecoder::getText(const unsigned char* data, unsigned int length, unsigned int offset, CDisplayMessage& message)
+{
+	if (offset >= length)
+		return false;
+
+	unsigned int count = data[offset];
+	if (count > length - offset - 1U)
+		return false;
+
+	message.m_text       = data + offset + 1U;
+	message.m_textLength = count;
+
+	return true;
+}
+
+bool CDisplayDecoder::getSlot(unsigned char slot, CDisplayMessage& message)
+{
+	if (slot != 1U && slot != 2U)
+		return false;
+
+	message.m_slotNo = slot;
+
+	return true;
+}
+
+// The BER is sent as ASCII, e.g. "1.5", parse it without a copy or atof()
+bool CDisplayDecoder::parseBER(const unsigned char* text, unsigned int length, float& ber)
+{
+	unsigned int value   = 0U;
+	unsigned int divisor = 1U;
+	bool digits   = false;
+	bool fraction = false;
+
+	for (unsigned int i = 0U; i < length && text[i] != 0U; i++) {
+		unsigned char c = text[i];
+
+		if (c >= '0' && c <= '9') {
+			// More than a few decimal places adds nothing to a percentage
+			if (divisor >= 10000U)
+				continue;
+
+			if (value > 100000U)
+				return false;
+
+			value = value * 10U + (c - '0');
+			if (fraction)
+				divisor *= 10U;
+			digits = true;
+		} else if (c == '.' && !fraction) {
+			fraction = true;
+		} else {
+			break;
+		}
+	}
+
+	if (!digits)
+		return false;
+
+	ber = float(value) / float(divisor);
+
+	return true;
+}
+
+uint32_t CDisplayDecoder::get32(const unsigned char* data)
+{
+	return (uint32_t(data[0U]) << 24) | (uint32_t(data[1U]) << 16) | (uint32_t(data[2U]) << 8) | uint32_t(data[3U]);
+}
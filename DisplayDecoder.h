@@ -0,0 +1,126 @@
+/*
+ *   Copyright (C) 2026 by BrandMeister
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+const unsigned int DISPLAY_OPCODE_COUNT = 0x0EU;
+
+// A frame up to this far ahead of the next expected one counts the ones
+// in between as lost, a bigger jump is taken as the sender restarting
+const uint16_t DISPLAY_SEQUENCE_WINDOW = 1024U;
+
+// One validated display protocol message. The text field is a view into
+// the receive buffer, it is not NUL terminated and is only valid for as
+// long as that buffer is.
+class CDisplayMessage {
+public:
+	CDisplayMessage();
+
+	unsigned char        m_type;		// DISPLAY_xxx opcode
+	unsigned int         m_slotNo;
+	unsigned int         m_srcId;
+	unsigned int         m_dstId;
+	bool                 m_group;
+	char                 m_dmrType;
+	unsigned char        m_rssi;
+	float                m_ber;
+	uint32_t             m_ric;
+	const unsigned char* m_text;
+	unsigned int         m_textLength;
+};
+
+// One validated v2 frame, the updates are views into the receive buffer
+class CDisplayFrame {
+public:
+	CDisplayFrame();
+
+	// Steps through the updates, returns false once all have been read
+	bool next(const unsigned char*& data, unsigned int& length);
+
+	unsigned char        m_version;
+	uint16_t             m_sequence;
+	unsigned int         m_count;
+	const unsigned char* m_data;
+	unsigned int         m_length;
+	unsigned int         m_offset;
+};
+
+class CDisplayDecoder {
+public:
+	CDisplayDecoder();
+	~CDisplayDecoder();
+
+	// Returns false, and counts an error, for unknown opcodes and for any
+	// field that would extend past length
+	bool decode(const unsigned char* data, unsigned int length, CDisplayMessage& message);
+
+	// Checks the frame header and that every update length fits, the
+	// updates themselves are decoded one at a time with decode()
+	bool decodeFrame(const unsigned char* data, unsigned int length, CDisplayFrame& frame);
+
+	// Tracks the frame sequence numbers of a single sender, returns false
+	// for a duplicate frame that should be dropped
+	bool checkSequence(uint16_t sequence);
+
+	unsigned long long getDecoded(unsigned char type) const;
+	unsigned long long getErrors() const;
+	unsigned long long getFrames() const;
+	unsigned long long getLost() const;
+	unsigned long long getReordered() const;
+	unsigned long long getDuplicates() const;
+	unsigned long long getResyncs() const;
+
+private:
+	typedef bool (CDisplayDecoder::*Decoder)(const unsigned char* data, unsigned int length, CDisplayMessage& message) const;
+
+	struct Opcode {
+		unsigned int minLength;
+		Decoder      decoder;
+	};
+
+	static const Opcode s_opcodes[DISPLAY_OPCODE_COUNT];
+
+	// Read by the metrics thread
+	std::atomic<unsigned long long> m_decoded[DISPLAY_OPCODE_COUNT];
+	std::atomic<unsigned long long> m_errors;
+	std::atomic<unsigned long long> m_frames;
+	std::atomic<unsigned long long> m_lost;
+	std::atomic<unsigned long long> m_reordered;
+	std::atomic<unsigned long long> m_duplicates;
+	std::atomic<unsigned long long> m_resyncs;
+	bool               m_sequenceValid;
+	uint16_t           m_nextSequence;
+	uint32_t           m_seen;		// bit n set when m_nextSequence - 1 - n has been received
+
+	bool decodeEmpty(const unsigned char* data, unsigned int length, CDisplayMessage& message) const;
+	bool decodeError(const unsigned char* data, unsigned int length, CDisplayMessage& message) const;
+	bool decodeDMR(const unsigned char* data, unsigned int length, CDisplayMessage& message) const;
+	bool decodeDMRRSSI(const unsigned char* data, unsigned int length, CDisplayMessage& message) const;
+	bool decodeDMRTA(const unsigned char* data, unsigned int length, CDisplayMessage& message) const;
+	bool decodeDMRBER(const unsigned char* data, unsigned int length, CDisplayMessage& message) const;
+	bool decodeDMRSlot(const unsigned char* data, unsigned int length, CDisplayMessage& message) const;
+	bool decodePOCSAG(const unsigned char* data, unsigned int length, CDisplayMessage& message) const;
+
+	static bool getText(const unsigned char* data, unsigned int length, unsigned int offset, CDisplayMessage& message);
+	static bool getSlot(unsigned char slot, CDisplayMessage& message);
+	static bool parseBER(const unsigned char* text, unsigned int length, float& ber);
+	static uint32_t get32(const unsigned char* data);
+};
@@ -0,0 +1,233 @@
+/*
+ *   Copyright (C) 2026 by BrandMeister
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "DisplayEncoder.h"
+
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+
+// The length byte limits an update to 255 bytes, the opcode and fixed fields included
+const unsigned int MAX_UPDATE_LENGTH = 255U;
+
+CDisplayEncoder::CDisplayEncoder(unsigned char* buffer, unsigned int size) :
+m_buffer(buffer),
+m_size(size),
+m_length(0U),
+m_count(0U),
+m_sequence(0U)
+{
+	assert(buffer != NULL);
+	assert(size >= DISPLAY_FRAME_HEADER_LENGTH);
+}
+
+CDisplayEncoder::~CDisplayEncoder()
+{
+}
+
+void CDisplayEncoder::begin()
+{
+	m_buffer[0U] = DISPLAY_FRAME;
+	m_buffer[1U] = DISPLAY_FRAME_VERSION;
+	m_buffer[2U] = m_sequence >> 8;
+	m_buffer[3U] = m_sequence & 0xFFU;
+	m_buffer[4U] = 0U;
+
+	m_length = DISPLAY_FRAME_HEADER_LENGTH;
+	m_count  = 0U;
+
+	m_sequence++;
+}
+
+bool CDisplayEncoder::setIdle()
+{
+	return writeEmpty(DISPLAY_IDLE);
+}
+
+bool CDisplayEncoder::setError(const char* text)
+{
+	return writeText(DISPLAY_ERROR, NULL, 0U, text);
+}
+
+bool CDisplayEncoder::setQuit()
+{
+	return writeEmpty(DISPLAY_QUIT);
+}
+
+bool CDisplayEncoder::writeDMR(unsigned int slotNo, uint32_t srcId, bool group, uint32_t dstId, char type)
+{
+	unsigned char data[12U];
+
+	data[0U]  = DISPLAY_DMR;
+	data[1U]  = slotNo;
+	data[2U]  = srcId >> 24;
+	data[3U]  = srcId >> 16;
+	data[4U]  = srcId >> 8;
+	data[5U]  = srcId;
+	data[6U]  = group ? 1U : 0U;
+	data[7U]  = dstId >> 24;
+	data[8U]  = dstId >> 16;
+	data[9U]  = dstId >> 8;
+	data[10U] = dstId;
+	data[11U] = type;
+
+	return write(data, sizeof(data));
+}
+
+bool CDisplayEncoder::writeDMRRSSI(unsigned int slotNo, unsigned char rssi)
+{
+	unsigned char data[3U];
+
+	data[0U] = DISPLAY_DMR_RSSI;
+	data[1U] = slotNo;
+	data[2U] = rssi;
+
+	return write(data, sizeof(data));
+}
+
+bool CDisplayEncoder::writeDMRTA(unsigned int slotNo, char type, const char* talkerAlias)
+{
+	unsigned char header[2U];
+
+	header[0U] = slotNo;
+	header[1U] = type;
+
+	return writeText(DISPLAY_DMR_TA, header, sizeof(header), talkerAlias);
+}
+
+bool CDisplayEncoder::writeDMRBER(unsigned int slotNo, float ber)
+{
+	unsigned char header[1U];
+	header[0U] = slotNo;
+
+	char text[16U];
+	::snprintf(text, sizeof(text), "%.1f", ber);
+
+	return writeText(DISPLAY_DMR_BER, header, sizeof(header), text);
+}
+
+bool CDisplayEncoder::clearDMR(unsigned int slotNo)
+{
+	unsigned char data[2U];
+
+	data[0U] = DISPLAY_DMR_CLEAR;
+	data[1U] = slotNo;
+
+	return write(data, sizeof(data));
+}
+
+bool CDisplayEncoder::writePOCSAG(uint32_t ric, const char* message)
+{
+	unsigned char header[4U];
+
+	header[0U] = ric >> 24;
+	header[1U] = ric >> 16;
+	header[2U] = ric >> 8;
+	header[3U] = ric;
+
+	return writeText(DISPLAY_POCSAG, header, sizeof(header), message);
+}
+
+bool CDisplayEncoder::clearPOCSAG()
+{
+	return writeEmpty(DISPLAY_POCSAG_CLEAR);
+}
+
+bool CDisplayEncoder::setCW()
+{
+	return writeEmpty(DISPLAY_CW);
+}
+
+bool CDisplayEncoder::clearCW()
+{
+	return writeEmpty(DISPLAY_CW_CLEAR);
+}
+
+bool CDisplayEncoder::close()
+{
+	return writeEmpty(DISPLAY_CLOSE);
+}
+
+unsigned int CDisplayEncoder::end()
+{
+	if (m_count == 0U)
+		return 0U;
+
+	m_buffer[4U] = m_count;
+
+	return m_length;
+}
+
+unsigned int CDisplayEncoder::getCount() const
+{
+	return m_count;
+}
+
+uint16_t CDisplayEncoder::getSequence() const
+{
+	return m_sequence;
+}
+
+bool CDisplayEncoder::writeEmpty(unsigned char type)
+{
+	return write(&type, 1U);
+}
+
+// Builds opcode, fixed fields, count, text; long text is truncated to fit an update
+bool CDisplayEncoder::writeText(unsigned char type, const unsigned char* header, unsigned int headerLength, const char* text)
+{
+	assert(headerLength + 2U <= MAX_UPDATE_LENGTH);
+
+	unsigned char data[MAX_UPDATE_LENGTH];
+
+	data[0U] = type;
+	if (headerLength > 0U)
+		::memcpy(data + 1U, header, headerLength);
+
+	unsigned int offset = headerLength + 1U;
+
+	unsigned int count = text != NULL ? ::strlen(text) : 0U;
+	if (count > MAX_UPDATE_LENGTH - offset - 1U)
+		count = MAX_UPDATE_LENGTH - offset - 1U;
+
+	data[offset] = count;
+	if (count > 0U)
+		::memcpy(data + offset + 1U, text, count);
+
+	return write(data, offset + 1U + count);
+}
+
+bool CDisplayEncoder::write(const unsigned char* data, unsigned int length)
+{
+	assert(length > 0U && length <= MAX_UPDATE_LENGTH);
+
+	// begin() hasn't been called
+	if (m_length < DISPLAY_FRAME_HEADER_LENGTH)
+		return false;
+
+	if (m_count >= 255U || length + 1U > m_size - m_length)
+		return false;
+
+	m_buffer[m_length] = length;
+	::memcpy(m_buffer + m_length + 1U, data, length);
+
+	m_length += length + 1U;
+	m_count++;
+
+	return true;
+}
@@ -0,0 +1,82 @@
+/*
+ *   Copyright (C) 2026 by BrandMeister
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#pragma once
+
+#include "DisplayProtocol.h"
+
+#include <cstdint>
+
+// Reference encoder for protocol v2 frames, for senders such as MMDVMHost.
+// It depends on nothing but the C library and builds as a static library
+// of its own.
+//
+//   unsigned char buffer[DISPLAY_FRAME_MAX_LENGTH];
+//   CDisplayEncoder encoder(buffer, sizeof(buffer));
+//
+//   encoder.begin();
+//   encoder.writeDMR(1U, 1234567U, true, 91U, 'R');
+//   encoder.writeDMRRSSI(1U, 80U);
+//   unsigned int length = encoder.end();
+//   // send buffer, length
+//
+// The write functions return false when the update doesn't fit, the
+// frame so far can then be sent and the update added to a new one.
+class CDisplayEncoder {
+public:
+	CDisplayEncoder(unsigned char* buffer, unsigned int size);
+	~CDisplayEncoder();
+
+	// Starts a new frame with the next sequence number
+	void begin();
+
+	bool setIdle();
+	bool setError(const char* text);
+	bool setQuit();
+
+	bool writeDMR(unsigned int slotNo, uint32_t srcId, bool group, uint32_t dstId, char type);
+	bool writeDMRRSSI(unsigned int slotNo, unsigned char rssi);
+	bool writeDMRTA(unsigned int slotNo, char type, const char* talkerAlias);
+	bool writeDMRBER(unsigned int slotNo, float ber);
+	bool clearDMR(unsigned int slotNo);
+
+	bool writePOCSAG(uint32_t ric, const char* message);
+	bool clearPOCSAG();
+
+	bool setCW();
+	bool clearCW();
+
+	bool close();
+
+	// Completes the frame and returns its length, 0 if it holds no updates
+	unsigned int end();
+
+	unsigned int getCount() const;
+	uint16_t     getSequence() const;
+
+private:
+	unsigned char* m_buffer;
+	unsigned int   m_size;
+	unsigned int   m_length;
+	unsigned int   m_count;
+	uint16_t       m_sequence;
+
+	bool writeEmpty(unsigned char type);
+	bool writeText(unsigned char type, const unsigned char* header, unsigned int headerLength, const char* text);
+	bool write(const unsigned char* data, unsigned int length);
+};
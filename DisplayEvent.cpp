@@ -0,0 +1,35 @@
+/*
+ *   Copyright (C) 2026 by BrandMeister
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "DisplayEvent.h"
+
+CDisplayEvent::CDisplayEvent() :
+m_type(0U),
+m_slotNo(0U),
+m_group(false),
+m_rssi(0U),
+m_ber(0.0F),
+m_ric(0U),
+m_dmrType(),
+m_src(),
+m_dst(),
+m_text(),
+m_received(0ULL),
+m_queued(0ULL)
+{
+}
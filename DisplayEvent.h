@@ -0,0 +1,46 @@
+/*
+ *   Copyright (C) 2026 by BrandMeister
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#pragma once
+
+#include "UserDBentry.h"
+
+#include <cstdint>
+
+const unsigned int DISPLAY_EVENT_CALLSIGN_LENGTH = 32U;
+const unsigned int DISPLAY_EVENT_TEXT_LENGTH     = 200U;
+
+// A decoded and looked up display update, passed by value from the
+// network thread to the display writer thread
+class CDisplayEvent {
+public:
+	CDisplayEvent();
+
+	unsigned char m_type;		// DISPLAY_xxx opcode
+	unsigned int  m_slotNo;
+	bool          m_group;
+	unsigned char m_rssi;
+	float         m_ber;
+	uint32_t      m_ric;
+	char          m_dmrType[2U];
+	CUserDBentry  m_src;
+	char          m_dst[DISPLAY_EVENT_CALLSIGN_LENGTH];
+	char          m_text[DISPLAY_EVENT_TEXT_LENGTH];	// error text, talker alias or POCSAG message
+	uint64_t      m_received;	// CLOCK_MONOTONIC ns, for the latency histograms
+	uint64_t      m_queued;
+};
@@ -0,0 +1,129 @@
+/*
+ *   Copyright (C) 2026 by BrandMeister
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "DisplayLatency.h"
+#include "Log.h"
+
+#include <cassert>
+#include <cstdio>
+#include <ctime>
+
+static const char* STAGE_NAMES[LS_COUNT] = {
+	"decode",
+	"lookup",
+	"queue",
+	"wait",
+	"write",
+	"total"
+};
+
+static const char* OPCODE_NAMES[LATENCY_OPCODES] = {
+	"unknown",
+	"idle",
+	"error",
+	"quit",
+	"dmr",
+	"dmr_rssi",
+	"dmr_ta",
+	"dmr_ber",
+	"dmr_clear",
+	"pocsag",
+	"pocsag_clear",
+	"cw",
+	"cw_clear",
+	"close"
+};
+
+CDisplayLatency::CDisplayLatency() :
+m_histograms(),
+m_driver()
+{
+}
+
+void CDisplayLatency::setDriver(const std::string& driver)
+{
+	m_driver = driver;
+}
+
+const CLatencyHistogram& CDisplayLatency::get(LATENCY_STAGE stage, unsigned char opcode) const
+{
+	assert(stage < LS_COUNT);
+	assert(opcode < LATENCY_OPCODES);
+
+	return m_histograms[stage][opcode];
+}
+
+void CDisplayLatency::dump() const
+{
+	LogMessage("Latency histograms, in us, display %s", m_driver.c_str());
+
+	for (unsigned int stage = 0U; stage < LS_COUNT; stage++) {
+		for (unsigned int opcode = 0U; opcode < LATENCY_OPCODES; opcode++) {
+			const CLatencyHistogram& histogram = m_histograms[stage][opcode];
+
+			unsigned long long count = histogram.getCount();
+			if (count == 0ULL)
+				continue;
+
+			// Only the buckets in use, as <limit:count
+			char buckets[300U];
+			unsigned int pos = 0U;
+			for (unsigned int n = 0U; n < LATENCY_BUCKETS && pos < sizeof(buckets); n++) {
+				unsigned long long samples = histogram.getBucket(n);
+				if (samples == 0ULL)
+					continue;
+
+				unsigned int limit = CLatencyHistogram::getLimit(n);
+				if (limit > 0U)
+					pos += ::snprintf(buckets + pos, sizeof(buckets) - pos, " <%u:%llu", limit, samples);
+				else
+					pos += ::snprintf(buckets + pos, sizeof(buckets) - pos, " >=%u:%llu", CLatencyHistogram::getLimit(n - 1U), samples);
+			}
+
+			LogMessage("    %s %s: %llu samples, avg %llu, p50 <%u, p90 <%u, p99 <%u, max %u,%s",
+				   STAGE_NAMES[stage], OPCODE_NAMES[opcode], count, histogram.getSum() / count,
+				   histogram.getPercentile(50U), histogram.getPercentile(90U), histogram.getPercentile(99U),
+				   histogram.getMax(), buckets);
+		}
+	}
+}
+
+const std::string& CDisplayLatency::getDriver() const
+{
+	return m_driver;
+}
+
+uint64_t CDisplayLatency::now()
+{
+	struct timespec ts;
+	::clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+const char* CDisplayLatency::getStageName(LATENCY_STAGE stage)
+{
+	assert(stage < LS_COUNT);
+
+	return STAGE_NAMES[stage];
+}
+
+const char* CDisplayLatency::getOpcodeName(unsigned char opcode)
+{
+	return opcode < LATENCY_OPCODES ? OPCODE_NAMES[opcode] : OPCODE_NAMES[0U];
+}
@@ -0,0 +1,75 @@
+/*
+ *   Copyright (C) 2026 by BrandMeister
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#pragma once
+
+#include "DisplayProtocol.h"
+#include "LatencyHistogram.h"
+
+#include <cstdint>
+#include <string>
+
+// Where a display update's time goes, from the datagram arriving to the
+// display driver having written it out
+enum LATENCY_STAGE {
+	LS_DECODE,		// received to decoded, including time in the socket queue
+	LS_LOOKUP,		// decoded to the IDs looked up
+	LS_QUEUE,		// looked up to queued for the writer
+	LS_WAIT,		// queued to taken by the writer, including merging
+	LS_WRITE,		// the display driver's serial, I2C or TCP write
+	LS_TOTAL,		// received to written
+	LS_COUNT
+};
+
+// Opcodes are indexed directly, anything above this isn't recorded
+const unsigned int LATENCY_OPCODES = DISPLAY_CLOSE + 1U;
+
+// Latency histograms per stage and opcode. The decode, lookup and queue
+// stages are recorded by the network thread, the others by the writer.
+class CDisplayLatency {
+public:
+	CDisplayLatency();
+
+	// The display type, the write stage is that driver's
+	void setDriver(const std::string& driver);
+
+	void add(LATENCY_STAGE stage, unsigned char opcode, uint64_t from, uint64_t to)
+	{
+		if (opcode >= LATENCY_OPCODES || to < from)
+			return;
+
+		m_histograms[stage][opcode].add((unsigned int)((to - from) / 1000ULL));
+	}
+
+	const CLatencyHistogram& get(LATENCY_STAGE stage, unsigned char opcode) const;
+
+	// Logs every histogram with samples in it
+	void dump() const;
+
+	const std::string& getDriver() const;
+
+	// CLOCK_MONOTONIC in ns, what all the stage timestamps use
+	static uint64_t now();
+
+	static const char* getStageName(LATENCY_STAGE stage);
+	static const char* getOpcodeName(unsigned char opcode);
+
+private:
+	CLatencyHistogram m_histograms[LS_COUNT][LATENCY_OPCODES];
+	std::string       m_driver;
+};
@@ -22,15 +22,44 @@
 
 #include <cstdio>
 #include <cassert>
+#include <cerrno>
 #include <cstring>
 
-CDisplayNetwork::CDisplayNetwork(const std::string& address, unsigned int port, bool trace) :
+static uint64_t getTime(clockid_t clock)
+{
+    struct timespec ts;
+    ::clock_gettime(clock, &ts);
+
+    return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+CDisplayNetwork::CDisplayNetwork(const std::string& address, unsigned int port, bool trace, bool timestamps) :
     m_addressStr(address),
     m_addr(),
     m_addrLen(0U),
     m_port(port),
-    m_trace(trace)
+    m_trace(trace),
+    m_timestamps(timestamps),
+    m_capture(NULL),
+    m_packets(),
+    m_messages(),
+    m_iovecs(),
+    m_addrs(),
+    m_controls(),
+    m_readMonotonic(0ULL),
+    m_readRealtime(0ULL),
+    m_batches(0ULL),
+    m_batchPackets(0ULL),
+    m_maxBatch(0U)
 {
+    for (unsigned int i = 0U; i < NETWORK_BATCH_SIZE; i++) {
+        m_iovecs[i].iov_base = m_packets[i];
+        m_iovecs[i].iov_len  = NETWORK_PACKET_SIZE;
+
+        m_messages[i].msg_hdr.msg_name    = &m_addrs[i];
+        m_messages[i].msg_hdr.msg_iov     = &m_iovecs[i];
+        m_messages[i].msg_hdr.msg_iovlen  = 1U;
+    }
 }
 
 CDisplayNetwork::~CDisplayNetwork()
@@ -43,7 +72,19 @@ bool CDisplayNetwork::open()
 
     CUDPSocket::lookup(m_addressStr, m_port, m_addr, m_addrLen);
 
-    return m_socket.open(m_addr.ss_family, m_addressStr, m_port);
+    if (!m_socket.open(m_addr.ss_family, m_addressStr, m_port)) {
+        return false;
+    }
+
+    if (m_timestamps) {
+        int on = 1;
+        if (::setsockopt(m_socket.getFd(), SOL_SOCKET, SO_TIMESTAMPNS, &on, sizeof(on)) < 0) {
+            LogWarning("Cannot enable receive timestamps, err: %d", errno);
+            m_timestamps = false;
+        }
+    }
+
+    return true;
 }
 
 unsigned int CDisplayNetwork::readData(unsigned char* data, unsigned int length, sockaddr_storage& addr, unsigned int& addrLen)
@@ -64,9 +105,129 @@ unsigned int CDisplayNetwork::readData(unsigned char* data, unsigned int length,
     return len;
 }
 
+unsigned int CDisplayNetwork::readBatch()
+{
+    // recvmmsg() overwrites these with the actual values
+    for (unsigned int i = 0U; i < NETWORK_BATCH_SIZE; i++) {
+        m_messages[i].msg_hdr.msg_namelen = sizeof(sockaddr_storage);
+        m_messages[i].msg_len             = 0U;
+
+        if (m_timestamps) {
+            m_messages[i].msg_hdr.msg_control    = m_controls[i];
+            m_messages[i].msg_hdr.msg_controllen = NETWORK_CONTROL_SIZE;
+        }
+    }
+
+    int n = m_socket.read(m_messages, NETWORK_BATCH_SIZE);
+
+    if (n <= 0) {
+        return 0U;
+    }
+
+    m_readMonotonic = getTime(CLOCK_MONOTONIC);
+    if (m_timestamps) {
+        m_readRealtime = getTime(CLOCK_REALTIME);
+    }
+
+    m_batches.fetch_add(1U, std::memory_order_relaxed);
+    m_batchPackets.fetch_add(n, std::memory_order_relaxed);
+
+    if ((unsigned int)n > m_maxBatch.load(std::memory_order_relaxed)) {
+        m_maxBatch.store(n, std::memory_order_relaxed);
+    }
+
+    if (m_trace) {
+        LogMessage("Network Received batch of %d packets", n);
+
+        for (int i = 0; i < n; i++) {
+            CUtils::dump(1U, "Network Received", m_packets[i], m_messages[i].msg_len);
+        }
+    }
+
+    if (m_capture != NULL) {
+        for (int i = 0; i < n; i++) {
+            unsigned int length;
+            const unsigned char* data = getPacket(i, length);
+
+            if (length > 0U) {
+                m_capture->write(data, length, getTimestamp(i));
+            }
+        }
+    }
+
+    return n;
+}
+
+const unsigned char* CDisplayNetwork::getPacket(unsigned int n, unsigned int& length) const
+{
+    assert(n < NETWORK_BATCH_SIZE);
+
+    // A datagram cut short by the buffer can't be decoded safely
+    if ((m_messages[n].msg_hdr.msg_flags & MSG_TRUNC) != 0) {
+        length = 0U;
+    } else {
+        length = m_messages[n].msg_len;
+    }
+
+    return m_packets[n];
+}
+
+uint64_t CDisplayNetwork::getTimestamp(unsigned int n) const
+{
+    assert(n < NETWORK_BATCH_SIZE);
+
+    if (!m_timestamps) {
+        return m_readMonotonic;
+    }
+
+    const struct msghdr* header = &m_messages[n].msg_hdr;
+
+    for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(header); cmsg != NULL; cmsg = CMSG_NXTHDR((struct msghdr*)header, cmsg)) {
+        if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_TIMESTAMPNS) {
+            continue;
+        }
+
+        struct timespec ts;
+        ::memcpy(&ts, CMSG_DATA(cmsg), sizeof(ts));
+
+        // How long the datagram waited in the socket queue
+        uint64_t stamp = ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+        uint64_t age   = m_readRealtime > stamp ? m_readRealtime - stamp : 0ULL;
+
+        return age < m_readMonotonic ? m_readMonotonic - age : m_readMonotonic;
+    }
+
+    return m_readMonotonic;
+}
+
+void CDisplayNetwork::setCapture(CDisplayCapture* capture)
+{
+    m_capture = capture;
+}
+
+unsigned long long CDisplayNetwork::getBatches() const
+{
+    return m_batches.load(std::memory_order_relaxed);
+}
+
+unsigned long long CDisplayNetwork::getPackets() const
+{
+    return m_batchPackets.load(std::memory_order_relaxed);
+}
+
+unsigned int CDisplayNetwork::getMaxBatch() const
+{
+    return m_maxBatch.load(std::memory_order_relaxed);
+}
+
 void CDisplayNetwork::close()
 {
     m_socket.close();
 
     LogInfo("Closing Display network connection");
 }
+
+int CDisplayNetwork::getFd() const
+{
+    return m_socket.getFd();
+}
@@ -18,23 +18,53 @@
 
 #pragma once
 
+#include "DisplayCapture.h"
+#include "DisplayProtocol.h"
 #include "UDPSocket.h"
 #include "Timer.h"
 
+#include <atomic>
 #include <cstdint>
 #include <string>
 
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <time.h>
+
+const unsigned int NETWORK_BATCH_SIZE  = 32U;
+const unsigned int NETWORK_PACKET_SIZE = DISPLAY_FRAME_MAX_LENGTH;
+const unsigned int NETWORK_CONTROL_SIZE = CMSG_SPACE(sizeof(struct timespec));
+
 class CDisplayNetwork {
   public:
-    CDisplayNetwork(const std::string& address, unsigned int port, bool trace);
+    // With timestamps the kernel stamps each datagram as it arrives
+    // (SO_TIMESTAMPNS), otherwise packets are timed from when they're read
+    CDisplayNetwork(const std::string& address, unsigned int port, bool trace, bool timestamps = false);
     ~CDisplayNetwork();
 
     bool open();
 
     unsigned int readData(unsigned char* data, unsigned int length, sockaddr_storage& addr, unsigned int& addrLen);
 
+    // Receive every queued datagram (up to NETWORK_BATCH_SIZE) in one call,
+    // returns how many packets the batch holds
+    unsigned int readBatch();
+    const unsigned char* getPacket(unsigned int n, unsigned int& length) const;
+
+    // When packet n of the batch was received, CLOCK_MONOTONIC in ns
+    uint64_t getTimestamp(unsigned int n) const;
+
+    // Every datagram read is recorded to capture, NULL to stop
+    void setCapture(CDisplayCapture* capture);
+
+    unsigned long long getBatches() const;
+    unsigned long long getPackets() const;
+    unsigned int       getMaxBatch() const;
+
     void close();
 
+    int getFd() const;
+
   private:
     CUDPSocket       m_socket;
     std::string      m_addressStr;
@@ -42,4 +72,22 @@ class CDisplayNetwork {
     unsigned int     m_addrLen;
     unsigned short   m_port;
     bool             m_trace;
+    bool             m_timestamps;
+    CDisplayCapture* m_capture;
+
+    unsigned char    m_packets[NETWORK_BATCH_SIZE][NETWORK_PACKET_SIZE];
+    struct mmsghdr   m_messages[NETWORK_BATCH_SIZE];
+    struct iovec     m_iovecs[NETWORK_BATCH_SIZE];
+    sockaddr_storage m_addrs[NETWORK_BATCH_SIZE];
+    unsigned char    m_controls[NETWORK_BATCH_SIZE][NETWORK_CONTROL_SIZE];
+
+    // The clocks when the batch was read, to move kernel timestamps from
+    // CLOCK_REALTIME to CLOCK_MONOTONIC
+    uint64_t         m_readMonotonic;
+    uint64_t         m_readRealtime;
+
+    // Read by the metrics thread
+    std::atomic<unsigned long long> m_batches;
+    std::atomic<unsigned long long> m_batchPackets;
+    std::atomic<unsigned int>       m_maxBatch;
 };
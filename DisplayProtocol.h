@@ -0,0 +1,50 @@
+/*
+ *   Copyright (C) 2026 by BrandMeister
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#pragma once
+
+// Opcodes of the MMDVMHost display protocol, the first byte of each datagram
+const unsigned char DISPLAY_IDLE         = 0x01U;
+const unsigned char DISPLAY_ERROR        = 0x02U;
+const unsigned char DISPLAY_QUIT         = 0x03U;
+const unsigned char DISPLAY_DMR          = 0x04U;
+const unsigned char DISPLAY_DMR_RSSI     = 0x05U;
+const unsigned char DISPLAY_DMR_TA       = 0x06U;
+const unsigned char DISPLAY_DMR_BER      = 0x07U;
+const unsigned char DISPLAY_DMR_CLEAR    = 0x08U;
+const unsigned char DISPLAY_POCSAG       = 0x09U;
+const unsigned char DISPLAY_POCSAG_CLEAR = 0x0AU;
+const unsigned char DISPLAY_CW           = 0x0BU;
+const unsigned char DISPLAY_CW_CLEAR     = 0x0CU;
+const unsigned char DISPLAY_CLOSE        = 0x0DU;
+
+// Protocol v2, a frame carrying several of the updates above in one datagram:
+//
+//   0x10, version, sequence (16 bit, big endian), count,
+//   then count updates, each a length byte followed by that many bytes
+//   holding one of the messages above, opcode first.
+//
+// The sequence number increments by one per frame so the receiver can
+// detect lost, reordered and duplicated frames.
+const unsigned char DISPLAY_FRAME         = 0x10U;
+const unsigned char DISPLAY_FRAME_VERSION = 0x01U;
+
+const unsigned int DISPLAY_FRAME_HEADER_LENGTH = 5U;
+
+// Keeps a frame within one unfragmented Ethernet datagram
+const unsigned int DISPLAY_FRAME_MAX_LENGTH = 1472U;
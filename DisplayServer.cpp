@@ -17,9 +17,11 @@
  */
 
 #include "DisplayNetwork.h"
+#include "DisplayProtocol.h"
 #include "DisplayServer.h"
 #include "GitVersion.h"
 #include "Log.h"
+#include "NullDisplay.h"
 #include "StopWatch.h"
 #include "Thread.h"
 #include "Version.h"
@@ -29,12 +31,14 @@
 #include <netinet/in.h>
 #include <pwd.h>
 #include <signal.h>
+#include <sys/signalfd.h>
 #include <sys/socket.h>
 #include <sys/time.h>
 #include <sys/types.h>
 #include <unistd.h>
 
 #include <algorithm>
+#include <cerrno>
 #include <cstdarg>
 #include <cstdio>
 #include <cstdlib>
@@ -43,9 +47,14 @@
 
 const char* DEFAULT_INI_FILE = "/etc/MMDVM.ini";
 
+const unsigned int STATS_INTERVAL = 60000U;    // ms
+
 int main(int argc, char** argv)
 {
-    const char* iniFile = DEFAULT_INI_FILE;
+    const char* iniFile    = DEFAULT_INI_FILE;
+    const char* replayFile = NULL;
+    double speed           = 1.0;
+    bool nullDisplay       = false;
 
     if (argc > 1) {
         for (int currentArg = 1; currentArg < argc; ++currentArg) {
@@ -54,8 +63,33 @@ int main(int argc, char** argv)
             if ((arg == "-v") || (arg == "--version")) {
                 ::fprintf(stdout, "DisplayServer version %s git #%.10s\n", VERSION, gitversion);
                 return 0;
+            } else if (arg == "--compile-ids") {
+                if (currentArg + 2 >= argc) {
+                    ::fprintf(stderr, "Usage: DisplayServer --compile-ids in.csv out.bin\n");
+                    ::fprintf(stderr, "out.bin is replaced by renaming, update it only that way while it is in use\n");
+                    return 1;
+                }
+
+                CUserDB userDB(::sysconf(_SC_NPROCESSORS_ONLN));
+                if (!userDB.load(argv[currentArg + 1]) || !userDB.save(argv[currentArg + 2])) {
+                    return 1;
+                }
+
+                ::fprintf(stdout, "Compiled %s to %s\n", argv[currentArg + 1], argv[currentArg + 2]);
+                return 0;
+            } else if (arg == "--replay" && currentArg + 1 < argc) {
+                replayFile = argv[++currentArg];
+            } else if (arg == "--speed" && currentArg + 1 < argc) {
+                std::string value = argv[++currentArg];
+                speed = value == "max" ? 0.0 : ::atof(value.c_str());
+                if (speed <= 0.0 && value != "max") {
+                    ::fprintf(stderr, "DisplayServer: --speed takes a factor, e.g. 10, or max\n");
+                    return 1;
+                }
+            } else if (arg == "--null") {
+                nullDisplay = true;
             } else if (arg.substr(0, 1) == "-") {
-                ::fprintf(stderr, "Usage: DisplayServer [-v|--version] [filename]\n");
+                ::fprintf(stderr, "Usage: DisplayServer [-v|--version] [--compile-ids in.csv out.bin] [--replay capture [--speed N|max] [--null]] [filename]\n");
                 return 1;
             } else {
                 iniFile = argv[currentArg];
@@ -64,7 +98,11 @@ int main(int argc, char** argv)
     }
 
     CDisplayServer* reflector = new CDisplayServer(std::string(iniFile));
-    reflector->run();
+    if (replayFile != NULL) {
+        reflector->replay(replayFile, speed, nullDisplay);
+    } else {
+        reflector->run();
+    }
     delete reflector;
 
     return 0;
@@ -74,8 +112,26 @@ CDisplayServer::CDisplayServer(const std::string& file) :
     m_conf(file),
     m_display(NULL),
     m_dmrLookup(NULL),
+    m_tgLookup(NULL),
+    m_network(NULL),
+    m_decoder(),
+    m_writer(NULL),
+    m_metrics(NULL),
+    m_reactor(),
     m_debug(false),
-    m_trace(false)
+    m_trace(false),
+    m_latency(),
+    m_received(0ULL),
+    m_signalFd(-1),
+    m_killed(false),
+    m_backpressure(false),
+    m_capture(),
+    m_statsWatch(),
+    m_statsWakeups(0ULL),
+    m_statsBatches(0ULL),
+    m_statsPackets(0U),
+    m_statsLatency(0ULL),
+    m_statsLatencyMax(0U)
 {
 }
 
@@ -85,20 +141,192 @@ CDisplayServer::~CDisplayServer()
 
 void CDisplayServer::run()
 {
-    bool ret = m_conf.read();
+    if (!open(false)) {
+        return;
+    }
+
+    m_network = new CDisplayNetwork(m_conf.getDisplayServerAddress(), m_conf.getDisplayServerPort(), m_trace, m_conf.getDisplayServerTimestamps());
+
+    bool ret = m_network->open();
 
     if (!ret) {
-        ::fprintf(stderr, "DisplayServer: cannot read the .ini file\n");
+        delete m_network;
+        close();
         return;
     }
 
-    ::LogInitialise(m_conf.getLogLevel(), m_conf.getSyslog());
+    m_writer = new CDisplayWriter(m_display, m_latency, m_debug);
+
+    ret = m_reactor.open() && m_writer->start();
+
+    // Unwound as on the way out, the writer has cleaned up after itself
+    if (!ret) {
+        delete m_writer;
+
+        m_reactor.close();
+
+        m_network->close();
+        delete m_network;
+
+        close();
+        return;
+    }
+
+    std::string captureFile = m_conf.getDisplayServerCaptureFile();
+    if (captureFile.length() > 0U && m_capture.create(captureFile)) {
+        m_network->setCapture(&m_capture);
+    }
+
+    std::string metricsAddress = m_conf.getDisplayServerMetricsAddress();
+    unsigned int metricsPort   = m_conf.getDisplayServerMetricsPort();
+    if (metricsPort > 0U || (metricsAddress.length() > 0U && metricsAddress[0U] == '/')) {
+        m_metrics = new CMetricsServer(metricsAddress, metricsPort, this);
+
+        // Not worth stopping for, the display works without it
+        if (!m_metrics->start()) {
+            delete m_metrics;
+            m_metrics = NULL;
+        }
+    }
+
+    // The network thread only waits for datagrams, everything that talks
+    // to the display runs on the display writer thread
+    m_reactor.add(m_network->getFd(), this);
+    m_reactor.add(m_signalFd, this);
+
+    m_statsWatch.start();
+
+    while (!m_killed) {
+        if (m_reactor.wait() < 0) {
+            break;
+        }
+
+        if (m_statsWatch.elapsed() >= STATS_INTERVAL) {
+            writeStats();
+        }
+    }
+
+    if (m_metrics != NULL) {
+        m_metrics->stop();
+        delete m_metrics;
+    }
+
+    m_writer->stop();
+    delete m_writer;
+
+    m_latency.dump();
+
+    if (captureFile.length() > 0U) {
+        LogMessage("Captured %llu datagrams to %s", m_capture.getCount(), captureFile.c_str());
+        m_network->setCapture(NULL);
+        m_capture.close();
+    }
+
+    m_reactor.close();
+
+    m_network->close();
+    delete m_network;
+
+    close();
+}
+
+// Feeds a capture through the decoder, lookups and display as if it had
+// come from the network, speed times as fast as it was recorded or, with a
+// speed of 0, as fast as the display takes it
+void CDisplayServer::replay(const std::string& filename, double speed, bool nullDisplay)
+{
+    if (!open(nullDisplay)) {
+        return;
+    }
 
-    CStopWatch stopWatch;
-    stopWatch.start();
+    CDisplayCapture capture;
+    if (!capture.open(filename)) {
+        close();
+        return;
+    }
+
+    m_writer = new CDisplayWriter(m_display, m_latency, m_debug);
+
+    if (!m_writer->start()) {
+        delete m_writer;
+        close();
+        return;
+    }
+
+    if (speed > 0.0) {
+        LogMessage("Replaying %s at %gx", filename.c_str(), speed);
+    } else {
+        LogMessage("Replaying %s as fast as the display allows", filename.c_str());
+    }
+
+    // A throughput run waits for the display rather than dropping updates
+    m_backpressure = speed == 0.0;
+
+    unsigned char buffer[NETWORK_PACKET_SIZE];
+    unsigned int length, gap;
+
+    uint64_t start    = CDisplayLatency::now();
+    uint64_t offset   = 0ULL;        // into the capture, ns
+    unsigned int count = 0U;
+
+    while (!m_killed && capture.read(buffer, sizeof(buffer), length, gap)) {
+        offset += gap * 1000ULL;
+
+        if (speed > 0.0) {
+            uint64_t due = start + uint64_t(offset / speed);
+
+            if (due > CDisplayLatency::now()) {
+                m_writer->flush();
+
+                struct timespec ts;
+                ts.tv_sec  = due / 1000000000ULL;
+                ts.tv_nsec = due % 1000000000ULL;
+                ::clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+
+                readSignals();
+            }
+        }
+
+        if (length > 0U) {
+            m_received = CDisplayLatency::now();
+            processPacket(buffer, length);
+        }
+
+        // Woken a batch at a time, like the network thread does
+        if ((++count % NETWORK_BATCH_SIZE) == 0U) {
+            m_writer->flush();
+            readSignals();
+        }
+    }
+
+    m_writer->flush();
+    m_writer->drain();
+
+    double secs = (CDisplayLatency::now() - start) / 1000000000.0;
 
-    CTimer pollTimer(1000U, 5U);
-    pollTimer.start();
+    LogMessage("Replayed %u datagrams in %.3f s, %.0f datagrams/s, %llu updates merged, %llu dropped, %llu bytes written to the display",
+               count, secs, secs > 0.0 ? count / secs : 0.0, m_writer->getMerged(), m_writer->getOverflows(), m_display->getWritten());
+
+    m_writer->stop();
+    delete m_writer;
+
+    m_latency.dump();
+
+    close();
+}
+
+// Everything run() and replay() share: the configuration, logging, the
+// display and the ID lookups
+bool CDisplayServer::open(bool nullDisplay)
+{
+    bool ret = m_conf.read();
+
+    if (!ret) {
+        ::fprintf(stderr, "DisplayServer: cannot read the .ini file\n");
+        return false;
+    }
+
+    ::LogInitialise(m_conf.getLogLevel(), m_conf.getSyslog());
 
     LogInfo("DisplayServer is free software; you can redistribute it and/or modify");
     LogInfo("it under the terms of the GNU General Public License as published by");
@@ -111,261 +339,451 @@ void CDisplayServer::run()
 
     LogMessage("Starting DisplayServer-%s git #%.10s", VERSION, gitversion);
 
+    // Before any thread is started, so that they all inherit the blocked signals
+    if (!openSignals()) {
+        ::LogFinalise();
+        return false;
+    }
+
     CTimer watchdogTimer(1000U, 0U, 1500U);
 
-    m_display = CDisplay::createDisplay(m_conf);
+    if (nullDisplay) {
+        m_display = new CNullDisplay;
+        m_display->open();
+        m_latency.setDriver("None");
+    } else {
+        m_display = CDisplay::createDisplay(m_conf);
+        m_latency.setDriver(m_conf.getDisplayServerType());
+    }
 
     std::string lookupFile  = m_conf.getDMRIdLookupFile();
     unsigned int reloadTime = m_conf.getDMRIdLookupTime();
-    bool m_debug            = m_conf.getDisplayServerDebug();
-    bool m_trace            = m_conf.getDisplayServerTrace();
+    unsigned int threads    = m_conf.getDMRIdLookupThreads();
+    std::string tgFile      = m_conf.getDMRIdLookupTalkgroupFile();
+    std::string filter      = m_conf.getDMRIdLookupFilter();
+    unsigned int maxEntries = m_conf.getDMRIdLookupMaxEntries();
+    bool lazy               = m_conf.getDMRIdLookupLazy();
+    m_debug                 = m_conf.getDisplayServerDebug();
+    m_trace                 = m_conf.getDisplayServerTrace();
 
     LogInfo("DMR Id Lookups");
     LogInfo("    File: %s", lookupFile.length() > 0U ? lookupFile.c_str() : "None");
+    LogInfo("    Talkgroup File: %s", tgFile.length() > 0U ? tgFile.c_str() : "None");
 
     if (reloadTime > 0U) {
         LogInfo("    Reload: %u hours", reloadTime);
     }
 
-    m_dmrLookup = new CDMRLookup(lookupFile, reloadTime);
-    m_dmrLookup->read();
+    if (threads > 1U) {
+        LogInfo("    Threads: %u", threads);
+    }
 
-    m_display->setIdle();
+    if (filter.length() > 0U) {
+        LogInfo("    Filter: %s", filter.c_str());
+    }
 
-    CDisplayNetwork network(m_conf.getDisplayServerAddress(), m_conf.getDisplayServerPort(), m_trace);
+    if (maxEntries > 0U) {
+        LogInfo("    Max Entries: %u", maxEntries);
+    }
 
-    ret = network.open();
+    if (lazy) {
+        LogInfo("    Lazy: yes");
+    }
 
-    if (!ret) {
-        ::LogFinalise();
-        return;
+    m_dmrLookup = new CDMRLookup(lookupFile, reloadTime, threads);
+    m_dmrLookup->setFilter(filter, maxEntries);
+    m_dmrLookup->setLazy(lazy);
+    m_dmrLookup->read();
+
+    if (tgFile.length() > 0U) {
+        m_tgLookup = new CDMRLookup(tgFile, reloadTime, 1U, true);
+        m_tgLookup->read();
     }
 
-    for (;;) {
-        char buffer[200U];
-        sockaddr_storage addr;
-        unsigned int addrLen;
+    m_display->setIdle();
 
-        unsigned int len = network.readData((unsigned char*)buffer, 200U, addr, addrLen);
+    return true;
+}
 
-        if (len > 0U) {
-            switch (buffer[0]) {
-                case 0x01U: // idle
-                    m_display->setIdle();
+void CDisplayServer::close()
+{
+    m_display->close();
+    delete m_display;
 
-                    if (m_debug) {
-                        LogMessage(".... setIdle");
-                    }
+    if (m_dmrLookup != NULL) {
+        m_dmrLookup->stop();
+    }
 
-                    break;
+    if (m_tgLookup != NULL) {
+        m_tgLookup->stop();
+    }
 
-                case 0x02U: { // error
-                    unsigned int count = buffer[1U];
+    ::close(m_signalFd);
 
-                    char text[count];
-                    text[0] = 0U;
+    ::LogFinalise();
+}
 
-                    for (uint8_t i = 0U; i < count; i++) {
-                        text[i] = buffer[2 + i];
-                    }
+bool CDisplayServer::readable(int fd)
+{
+    if (fd == m_signalFd) {
+        readSignals();
+    } else {
+        readNetwork();
+    }
 
-                    text[count] = 0U;
+    return true;
+}
 
-                    m_display->setError(text);
+// SIGUSR1 dumps the latency histograms, SIGINT and SIGTERM stop the server
+// so that they're dumped at shutdown too
+bool CDisplayServer::openSignals()
+{
+    sigset_t mask;
+    ::sigemptyset(&mask);
+    ::sigaddset(&mask, SIGUSR1);
+    ::sigaddset(&mask, SIGINT);
+    ::sigaddset(&mask, SIGTERM);
+
+    if (::pthread_sigmask(SIG_BLOCK, &mask, NULL) != 0) {
+        LogError("Cannot block the signals");
+        return false;
+    }
 
-                    if (m_debug) {
-                        LogMessage(".... setError text %s", text);
-                    }
-                }
-                break;
+    m_signalFd = ::signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+    if (m_signalFd < 0) {
+        LogError("Cannot create the signalfd, err: %d", errno);
+        return false;
+    }
 
-                case 0x03U: // quit
-                    m_display->setQuit();
+    return true;
+}
 
-                    if (m_debug) {
-                        LogMessage(".... setQuit");
-                    }
+void CDisplayServer::readSignals()
+{
+    struct signalfd_siginfo info;
+
+    while (::read(m_signalFd, &info, sizeof(info)) == sizeof(info)) {
+        if (info.ssi_signo == SIGUSR1) {
+            m_latency.dump();
+        } else {
+            LogMessage("DisplayServer-%s is exiting on receipt of %s", VERSION, info.ssi_signo == SIGINT ? "SIGINT" : "SIGTERM");
+            m_killed = true;
+        }
+    }
+}
 
-                    break;
+void CDisplayServer::readNetwork()
+{
+    CStopWatch latency;
+    latency.start();
 
-                case 0x04U: { // write dmr
-                    unsigned int slotNo = buffer[1];
+    for (;;) {
+        unsigned int count = m_network->readBatch();
 
-                    unsigned int srcId = (buffer[2] << 24) | ((buffer[3] & 0xFF) << 16) | ((buffer[4] & 0xFF) << 8) | (buffer[5] & 0xFF);
-                    std::string src = m_dmrLookup->find(srcId);
+        for (unsigned int i = 0U; i < count; i++) {
+            unsigned int len;
+            const unsigned char* buffer = m_network->getPacket(i, len);
 
-                    bool group = buffer[6] != 0;
+            if (len > 0U) {
+                m_received = m_network->getTimestamp(i);
+                processPacket(buffer, len);
+            }
 
-                    unsigned int dstId = (buffer[7] << 24) | ((buffer[8] & 0xFF) << 16) | ((buffer[9] & 0xFF) << 8) | (buffer[10] & 0xFF);
-                    std::string dst = m_dmrLookup->find(dstId);
+            // Time from the wakeup until the update has been queued
+            unsigned int us = latency.elapsedUS();
+            m_statsLatency += us;
+            if (us > m_statsLatencyMax) {
+                m_statsLatencyMax = us;
+            }
 
-                    char type[2U];
-                    type[0] = buffer[11];
-                    type[1] = 0U;
+            m_statsPackets++;
+        }
 
-                    m_display->writeDMR(slotNo, src, group, dst, type);
+        // A short batch means the socket queue is empty
+        if (count < NETWORK_BATCH_SIZE) {
+            break;
+        }
+    }
 
-                    if (m_debug) {
-                        LogMessage(".... writeDMR src %s dst %s group %d type %s", src.c_str(), dst.c_str(), group, type);
-                    }
-                }
-                break;
+    m_writer->flush();
+}
 
-                case 0x05U: { // dmr rssi
-                    unsigned int slotNo = buffer[1U];
-                    unsigned int rssi = buffer[2U];
+// The event crosses to the writer thread, so this is the one copy the text makes
+static void copyText(char* text, unsigned int size, const CDisplayMessage& message)
+{
+    unsigned int count = message.m_textLength;
+    if (count > size - 1U) {
+        count = size - 1U;
+    }
 
-                    m_display->writeDMRRSSI(slotNo, rssi);
+    if (count > 0U) {
+        ::memcpy(text, message.m_text, count);
+    }
+    text[count] = 0;
+}
 
-                    if (m_debug) {
-                        LogMessage(".... writeDMRRSSI slotNo %u rssi %u", slotNo, rssi);
-                    }
-                }
-                break;
+void CDisplayServer::processPacket(const unsigned char* buffer, unsigned int len)
+{
+    if (buffer[0U] == DISPLAY_FRAME) {
+        processFrame(buffer, len);
+    } else {
+        processMessage(buffer, len);
+    }
+}
 
-                case 0x06U: { // dmr ta
-                    unsigned int slotNo = buffer[1U];
+void CDisplayServer::processFrame(const unsigned char* buffer, unsigned int len)
+{
+    CDisplayFrame frame;
+    if (!m_decoder.decodeFrame(buffer, len, frame)) {
+        if (m_debug) {
+            LogMessage(".... dropped invalid frame, %u bytes", len);
+        }
+        return;
+    }
 
-                    char type[2U];
-                    type[0] = buffer[2U];
-                    type[1] = 0U;
+    if (!m_decoder.checkSequence(frame.m_sequence)) {
+        if (m_debug) {
+            LogMessage(".... dropped duplicate frame, sequence %u", frame.m_sequence);
+        }
+        return;
+    }
 
-                    unsigned int count = buffer[3U];
+    const unsigned char* data;
+    unsigned int length;
+    while (frame.next(data, length)) {
+        processMessage(data, length);
+    }
+}
 
-                    unsigned char talkerAlias[count];
-                    talkerAlias[0] = 0U;
+void CDisplayServer::processMessage(const unsigned char* buffer, unsigned int len)
+{
+    CDisplayMessage message;
+    if (!m_decoder.decode(buffer, len, message)) {
+        if (m_debug) {
+            LogMessage(".... dropped invalid packet, opcode 0x%02X, %u bytes", len > 0U ? buffer[0U] : 0U, len);
+        }
+        return;
+    }
 
-                    for (uint8_t i = 0U; i < count; i++) {
-                        talkerAlias[i] = buffer[4 + i];
-                    }
+    uint64_t decoded = CDisplayLatency::now();
+    m_latency.add(LS_DECODE, message.m_type, m_received, decoded);
 
-                    talkerAlias[count] = 0U;
+    // When the event is ready to be queued, after any lookups
+    uint64_t ready = decoded;
 
-                    m_display->writeDMRTA(slotNo, talkerAlias, type);
+    // do nothing here for now
+    //m_display->close();
+    if (message.m_type == DISPLAY_CLOSE) {
+        return;
+    }
 
-                    if (m_debug) {
-                        LogMessage(".... writeDMRTA slotNo %u type %s ta %s", slotNo, type, talkerAlias);
-                    }
-                }
-                break;
+    CDisplayEvent event;
+    event.m_type       = message.m_type;
+    event.m_slotNo     = message.m_slotNo;
+    event.m_group      = message.m_group;
+    event.m_rssi       = message.m_rssi;
+    event.m_ber        = message.m_ber;
+    event.m_ric        = message.m_ric;
+    event.m_dmrType[0] = message.m_dmrType;
+
+    switch (message.m_type) {
+        case DISPLAY_ERROR:
+        case DISPLAY_DMR_TA:
+        case DISPLAY_POCSAG:
+            copyText(event.m_text, DISPLAY_EVENT_TEXT_LENGTH, message);
+            break;
+
+        case DISPLAY_DMR: {
+            m_dmrLookup->findUser(message.m_srcId, event.m_src);
+
+            const char* dst = message.m_group && m_tgLookup != NULL ? m_tgLookup->find(message.m_dstId) : m_dmrLookup->find(message.m_dstId);
+            ::snprintf(event.m_dst, DISPLAY_EVENT_CALLSIGN_LENGTH, "%s", dst);
+
+            ready = CDisplayLatency::now();
+            m_latency.add(LS_LOOKUP, message.m_type, decoded, ready);
+        }
+        break;
 
-                case 0x07U: { // dmr ber
-                    unsigned int slotNo = buffer[1U];
+        default:
+            break;
+    }
 
-                    unsigned int count = buffer[2U];
+    event.m_received = m_received;
+    event.m_queued   = CDisplayLatency::now();
+    m_latency.add(LS_QUEUE, message.m_type, ready, event.m_queued);
 
-                    char _ber[count];
-                    _ber[0] = 0U;
+    // Only this thread adds to the queue, so once there's room it stays
+    while (m_backpressure && m_writer->getQueueDepth() >= DISPLAY_QUEUE_SIZE) {
+        m_writer->flush();
+        CThread::sleep(1U);
+    }
 
-                    for (uint8_t i = 0U; i < count; i++) {
-                        _ber[i] = buffer[3 + i];
-                    }
+    if (!m_writer->write(event) && m_debug) {
+        LogMessage(".... display queue full, dropped opcode 0x%02X", event.m_type);
+    }
+}
 
-                    _ber[count] = 0U;
+void CDisplayServer::writeStats()
+{
+    unsigned long long wakeups = m_reactor.getWakeups();
+    unsigned long long batches = m_network->getBatches();
+    unsigned int secs          = m_statsWatch.elapsed() / 1000U;
+
+    if (m_debug && secs > 0U) {
+        LogMessage(".... loop %llu wakeups in %us (%.1f/s), %u packets, latency avg %uus max %uus",
+                   wakeups - m_statsWakeups, secs, float(wakeups - m_statsWakeups) / float(secs), m_statsPackets,
+                   m_statsPackets > 0U ? (unsigned int)(m_statsLatency / m_statsPackets) : 0U, m_statsLatencyMax);
+        LogMessage(".... network %llu batches, %.1f packets/batch, largest batch %u",
+                   batches - m_statsBatches, batches > m_statsBatches ? float(m_statsPackets) / float(batches - m_statsBatches) : 0.0F,
+                   m_network->getMaxBatch());
+        LogMessage(".... lookup cache %llu hits, %llu misses", m_dmrLookup->getCacheHits(), m_dmrLookup->getCacheMisses());
+        if (m_tgLookup != NULL) {
+            LogMessage(".... talkgroup cache %llu hits, %llu misses", m_tgLookup->getCacheHits(), m_tgLookup->getCacheMisses());
+        }
+        LogMessage(".... decoder %llu invalid packets, %llu frames, %llu lost, %llu reordered, %llu duplicates, %llu resyncs",
+                   m_decoder.getErrors(), m_decoder.getFrames(), m_decoder.getLost(), m_decoder.getReordered(), m_decoder.getDuplicates(), m_decoder.getResyncs());
+        LogMessage(".... display queue depth %u, max depth %u, %llu overflows, %llu merged",
+                   m_writer->getQueueDepth(), m_writer->getMaxQueueDepth(), m_writer->getOverflows(), m_writer->getMerged());
+        LogMessage(".... display %llu bytes written, %llu write stalls", m_display->getWritten(), m_writer->getStalls());
+    }
 
-                    float ber = atof(_ber);
-                    m_display->writeDMRBER(slotNo, ber);
+    m_statsWatch.start();
+    m_statsWakeups    = wakeups;
+    m_statsBatches    = batches;
+    m_statsPackets    = 0U;
+    m_statsLatency    = 0ULL;
+    m_statsLatencyMax = 0U;
+}
 
-                    if (m_debug) {
-                        LogMessage(".... writeDMRBER slotNo %u %f", slotNo, ber);
-                    }
-                }
-                break;
+void CDisplayServer::writeMetrics(std::string& text)
+{
+    char labels[100U];
 
-                case 0x08U: { // clear dmr
-                    unsigned int slotNo = buffer[1U];
-                    m_display->clearDMR(slotNo);
+    CMetricsServer::addHeader(text, "displayserver_packets_total", "counter", "Display updates decoded, by opcode");
+    for (unsigned int type = 1U; type < DISPLAY_OPCODE_COUNT; type++) {
+        ::snprintf(labels, sizeof(labels), "opcode=\"%s\"", CDisplayLatency::getOpcodeName(type));
+        CMetricsServer::addValue(text, "displayserver_packets_total", labels, m_decoder.getDecoded(type));
+    }
 
-                    if (m_debug) {
-                        LogMessage(".... clearDMR slotNo %u", slotNo);
-                    }
-                }
-                break;
+    CMetricsServer::addHeader(text, "displayserver_decode_errors_total", "counter", "Datagrams and updates that could not be decoded");
+    CMetricsServer::addValue(text, "displayserver_decode_errors_total", NULL, m_decoder.getErrors());
 
-                case 0x09U: { // write pocsag
-                    uint32_t ric = (buffer[1] << 24) | ((buffer[2] & 0xFF) << 16) | ((buffer[3] & 0xFF) << 8) | (buffer[4] & 0xFF);
+    CMetricsServer::addHeader(text, "displayserver_frames_total", "counter", "Protocol v2 frames received");
+    CMetricsServer::addValue(text, "displayserver_frames_total", NULL, m_decoder.getFrames());
 
-                    unsigned int count = buffer[5U];
+    CMetricsServer::addHeader(text, "displayserver_frames_lost_total", "counter", "Protocol v2 frames missing from the sequence");
+    CMetricsServer::addValue(text, "displayserver_frames_lost_total", NULL, m_decoder.getLost());
 
-                    char buf[count];
-                    buf[0] = 0U;
+    CMetricsServer::addHeader(text, "displayserver_frames_resyncs_total", "counter", "Protocol v2 sequence jumps taken as a sender restart");
+    CMetricsServer::addValue(text, "displayserver_frames_resyncs_total", NULL, m_decoder.getResyncs());
 
-                    for (uint8_t i = 0U; i < count; i++) {
-                        buf[i] = buffer[6 + i];
-                    }
+    CMetricsServer::addHeader(text, "displayserver_network_batches_total", "counter", "recvmmsg() batches read");
+    CMetricsServer::addValue(text, "displayserver_network_batches_total", NULL, m_network->getBatches());
 
-                    buf[count] = 0U;
+    CMetricsServer::addHeader(text, "displayserver_loop_wakeups_total", "counter", "Network loop wakeups");
+    CMetricsServer::addValue(text, "displayserver_loop_wakeups_total", NULL, m_reactor.getWakeups());
 
-                    std::string message(buf, count);
+    CDMRLookup* lookups[] = { m_dmrLookup, m_tgLookup };
+    const char* tables[]  = { "table=\"id\"", "table=\"talkgroup\"" };
 
-                    m_display->writePOCSAG(ric, message.c_str());
+    CMetricsServer::addHeader(text, "displayserver_lookup_hits_total", "counter", "Lookups answered by the cache");
+    for (unsigned int i = 0U; i < 2U; i++) {
+        if (lookups[i] != NULL) {
+            CMetricsServer::addValue(text, "displayserver_lookup_hits_total", tables[i], lookups[i]->getCacheHits());
+        }
+    }
 
-                    if (m_debug) {
-                        LogMessage(".... writePOCSSAG ric %u message %s", ric, message.c_str());
-                    }
-                }
-                break;
+    CMetricsServer::addHeader(text, "displayserver_lookup_misses_total", "counter", "Lookups that went to the table");
+    for (unsigned int i = 0U; i < 2U; i++) {
+        if (lookups[i] != NULL) {
+            CMetricsServer::addValue(text, "displayserver_lookup_misses_total", tables[i], lookups[i]->getCacheMisses());
+        }
+    }
+
+    CMetricsServer::addHeader(text, "displayserver_table_entries", "gauge", "IDs in the lookup table");
+    for (unsigned int i = 0U; i < 2U; i++) {
+        if (lookups[i] != NULL) {
+            CMetricsServer::addValue(text, "displayserver_table_entries", tables[i], (unsigned long long)lookups[i]->getSize());
+        }
+    }
 
-                case 0x0AU: // clear pocsag
-                    m_display->clearPOCSAG();
+    CMetricsServer::addHeader(text, "displayserver_table_bytes", "gauge", "Memory used by the lookup table");
+    for (unsigned int i = 0U; i < 2U; i++) {
+        if (lookups[i] != NULL) {
+            CMetricsServer::addValue(text, "displayserver_table_bytes", tables[i], (unsigned long long)lookups[i]->getMemory());
+        }
+    }
 
-                    if (m_debug) {
-                        LogMessage(".... clearPOCSAG");
-                    }
+    CMetricsServer::addHeader(text, "displayserver_table_load_seconds", "gauge", "How long the last load or reload of the table took");
+    for (unsigned int i = 0U; i < 2U; i++) {
+        if (lookups[i] != NULL) {
+            CMetricsServer::addValue(text, "displayserver_table_load_seconds", tables[i], lookups[i]->getLoadTime() / 1000.0);
+        }
+    }
 
-                    break;
+    CMetricsServer::addHeader(text, "displayserver_queue_depth", "gauge", "Updates waiting for the display writer");
+    CMetricsServer::addValue(text, "displayserver_queue_depth", NULL, (unsigned long long)m_writer->getQueueDepth());
 
-                case 0x0BU: // write cw
-                    m_display->writeCW();
+    CMetricsServer::addHeader(text, "displayserver_queue_max_depth", "gauge", "Most updates that have waited for the display writer");
+    CMetricsServer::addValue(text, "displayserver_queue_max_depth", NULL, (unsigned long long)m_writer->getMaxQueueDepth());
 
-                    if (m_debug) {
-                        LogMessage(".... writeCW");
-                    }
+    CMetricsServer::addHeader(text, "displayserver_queue_overflows_total", "counter", "Updates dropped with the queue full");
+    CMetricsServer::addValue(text, "displayserver_queue_overflows_total", NULL, m_writer->getOverflows());
 
-                    break;
+    CMetricsServer::addHeader(text, "displayserver_updates_merged_total", "counter", "Updates superseded before they were written");
+    CMetricsServer::addValue(text, "displayserver_updates_merged_total", NULL, m_writer->getMerged());
 
-                case 0x0CU: // clear cw
-                    if (m_debug) {
-                        LogMessage(".... clearCW");
-                    }
+    ::snprintf(labels, sizeof(labels), "driver=\"%s\"", m_latency.getDriver().c_str());
 
-                    m_display->setIdle();
-                    break;
+    CMetricsServer::addHeader(text, "displayserver_display_written_bytes_total", "counter", "Bytes sent to the display");
+    CMetricsServer::addValue(text, "displayserver_display_written_bytes_total", labels, m_display->getWritten());
 
-                case 0x0DU: // close
-                    // do nothing here for now
-                    //m_display->close();
-                    break;
+    CMetricsServer::addHeader(text, "displayserver_display_write_stalls_total", "counter", "Display updates that took over 500 ms to write");
+    CMetricsServer::addValue(text, "displayserver_display_write_stalls_total", labels, m_writer->getStalls());
 
-                default:
-                    break;
-            }
-        }
+    writeLatencyMetrics(text, LS_WRITE);
+    writeLatencyMetrics(text, LS_TOTAL);
+}
 
-        unsigned int ms = stopWatch.elapsed();
-        stopWatch.start();
+// As a Prometheus histogram in seconds, leaving out opcodes that have no samples
+void CDisplayServer::writeLatencyMetrics(std::string& text, LATENCY_STAGE stage)
+{
+    char name[100U];
+    char help[100U];
+    ::snprintf(name, sizeof(name), "displayserver_latency_%s_seconds", CDisplayLatency::getStageName(stage));
+    ::snprintf(help, sizeof(help), "Display update latency, %s stage", CDisplayLatency::getStageName(stage));
 
-        m_display->clock(ms);
+    CMetricsServer::addHeader(text, name, "histogram", help);
 
-        pollTimer.clock(ms);
+    std::string bucket = std::string(name) + "_bucket";
+    std::string sum    = std::string(name) + "_sum";
+    std::string count  = std::string(name) + "_count";
 
-        if (pollTimer.hasExpired()) {
-            pollTimer.start();
-        }
+    for (unsigned int opcode = 1U; opcode < LATENCY_OPCODES; opcode++) {
+        const CLatencyHistogram& histogram = m_latency.get(stage, opcode);
 
-        if (ms < 5U) {
-            CThread::sleep(5U);
+        unsigned long long total = histogram.getCount();
+        if (total == 0ULL) {
+            continue;
         }
-    }
 
-    m_display->close();
-    delete m_display;
+        const char* opcodeName = CDisplayLatency::getOpcodeName(opcode);
+        char labels[100U];
 
-    if (m_dmrLookup != NULL) {
-        m_dmrLookup->stop();
-    }
+        unsigned long long seen = 0ULL;
+        for (unsigned int n = 0U; n < LATENCY_BUCKETS - 1U; n++) {
+            seen += histogram.getBucket(n);
+            ::snprintf(labels, sizeof(labels), "opcode=\"%s\",le=\"%g\"", opcodeName, CLatencyHistogram::getLimit(n) / 1000000.0);
+            CMetricsServer::addValue(text, bucket.c_str(), labels, seen);
+        }
 
-    network.close();
+        // The buckets are read one at a time, so +Inf is their sum rather than total
+        seen += histogram.getBucket(LATENCY_BUCKETS - 1U);
+        ::snprintf(labels, sizeof(labels), "opcode=\"%s\",le=\"+Inf\"", opcodeName);
+        CMetricsServer::addValue(text, bucket.c_str(), labels, seen);
 
-    ::LogFinalise();
+        ::snprintf(labels, sizeof(labels), "opcode=\"%s\"", opcodeName);
+        CMetricsServer::addValue(text, sum.c_str(), labels, histogram.getSum() / 1000000.0);
+        CMetricsServer::addValue(text, count.c_str(), labels, seen);
+    }
 }
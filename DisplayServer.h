@@ -19,8 +19,16 @@
 #pragma once
 
 #include "Conf.h"
+#include "DisplayCapture.h"
 #include "DMRLookup.h"
 #include "Display.h"
+#include "DisplayDecoder.h"
+#include "DisplayLatency.h"
+#include "DisplayNetwork.h"
+#include "DisplayWriter.h"
+#include "MetricsServer.h"
+#include "Reactor.h"
+#include "StopWatch.h"
 #include "Timer.h"
 
 #include <arpa/inet.h>
@@ -35,17 +43,55 @@
 #include <string>
 #include <vector>
 
-class CDisplayServer {
+class CDisplayServer : public IReactorHandler, public IMetricsSource {
   public:
     CDisplayServer(const std::string& file);
-    ~CDisplayServer();
+    virtual ~CDisplayServer();
 
     void run();
 
+    // Plays a capture made with CaptureFile= through the display, see run()
+    void replay(const std::string& filename, double speed, bool nullDisplay);
+
+    virtual bool readable(int fd) override;
+
+    // On the metrics thread
+    virtual void writeMetrics(std::string& text) override;
+
   private:
-    CConf           m_conf;
-    CDisplay*       m_display;
-    CDMRLookup*     m_dmrLookup;
-    bool            m_debug;
-    bool            m_trace;
+    CConf            m_conf;
+    CDisplay*        m_display;
+    CDMRLookup*      m_dmrLookup;
+    CDMRLookup*      m_tgLookup;        // NULL without a talkgroup file
+    CDisplayNetwork* m_network;
+    CDisplayDecoder  m_decoder;
+    CDisplayWriter*  m_writer;
+    CMetricsServer*  m_metrics;         // NULL unless enabled
+    CReactor         m_reactor;
+    bool             m_debug;
+    bool             m_trace;
+    CDisplayLatency  m_latency;
+    uint64_t         m_received;        // when the packet being processed arrived
+    int              m_signalFd;
+    bool             m_killed;
+    bool             m_backpressure;    // wait for a full display queue rather than drop
+    CDisplayCapture  m_capture;
+
+    CStopWatch         m_statsWatch;
+    unsigned long long m_statsWakeups;
+    unsigned long long m_statsBatches;
+    unsigned int       m_statsPackets;
+    unsigned long long m_statsLatency;
+    unsigned int       m_statsLatencyMax;
+
+    bool open(bool nullDisplay);
+    void close();
+    bool openSignals();
+    void readSignals();
+    void readNetwork();
+    void processPacket(const unsigned char* buffer, unsigned int len);
+    void processFrame(const unsigned char* buffer, unsigned int len);
+    void processMessage(const unsigned char* buffer, unsigned int len);
+    void writeStats();
+    void writeLatencyMetrics(std::string& text, LATENCY_STAGE stage);
 };
@@ -0,0 +1,846 @@
+/*
+ *   Copyright (C) 2026 by BrandMeister
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+// Synthetic MMDVMHost display traffic, sent over UDP to a DisplayServer to
+// stress its ingest, ID lookups and display drivers without a modem.
+
+#include "DisplayEncoder.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <random>
+
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <netdb.h>
+#include <unistd.h>
+
+const uint64_t NS_PER_SECOND = 1000000000ULL;
+
+// The cadences of MMDVMHost's updates during a DMR call
+const uint64_t RSSI_INTERVAL = 360000000ULL;	// once per voice superframe
+const uint64_t BER_INTERVAL  = 60000000ULL;	// once per voice burst
+const uint64_t TA_INTERVAL   = 360000000ULL;	// one talker alias block per superframe
+
+// Characters of talker alias carried per block, the alias grows by this much per update
+const unsigned int TA_BLOCK_LENGTH = 7U;
+
+// MMDVMHost goes idle after the mode hang following the last call
+const uint64_t IDLE_HANG = 3000000000ULL;
+
+const uint64_t POCSAG_INTERVAL = 150000000ULL;	// between the pages of a burst
+const uint64_t CW_LENGTH       = 4000000000ULL;	// of a CW ident
+
+const uint32_t TALKGROUPS[] = {91U, 92U, 93U, 9U, 8U, 2620U, 2621U, 3100U, 2350U, 2080U, 2220U, 9990U};
+const char* PREFIXES[]      = {"DL", "DO", "G", "M0", "F4", "IZ", "K", "W", "N", "VK", "JA", "PA", "ON", "OE", "HB9", "SP", "EA"};
+const char* NAMES[]         = {"Hans", "Peter", "John", "Marie", "Luca", "Bob", "Anna", "Jan", "Pierre", "Mike", "Kenji", "Sofia"};
+const char* PAGES[]         = {"Test page", "Sked 20:00 local on TG 2620", "Repeater DB0ABC back on air", "Wx: 12C wind NW 15 km/h", "QSY 145.500"};
+
+enum TRAFFIC_MODE {
+	TM_REALISTIC,
+	TM_ADVERSARIAL,
+	TM_FLOOD
+};
+
+static volatile sig_atomic_t killed = 0;
+
+static void sigHandler(int)
+{
+	killed = 1;
+}
+
+static uint64_t now()
+{
+	struct timespec ts;
+	::clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return uint64_t(ts.tv_sec) * NS_PER_SECOND + ts.tv_nsec;
+}
+
+static void sleepUntil(uint64_t time)
+{
+	struct timespec ts;
+	ts.tv_sec  = time / NS_PER_SECOND;
+	ts.tv_nsec = time % NS_PER_SECOND;
+
+	// Interrupted by a signal the caller finds killed set
+	::clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+}
+
+// Sends each update as a v1 datagram of its own or, with frames, collects
+// them into protocol v2 frames sent on flush() or when full.
+class CTrafficSender {
+public:
+	CTrafficSender(bool frames) :
+	m_fd(-1),
+	m_frames(frames),
+	m_encoder(m_buffer, sizeof(m_buffer)),
+	m_begun(false),
+	m_datagrams(0ULL),
+	m_updates(0ULL),
+	m_bytes(0ULL),
+	m_errors(0ULL)
+	{
+	}
+
+	~CTrafficSender()
+	{
+		if (m_fd != -1)
+			::close(m_fd);
+	}
+
+	bool open(const char* address, unsigned short port)
+	{
+		struct addrinfo hints;
+		::memset(&hints, 0, sizeof(hints));
+		hints.ai_family   = AF_UNSPEC;
+		hints.ai_socktype = SOCK_DGRAM;
+
+		char service[8U];
+		::snprintf(service, sizeof(service), "%u", port);
+
+		struct addrinfo* res = NULL;
+		int err = ::getaddrinfo(address, service, &hints, &res);
+		if (err != 0) {
+			::fprintf(stderr, "Cannot resolve %s: %s\n", address, ::gai_strerror(err));
+			return false;
+		}
+
+		m_fd = ::socket(res->ai_family, SOCK_DGRAM, 0);
+		if (m_fd == -1 || ::connect(m_fd, res->ai_addr, res->ai_addrlen) == -1) {
+			::fprintf(stderr, "Cannot open a socket to %s:%u: %s\n", address, port, ::strerror(errno));
+			::freeaddrinfo(res);
+			return false;
+		}
+
+		::freeaddrinfo(res);
+		return true;
+	}
+
+	bool isFrames() const
+	{
+		return m_frames;
+	}
+
+	// write is called with the encoder to add one update
+	template <typename F> void add(F write)
+	{
+		m_updates++;
+
+		if (!m_frames) {
+			m_encoder.begin();
+			write(m_encoder);
+
+			// A frame of one update holds the v1 datagram after the header and the length byte
+			unsigned int length = m_encoder.end();
+			if (length > 0U)
+				sendRaw(m_buffer + DISPLAY_FRAME_HEADER_LENGTH + 1U, length - DISPLAY_FRAME_HEADER_LENGTH - 1U);
+			return;
+		}
+
+		if (!m_begun) {
+			m_encoder.begin();
+			m_begun = true;
+		}
+
+		if (!write(m_encoder)) {
+			flush();
+			m_encoder.begin();
+			m_begun = true;
+			write(m_encoder);
+		}
+	}
+
+	void flush()
+	{
+		if (!m_begun)
+			return;
+
+		m_begun = false;
+
+		unsigned int length = m_encoder.end();
+		if (length > 0U)
+			sendRaw(m_buffer, length);
+	}
+
+	void sendRaw(const unsigned char* data, unsigned int length)
+	{
+		// Refused while nothing listens on the port, which is counted rather than fatal
+		if (::send(m_fd, data, length, 0) == -1) {
+			m_errors++;
+			return;
+		}
+
+		m_datagrams++;
+		m_bytes += length;
+	}
+
+	unsigned long long getDatagrams() const { return m_datagrams; }
+	unsigned long long getUpdates() const   { return m_updates; }
+	unsigned long long getBytes() const     { return m_bytes; }
+	unsigned long long getErrors() const    { return m_errors; }
+
+private:
+	int                m_fd;
+	bool               m_frames;
+	unsigned char      m_buffer[DISPLAY_FRAME_MAX_LENGTH];
+	CDisplayEncoder    m_encoder;
+	bool               m_begun;
+	unsigned long long m_datagrams;
+	unsigned long long m_updates;
+	unsigned long long m_bytes;
+	unsigned long long m_errors;
+};
+
+// A DMR call in progress on one slot, or the time the next one starts
+struct CCall {
+	bool         m_active;
+	char         m_type;
+	uint32_t     m_srcId;
+	bool         m_group;
+	uint32_t     m_dstId;
+	std::string  m_alias;
+	unsigned int m_aliasSent;
+	uint64_t     m_start;
+	uint64_t     m_end;
+	uint64_t     m_nextRSSI;
+	uint64_t     m_nextBER;
+	uint64_t     m_nextTA;
+	unsigned int m_rssi;
+	float        m_ber;
+};
+
+class CTrafficGen {
+public:
+	CTrafficGen(CTrafficSender& sender, unsigned int seed) :
+	m_sender(sender),
+	m_random(seed),
+	m_ids(),
+	m_callRate(2.0),
+	m_callLength(8.0),
+	m_pocsagRate(0.5),
+	m_cwInterval(600U),
+	m_sequence(0U)
+	{
+	}
+
+	void setCalls(double perMinute, double length)
+	{
+		m_callRate   = perMinute;
+		m_callLength = length;
+	}
+
+	void setPOCSAG(double perMinute)
+	{
+		m_pocsagRate = perMinute;
+	}
+
+	void setCW(unsigned int interval)
+	{
+		m_cwInterval = interval;
+	}
+
+	bool readIds(const char* filename)
+	{
+		FILE* fp = ::fopen(filename, "r");
+		if (fp == NULL) {
+			::fprintf(stderr, "Cannot open the ID file %s: %s\n", filename, ::strerror(errno));
+			return false;
+		}
+
+		// The first column of an ID CSV, the header and comments have no leading digit
+		char line[256U];
+		while (::fgets(line, sizeof(line), fp) != NULL) {
+			if (line[0U] >= '0' && line[0U] <= '9')
+				m_ids.push_back(uint32_t(::strtoul(line, NULL, 10)));
+		}
+
+		::fclose(fp);
+
+		if (m_ids.empty()) {
+			::fprintf(stderr, "No IDs found in %s\n", filename);
+			return false;
+		}
+
+		return true;
+	}
+
+	void runRealistic(uint64_t duration);
+	void runAdversarial(uint64_t duration, unsigned int rate);
+	void runFlood(uint64_t duration, unsigned int rate);
+
+private:
+	CTrafficSender&           m_sender;
+	std::mt19937              m_random;
+	std::vector<uint32_t>     m_ids;
+	double                    m_callRate;
+	double                    m_callLength;
+	double                    m_pocsagRate;
+	unsigned int              m_cwInterval;
+	uint16_t                  m_sequence;
+
+	unsigned int random(unsigned int n)
+	{
+		return std::uniform_int_distribution<unsigned int>(0U, n - 1U)(m_random);
+	}
+
+	// The time to the next event of a Poisson process, perMinute of them a minute
+	uint64_t interval(double perMinute)
+	{
+		return uint64_t(std::exponential_distribution<double>(perMinute / 60.0)(m_random) * NS_PER_SECOND);
+	}
+
+	uint32_t getId()
+	{
+		if (!m_ids.empty())
+			return m_ids[random(m_ids.size())];
+
+		// A country prefix followed by four digits, like the IDs radioid.net hands out
+		static const uint32_t COUNTRIES[] = {262U, 263U, 234U, 235U, 208U, 222U, 310U, 311U, 312U, 313U, 505U, 440U, 204U, 206U, 232U, 228U, 260U, 214U};
+		return COUNTRIES[random(sizeof(COUNTRIES) / sizeof(COUNTRIES[0U]))] * 10000U + random(10000U);
+	}
+
+	std::string getAlias()
+	{
+		std::string alias = PREFIXES[random(sizeof(PREFIXES) / sizeof(PREFIXES[0U]))];
+		alias += char('0' + random(10U));
+		for (unsigned int i = 0U; i < 2U + random(2U); i++)
+			alias += char('A' + random(26U));
+		alias += ' ';
+		alias += NAMES[random(sizeof(NAMES) / sizeof(NAMES[0U]))];
+
+		return alias;
+	}
+
+	void startCall(unsigned int slotNo, CCall& call, uint64_t time);
+	void updateCall(unsigned int slotNo, CCall& call, uint64_t time);
+	void addFlood(unsigned int n);
+	void sendAdversarial();
+};
+
+void CTrafficGen::startCall(unsigned int slotNo, CCall& call, uint64_t time)
+{
+	call.m_active    = true;
+	call.m_type      = random(10U) < 4U ? 'R' : 'N';
+	call.m_srcId     = getId();
+	call.m_group     = random(10U) != 0U;
+	call.m_dstId     = call.m_group ? TALKGROUPS[random(sizeof(TALKGROUPS) / sizeof(TALKGROUPS[0U]))] : getId();
+	call.m_alias     = getAlias();
+	call.m_aliasSent = 0U;
+	call.m_rssi      = 60U + random(50U);
+	call.m_ber       = 0.0F;
+
+	// Kerchunks of under a second up to long overs, about m_callLength on average
+	uint64_t length = uint64_t(std::exponential_distribution<double>(1.0 / m_callLength)(m_random) * NS_PER_SECOND);
+	if (length < NS_PER_SECOND / 2U)
+		length = NS_PER_SECOND / 2U;
+	if (length > 180U * NS_PER_SECOND)
+		length = 180U * NS_PER_SECOND;
+
+	call.m_end      = time + length;
+	call.m_nextRSSI = time + RSSI_INTERVAL;
+	call.m_nextBER  = time + BER_INTERVAL;
+	call.m_nextTA   = time + TA_INTERVAL;
+
+	m_sender.add([&](CDisplayEncoder& encoder) {
+		return encoder.writeDMR(slotNo, call.m_srcId, call.m_group, call.m_dstId, call.m_type);
+	});
+}
+
+void CTrafficGen::updateCall(unsigned int slotNo, CCall& call, uint64_t time)
+{
+	if (time >= call.m_nextTA && call.m_aliasSent < call.m_alias.size()) {
+		call.m_aliasSent += TA_BLOCK_LENGTH;
+		std::string alias = call.m_alias.substr(0U, call.m_aliasSent);
+
+		m_sender.add([&](CDisplayEncoder& encoder) {
+			return encoder.writeDMRTA(slotNo, call.m_type, alias.c_str());
+		});
+
+		call.m_nextTA += TA_INTERVAL;
+	}
+
+	// Only RF calls carry a signal strength
+	if (time >= call.m_nextRSSI) {
+		if (call.m_type == 'R') {
+			call.m_rssi += random(7U);
+			call.m_rssi -= 3U;
+			if (call.m_rssi < 45U || call.m_rssi > 125U)
+				call.m_rssi = 80U;
+
+			m_sender.add([&](CDisplayEncoder& encoder) {
+				return encoder.writeDMRRSSI(slotNo, call.m_rssi);
+			});
+		}
+
+		call.m_nextRSSI += RSSI_INTERVAL;
+	}
+
+	if (time >= call.m_nextBER) {
+		call.m_ber += (float(random(21U)) - 10.0F) / 10.0F;
+		if (call.m_ber < 0.0F || call.m_ber > 12.0F)
+			call.m_ber = 0.0F;
+
+		m_sender.add([&](CDisplayEncoder& encoder) {
+			return encoder.writeDMRBER(slotNo, call.m_ber);
+		});
+
+		call.m_nextBER += BER_INTERVAL;
+	}
+}
+
+void CTrafficGen::runRealistic(uint64_t duration)
+{
+	uint64_t start = now();
+	uint64_t stop  = duration > 0U ? start + duration : UINT64_MAX;
+
+	CCall calls[2U];
+	for (unsigned int i = 0U; i < 2U; i++) {
+		calls[i].m_active = false;
+		calls[i].m_start  = m_callRate > 0.0 ? start + interval(m_callRate) : UINT64_MAX;
+	}
+
+	uint64_t nextPOCSAG = m_pocsagRate > 0.0 ? start + interval(m_pocsagRate) : UINT64_MAX;
+	unsigned int pages  = 0U;
+	bool pocsag         = false;
+
+	// Idents closer together than their length are cut short
+	uint64_t cwInterval = m_cwInterval * NS_PER_SECOND;
+	uint64_t cwLength   = std::min(CW_LENGTH, cwInterval / 2U);
+	uint64_t nextCW     = m_cwInterval > 0U ? start + cwInterval : UINT64_MAX;
+	bool cw             = false;
+
+	// When to go idle after the last call, 0 while a call is active or once idle
+	uint64_t idle = 0U;
+
+	m_sender.add([](CDisplayEncoder& encoder) { return encoder.setIdle(); });
+	m_sender.flush();
+
+	while (killed == 0) {
+		uint64_t next = stop;
+		for (unsigned int i = 0U; i < 2U; i++) {
+			const CCall& call = calls[i];
+			if (!call.m_active) {
+				next = std::min(next, call.m_start);
+			} else {
+				next = std::min(next, std::min(call.m_end, std::min(call.m_nextRSSI, call.m_nextBER)));
+				if (call.m_aliasSent < call.m_alias.size())
+					next = std::min(next, call.m_nextTA);
+			}
+		}
+		next = std::min(next, std::min(nextPOCSAG, nextCW));
+		if (idle > 0U)
+			next = std::min(next, idle);
+
+		sleepUntil(next);
+		if (killed != 0)
+			break;
+
+		uint64_t time = now();
+		if (time >= stop)
+			break;
+
+		for (unsigned int i = 0U; i < 2U; i++) {
+			CCall& call = calls[i];
+
+			if (call.m_active && time >= call.m_end) {
+				m_sender.add([i](CDisplayEncoder& encoder) { return encoder.clearDMR(i + 1U); });
+				call.m_active = false;
+				call.m_start  = time + interval(m_callRate);
+				idle = time + IDLE_HANG;
+			} else if (call.m_active) {
+				updateCall(i + 1U, call, time);
+			} else if (time >= call.m_start) {
+				startCall(i + 1U, call, time);
+				idle = 0U;
+			}
+		}
+
+		// A burst of one to four pages, then the clear
+		if (time >= nextPOCSAG) {
+			if (!pocsag) {
+				pocsag = true;
+				pages  = 1U + random(4U);
+			}
+
+			if (pages > 0U) {
+				// DAPNET's time sync goes to RIC 224, the others to a 21 bit RIC
+				uint32_t ric = random(4U) == 0U ? 224U : random(1U << 21);
+				const char* page = PAGES[random(sizeof(PAGES) / sizeof(PAGES[0U]))];
+				m_sender.add([&](CDisplayEncoder& encoder) { return encoder.writePOCSAG(ric, page); });
+				pages--;
+				nextPOCSAG = time + POCSAG_INTERVAL;
+			} else {
+				m_sender.add([](CDisplayEncoder& encoder) { return encoder.clearPOCSAG(); });
+				pocsag     = false;
+				nextPOCSAG = time + interval(m_pocsagRate);
+			}
+		}
+
+		if (time >= nextCW) {
+			if (!cw) {
+				m_sender.add([](CDisplayEncoder& encoder) { return encoder.setCW(); });
+				nextCW = time + cwLength;
+			} else {
+				m_sender.add([](CDisplayEncoder& encoder) { return encoder.clearCW(); });
+				nextCW = time + cwInterval - cwLength;
+			}
+
+			cw = !cw;
+		}
+
+		if (idle > 0U && time >= idle && !calls[0U].m_active && !calls[1U].m_active) {
+			m_sender.add([](CDisplayEncoder& encoder) { return encoder.setIdle(); });
+			idle = 0U;
+		}
+
+		// Updates due together share a frame
+		m_sender.flush();
+	}
+
+	for (unsigned int i = 0U; i < 2U; i++) {
+		if (calls[i].m_active)
+			m_sender.add([i](CDisplayEncoder& encoder) { return encoder.clearDMR(i + 1U); });
+	}
+
+	m_sender.add([](CDisplayEncoder& encoder) { return encoder.setIdle(); });
+	m_sender.flush();
+}
+
+// The updates of two overlapping calls, over and over
+void CTrafficGen::addFlood(unsigned int n)
+{
+	unsigned int slotNo = (n / 8U) % 2U + 1U;
+
+	switch (n % 8U) {
+	case 0U: {
+			uint32_t srcId = getId();
+			m_sender.add([&](CDisplayEncoder& encoder) { return encoder.writeDMR(slotNo, srcId, true, 91U, 'R'); });
+		}
+		break;
+	case 1U:
+	case 4U:
+		m_sender.add([&](CDisplayEncoder& encoder) { return encoder.writeDMRRSSI(slotNo, 70U + n % 30U); });
+		break;
+	case 2U:
+	case 5U:
+		m_sender.add([&](CDisplayEncoder& encoder) { return encoder.writeDMRBER(slotNo, float(n % 50U) / 10.0F); });
+		break;
+	case 3U:
+		m_sender.add([&](CDisplayEncoder& encoder) { return encoder.writeDMRTA(slotNo, 'R', "DL1ABC"); });
+		break;
+	case 6U:
+		m_sender.add([&](CDisplayEncoder& encoder) { return encoder.writeDMRTA(slotNo, 'R', "DL1ABC Hans"); });
+		break;
+	default:
+		m_sender.add([&](CDisplayEncoder& encoder) { return encoder.clearDMR(slotNo); });
+		break;
+	}
+}
+
+void CTrafficGen::runFlood(uint64_t duration, unsigned int rate)
+{
+	uint64_t start = now();
+	uint64_t stop  = duration > 0U ? start + duration : UINT64_MAX;
+
+	unsigned int n = 0U;
+	for (uint64_t i = 0U; killed == 0; i++) {
+		if (rate > 0U)
+			sleepUntil(start + i * NS_PER_SECOND / rate);
+
+		// The clock is only read every so often at full rate
+		if ((rate > 0U || (i % 1024U) == 0U) && now() >= stop)
+			break;
+
+		if (!m_sender.isFrames()) {
+			addFlood(n++);
+		} else {
+			// Each datagram a full frame
+			unsigned long long datagrams = m_sender.getDatagrams() + m_sender.getErrors();
+			while (m_sender.getDatagrams() + m_sender.getErrors() == datagrams)
+				addFlood(n++);
+		}
+	}
+
+	m_sender.flush();
+}
+
+// Malformed and hostile datagrams for the decoder, the ID lookups and the coalescer
+void CTrafficGen::sendAdversarial()
+{
+	unsigned char data[2048U];
+	unsigned int length = 0U;
+
+	switch (random(10U)) {
+	case 0U:
+		// Opcodes that don't exist
+		data[0U] = random(2U) == 0U ? 0x00U : DISPLAY_CLOSE + 1U + random(0xFFU - DISPLAY_CLOSE);
+		if (data[0U] == DISPLAY_FRAME)
+			data[0U] = 0xFFU;
+		length = 1U + random(32U);
+		for (unsigned int i = 1U; i < length; i++)
+			data[i] = random(256U);
+		break;
+
+	case 1U: {
+			// Valid updates cut short, including their text counts running past the end
+			static const unsigned char DMR[] = {DISPLAY_DMR, 1U, 0x00U, 0x26U, 0x2DU, 0x5FU, 1U, 0x00U, 0x00U, 0x00U, 91U, 'R'};
+			static const unsigned char TA[]  = {DISPLAY_DMR_TA, 2U, 'N', 11U, 'D', 'L', '1', 'A', 'B', 'C', ' ', 'H', 'a', 'n', 's'};
+			static const unsigned char PAGE[] = {DISPLAY_POCSAG, 0x00U, 0x00U, 0x00U, 224U, 9U, 'T', 'e', 's', 't', ' ', 'p', 'a', 'g', 'e'};
+			const unsigned char* update = random(3U) == 0U ? DMR : random(2U) == 0U ? TA : PAGE;
+			unsigned int size = update == DMR ? sizeof(DMR) : update == TA ? sizeof(TA) : sizeof(PAGE);
+			length = 1U + random(size - 1U);
+			::memcpy(data, update, length);
+		}
+		break;
+
+	case 2U: {
+			// The longest texts, with control characters, 8 bit bytes and NULs
+			static const unsigned char TYPES[] = {DISPLAY_DMR_TA, DISPLAY_POCSAG, DISPLAY_ERROR};
+			data[0U] = TYPES[random(3U)];
+			unsigned int offset = data[0U] == DISPLAY_DMR_TA ? 3U : data[0U] == DISPLAY_POCSAG ? 5U : 1U;
+			for (unsigned int i = 1U; i < offset; i++)
+				data[i] = random(256U);
+			if (data[0U] == DISPLAY_DMR_TA)
+				data[1U] = 1U + random(2U);
+			data[offset] = 255U;
+			for (unsigned int i = 0U; i < 255U; i++)
+				data[offset + 1U + i] = random(256U);
+			length = offset + 1U + 255U;
+		}
+		break;
+
+	case 3U: {
+			// Slots other than 1 and 2
+			static const unsigned char SLOTS[] = {0U, 3U, 0x7FU, 0xFFU};
+			static const unsigned char TYPES[] = {DISPLAY_DMR_RSSI, DISPLAY_DMR_CLEAR, DISPLAY_DMR};
+			data[0U] = TYPES[random(3U)];
+			data[1U] = SLOTS[random(4U)];
+			data[2U] = 80U;
+			length = data[0U] == DISPLAY_DMR ? 12U : data[0U] == DISPLAY_DMR_RSSI ? 3U : 2U;
+			if (data[0U] == DISPLAY_DMR) {
+				for (unsigned int i = 2U; i < 11U; i++)
+					data[i] = random(256U);
+				data[11U] = 'R';
+			}
+		}
+		break;
+
+	case 4U: {
+			// Call churn on one slot, unknown IDs mostly, for the coalescer and the lookup cache
+			unsigned int slotNo = 1U + random(2U);
+			for (unsigned int i = 0U; i < 8U; i++) {
+				uint32_t srcId = random(16777216U);
+				m_sender.add([&](CDisplayEncoder& encoder) { return encoder.writeDMR(slotNo, srcId, true, 91U, 'N'); });
+				m_sender.add([&](CDisplayEncoder& encoder) { return encoder.clearDMR(slotNo); });
+			}
+			m_sender.flush();
+		}
+		return;
+
+	case 5U: {
+			// Frames repeating, rewinding or jumping their sequence number
+			unsigned int jump = random(3U);
+			m_sequence = jump == 0U ? m_sequence : jump == 1U ? m_sequence - 1U - random(100U) : m_sequence + 2U + random(30000U);
+			data[0U] = DISPLAY_FRAME;
+			data[1U] = DISPLAY_FRAME_VERSION;
+			data[2U] = m_sequence >> 8;
+			data[3U] = m_sequence & 0xFFU;
+			data[4U] = 1U;
+			data[5U] = 3U;
+			data[6U] = DISPLAY_DMR_RSSI;
+			data[7U] = 1U;
+			data[8U] = 90U;
+			length = 9U;
+		}
+		break;
+
+	case 6U:
+		// Frames whose count or update lengths run past the datagram, or of another version
+		data[0U] = DISPLAY_FRAME;
+		data[1U] = random(4U) == 0U ? DISPLAY_FRAME_VERSION + 1U : DISPLAY_FRAME_VERSION;
+		data[2U] = m_sequence >> 8;
+		data[3U] = m_sequence & 0xFFU;
+		data[4U] = random(2U) == 0U ? 255U : 2U;
+		data[5U] = random(2U) == 0U ? 200U : 0U;
+		data[6U] = DISPLAY_IDLE;
+		length = 5U + random(3U);
+		m_sequence++;
+		break;
+
+	case 7U:
+		// Larger than any frame, truncated by the receiver
+		length = sizeof(data);
+		::memset(data, 0, length);
+		data[0U] = DISPLAY_FRAME;
+		data[1U] = DISPLAY_FRAME_VERSION;
+		data[4U] = 255U;
+		break;
+
+	case 8U:
+		// Empty datagrams
+		length = 0U;
+		break;
+
+	default: {
+			// Numbers that aren't, in the BER text
+			static const char* BERS[] = {"nan", "-1", "1e309", "", "12.5.3", "99999999999999999999", "0x10"};
+			const char* ber = BERS[random(sizeof(BERS) / sizeof(BERS[0U]))];
+			data[0U] = DISPLAY_DMR_BER;
+			data[1U] = 1U + random(2U);
+			data[2U] = ::strlen(ber);
+			::memcpy(data + 3U, ber, data[2U]);
+			length = 3U + data[2U];
+		}
+		break;
+	}
+
+	m_sender.sendRaw(data, length);
+}
+
+void CTrafficGen::runAdversarial(uint64_t duration, unsigned int rate)
+{
+	uint64_t start = now();
+	uint64_t stop  = duration > 0U ? start + duration : UINT64_MAX;
+
+	for (uint64_t i = 0U; killed == 0; i++) {
+		if (rate > 0U)
+			sleepUntil(start + i * NS_PER_SECOND / rate);
+
+		if ((rate > 0U || (i % 1024U) == 0U) && now() >= stop)
+			break;
+
+		sendAdversarial();
+	}
+}
+
+int main(int argc, char** argv)
+{
+	const char* address = "127.0.0.1";
+	unsigned short port = 62001U;
+	TRAFFIC_MODE mode   = TM_REALISTIC;
+	double duration     = 60.0;
+	bool frames         = false;
+	double calls        = 2.0;
+	double length       = 8.0;
+	double pocsag       = 0.5;
+	unsigned int cw     = 600U;
+	int rate            = -1;
+	const char* ids     = NULL;
+	unsigned int seed   = (unsigned int)::time(NULL);
+
+	for (int currentArg = 1; currentArg < argc; ++currentArg) {
+		std::string arg = argv[currentArg];
+		const char* value = currentArg + 1 < argc ? argv[currentArg + 1] : NULL;
+
+		if (arg == "--frames") {
+			frames = true;
+			continue;
+		}
+
+		if (value == NULL) {
+			arg = "--help";
+		} else if (arg == "--mode") {
+			std::string name = value;
+			if (name == "realistic")
+				mode = TM_REALISTIC;
+			else if (name == "adversarial")
+				mode = TM_ADVERSARIAL;
+			else if (name == "flood")
+				mode = TM_FLOOD;
+			else
+				arg = "--help";
+		} else if (arg == "--address") {
+			address = value;
+		} else if (arg == "--port") {
+			port = (unsigned short)::atoi(value);
+		} else if (arg == "--duration") {
+			duration = ::atof(value);
+		} else if (arg == "--calls") {
+			calls = ::atof(value);
+		} else if (arg == "--length") {
+			length = ::atof(value);
+		} else if (arg == "--pocsag") {
+			pocsag = ::atof(value);
+		} else if (arg == "--cw") {
+			cw = (unsigned int)::atoi(value);
+		} else if (arg == "--rate") {
+			rate = ::atoi(value);
+		} else if (arg == "--ids") {
+			ids = value;
+		} else if (arg == "--seed") {
+			seed = (unsigned int)::strtoul(value, NULL, 10);
+		} else {
+			arg = "--help";
+		}
+
+		if (arg == "--help" || duration < 0.0 || calls < 0.0 || length <= 0.0 || pocsag < 0.0) {
+			::fprintf(stderr, "Usage: DisplayServer-trafficgen [--address host] [--port N] [--mode realistic|adversarial|flood]\n"
+				"\t[--duration s] [--frames] [--calls N] [--length s] [--pocsag N] [--cw s] [--rate N] [--ids file] [--seed N]\n");
+			return 1;
+		}
+
+		currentArg++;
+	}
+
+	CTrafficSender sender(frames);
+	if (!sender.open(address, port))
+		return 1;
+
+	CTrafficGen gen(sender, seed);
+	gen.setCalls(calls, length);
+	gen.setPOCSAG(pocsag);
+	gen.setCW(cw);
+
+	if (ids != NULL && !gen.readIds(ids))
+		return 1;
+
+	::signal(SIGINT, sigHandler);
+	::signal(SIGTERM, sigHandler);
+
+	uint64_t time = uint64_t(duration * NS_PER_SECOND);
+	uint64_t start = now();
+
+	switch (mode) {
+	case TM_ADVERSARIAL:
+		gen.runAdversarial(time, rate >= 0 ? unsigned(rate) : 1000U);
+		break;
+	case TM_FLOOD:
+		gen.runFlood(time, rate >= 0 ? unsigned(rate) : 0U);
+		break;
+	default:
+		gen.runRealistic(time);
+		break;
+	}
+
+	double elapsed = double(now() - start) / double(NS_PER_SECOND);
+
+	::fprintf(stdout, "Sent %llu datagrams, %llu updates, %llu bytes in %.3f s, %.0f datagrams/s, %llu send errors, seed %u\n",
+		sender.getDatagrams(), sender.getUpdates(), sender.getBytes(), elapsed,
+		elapsed > 0.0 ? double(sender.getDatagrams()) / elapsed : 0.0, sender.getErrors(), seed);
+
+	return 0;
+}
@@ -0,0 +1,321 @@
+/*
+ *   Copyright (C) 2026 by BrandMeister
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "DisplayWriter.h"
+#include "DisplayProtocol.h"
+#include "Log.h"
+
+#include <cassert>
+#include <cerrno>
+#include <cstdint>
+
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+CDisplayWriter::CDisplayWriter(CDisplay* display, CDisplayLatency& latency, bool debug) :
+CThread(),
+m_display(display),
+m_latency(latency),
+m_debug(debug),
+m_queue(DISPLAY_QUEUE_SIZE),
+m_coalescer(DISPLAY_QUEUE_SIZE),
+m_eventFd(-1),
+m_reactor(),
+m_displayTimer(),
+m_clockWatch(),
+m_stop(false),
+m_stalls(0ULL),
+m_busy(false)
+{
+	assert(display != NULL);
+}
+
+CDisplayWriter::~CDisplayWriter()
+{
+}
+
+bool CDisplayWriter::start()
+{
+	m_eventFd = ::eventfd(0U, EFD_NONBLOCK | EFD_CLOEXEC);
+	if (m_eventFd < 0) {
+		LogError("Cannot create the display writer eventfd, err: %d", errno);
+		return false;
+	}
+
+	if (!m_reactor.open() || !m_displayTimer.open()) {
+		m_reactor.close();
+		::close(m_eventFd);
+		m_eventFd = -1;
+		return false;
+	}
+
+	m_reactor.add(m_eventFd, this);
+	m_reactor.add(m_displayTimer.getFd(), this);
+
+	int displayFd = m_display->getFd();
+	if (displayFd >= 0)
+		m_reactor.add(displayFd, this);
+
+	if (!run()) {
+		LogError("Cannot start the display writer thread");
+		m_reactor.close();
+		m_displayTimer.close();
+		::close(m_eventFd);
+		m_eventFd = -1;
+		return false;
+	}
+
+	return true;
+}
+
+bool CDisplayWriter::write(const CDisplayEvent& event)
+{
+	return m_queue.push(event);
+}
+
+void CDisplayWriter::flush()
+{
+	uint64_t value = 1U;
+	if (::write(m_eventFd, &value, sizeof(value)) < 0 && errno != EAGAIN)
+		LogError("Cannot wake the display writer, err: %d", errno);
+}
+
+void CDisplayWriter::drain()
+{
+	// Busy is set before the queue is popped, so an empty queue with the
+	// writer not busy means nothing is left in between
+	while (m_queue.depth() > 0U || m_busy)
+		CThread::sleep(1U);
+}
+
+void CDisplayWriter::stop()
+{
+	m_stop = true;
+
+	flush();
+
+	wait();
+
+	m_reactor.close();
+	m_displayTimer.close();
+
+	::close(m_eventFd);
+	m_eventFd = -1;
+}
+
+void CDisplayWriter::entry()
+{
+	LogInfo("Started the display writer thread");
+
+	m_clockWatch.start();
+
+	while (!m_stop) {
+		clockDisplay();
+
+		m_displayTimer.start(m_display->getTimeout());
+
+		if (m_reactor.wait() < 0)
+			break;
+	}
+
+	LogInfo("Stopped the display writer thread");
+}
+
+bool CDisplayWriter::readable(int fd)
+{
+	if (fd == m_eventFd) {
+		// Reset the eventfd before draining, a write() after this wakes us again
+		uint64_t value;
+		while (::read(m_eventFd, &value, sizeof(value)) > 0)
+			;
+
+		// Bring the display timers up to date before acting on the events
+		clockDisplay();
+		writeEvents();
+		return true;
+	}
+
+	if (fd == m_displayTimer.getFd()) {
+		m_displayTimer.clear();
+		return true;
+	}
+
+	return m_display->read();
+}
+
+void CDisplayWriter::clockDisplay()
+{
+	unsigned int ms = m_clockWatch.elapsed();
+	if (ms == 0U)
+		return;
+
+	m_clockWatch.start();
+
+	m_display->clock(ms);
+}
+
+void CDisplayWriter::writeEvents()
+{
+	CDisplayEvent event;
+
+	m_busy = true;
+
+	while (!m_stop) {
+		// Take everything that arrived while the last update was being
+		// written, so superseded updates are merged rather than drawn
+		while (!m_coalescer.isFull() && m_queue.pop(event))
+			m_coalescer.add(event);
+
+		if (!m_coalescer.get(event))
+			break;
+
+		uint64_t start = CDisplayLatency::now();
+
+		writeEvent(event);
+
+		uint64_t end = CDisplayLatency::now();
+		m_latency.add(LS_WAIT, event.m_type, event.m_queued, start);
+		m_latency.add(LS_WRITE, event.m_type, start, end);
+		m_latency.add(LS_TOTAL, event.m_type, event.m_received, end);
+
+		if (end - start > DISPLAY_STALL_TIME * 1000000ULL)
+			m_stalls.fetch_add(1U, std::memory_order_relaxed);
+
+		// A slow panel may have taken a while, keep its timers in step
+		clockDisplay();
+	}
+
+	m_busy = false;
+}
+
+void CDisplayWriter::writeEvent(CDisplayEvent& event)
+{
+	switch (event.m_type) {
+		case DISPLAY_IDLE:
+			m_display->setIdle();
+
+			if (m_debug)
+				LogMessage(".... setIdle");
+			break;
+
+		case DISPLAY_ERROR:
+			m_display->setError(event.m_text);
+
+			if (m_debug)
+				LogMessage(".... setError text %s", event.m_text);
+			break;
+
+		case DISPLAY_QUIT:
+			m_display->setQuit();
+
+			if (m_debug)
+				LogMessage(".... setQuit");
+			break;
+
+		case DISPLAY_DMR:
+			m_display->writeDMR(event.m_slotNo, event.m_src, event.m_group, event.m_dst, event.m_dmrType);
+
+			if (m_debug)
+				LogMessage(".... writeDMR src %s dst %s group %d type %s", event.m_src.get(UDF_CALLSIGN), event.m_dst, event.m_group, event.m_dmrType);
+			break;
+
+		case DISPLAY_DMR_RSSI:
+			m_display->writeDMRRSSI(event.m_slotNo, event.m_rssi);
+
+			if (m_debug)
+				LogMessage(".... writeDMRRSSI slotNo %u rssi %u", event.m_slotNo, event.m_rssi);
+			break;
+
+		case DISPLAY_DMR_TA:
+			m_display->writeDMRTA(event.m_slotNo, (unsigned char*)event.m_text, event.m_dmrType);
+
+			if (m_debug)
+				LogMessage(".... writeDMRTA slotNo %u type %s ta %s", event.m_slotNo, event.m_dmrType, event.m_text);
+			break;
+
+		case DISPLAY_DMR_BER:
+			m_display->writeDMRBER(event.m_slotNo, event.m_ber);
+
+			if (m_debug)
+				LogMessage(".... writeDMRBER slotNo %u %f", event.m_slotNo, event.m_ber);
+			break;
+
+		case DISPLAY_DMR_CLEAR:
+			m_display->clearDMR(event.m_slotNo);
+
+			if (m_debug)
+				LogMessage(".... clearDMR slotNo %u", event.m_slotNo);
+			break;
+
+		case DISPLAY_POCSAG:
+			m_display->writePOCSAG(event.m_ric, event.m_text);
+
+			if (m_debug)
+				LogMessage(".... writePOCSSAG ric %u message %s", event.m_ric, event.m_text);
+			break;
+
+		case DISPLAY_POCSAG_CLEAR:
+			m_display->clearPOCSAG();
+
+			if (m_debug)
+				LogMessage(".... clearPOCSAG");
+			break;
+
+		case DISPLAY_CW:
+			m_display->writeCW();
+
+			if (m_debug)
+				LogMessage(".... writeCW");
+			break;
+
+		case DISPLAY_CW_CLEAR:
+			if (m_debug)
+				LogMessage(".... clearCW");
+
+			m_display->setIdle();
+			break;
+
+		default:
+			break;
+	}
+}
+
+unsigned int CDisplayWriter::getQueueDepth() const
+{
+	return m_queue.depth();
+}
+
+unsigned int CDisplayWriter::getMaxQueueDepth() const
+{
+	return m_queue.getMaxDepth();
+}
+
+unsigned long long CDisplayWriter::getOverflows() const
+{
+	return m_queue.getOverflows();
+}
+
+unsigned long long CDisplayWriter::getMerged() const
+{
+	return m_coalescer.getMerged();
+}
+
+unsigned long long CDisplayWriter::getStalls() const
+{
+	return m_stalls.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,87 @@
+/*
+ *   Copyright (C) 2026 by BrandMeister
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#pragma once
+
+#include "Display.h"
+#include "DisplayCoalescer.h"
+#include "DisplayEvent.h"
+#include "DisplayLatency.h"
+#include "EventTimer.h"
+#include "Reactor.h"
+#include "SPSCQueue.h"
+#include "StopWatch.h"
+#include "Thread.h"
+
+#include <atomic>
+
+const unsigned int DISPLAY_QUEUE_SIZE = 256U;
+
+// A display update that takes longer than this to write counts as a stall
+const unsigned int DISPLAY_STALL_TIME = 500U;	// ms
+
+// Owns the display once started: all serial, I2C and TCP output to the
+// panel happens on this thread, fed by events from the network thread
+class CDisplayWriter : public CThread, public IReactorHandler {
+public:
+	// The wait, write and total stages are recorded in latency
+	CDisplayWriter(CDisplay* display, CDisplayLatency& latency, bool debug);
+	virtual ~CDisplayWriter();
+
+	bool start();
+
+	// Network thread only, returns false if the queue has overflowed
+	bool write(const CDisplayEvent& event);
+
+	// Wake the writer after one or more write() calls
+	void flush();
+
+	// Network thread only, waits until everything written has reached the
+	// display or been merged
+	void drain();
+
+	void stop();
+
+	virtual void entry() override;
+
+	virtual bool readable(int fd) override;
+
+	unsigned int       getQueueDepth() const;
+	unsigned int       getMaxQueueDepth() const;
+	unsigned long long getOverflows() const;
+	unsigned long long getMerged() const;
+	unsigned long long getStalls() const;
+
+private:
+	CDisplay*                  m_display;
+	CDisplayLatency&           m_latency;
+	bool                       m_debug;
+	CSPSCQueue<CDisplayEvent>  m_queue;
+	CDisplayCoalescer          m_coalescer;
+	int                        m_eventFd;
+	CReactor                   m_reactor;
+	CEventTimer                m_displayTimer;
+	CStopWatch                 m_clockWatch;
+	std::atomic<bool>          m_stop;
+	std::atomic<unsigned long long> m_stalls;
+	std::atomic<bool>          m_busy;		// taking events from the queue
+
+	void clockDisplay();
+	void writeEvents();
+	void writeEvent(CDisplayEvent& event);
+};
@@ -0,0 +1,97 @@
+/*
+ *   Copyright (C) 2026 by BrandMeister
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "EventTimer.h"
+#include "Log.h"
+
+#include <cassert>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+CEventTimer::CEventTimer() :
+m_fd(-1),
+m_ms(0U)
+{
+}
+
+CEventTimer::~CEventTimer()
+{
+}
+
+bool CEventTimer::open()
+{
+	m_fd = ::timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+	if (m_fd < 0) {
+		LogError("Cannot create the timerfd, err: %d", errno);
+		return false;
+	}
+
+	return true;
+}
+
+void CEventTimer::start(unsigned int ms)
+{
+	assert(m_fd >= 0);
+
+	// Re-arming with the same value on every loop iteration is common, skip the syscall
+	if (ms == m_ms)
+		return;
+
+	struct itimerspec its;
+	::memset(&its, 0x00U, sizeof(its));
+	its.it_value.tv_sec  = ms / 1000U;
+	its.it_value.tv_nsec = (ms % 1000U) * 1000000U;
+
+	if (::timerfd_settime(m_fd, 0, &its, NULL) < 0)
+		LogError("Cannot arm the timerfd, err: %d", errno);
+
+	m_ms = ms;
+}
+
+void CEventTimer::stop()
+{
+	start(0U);
+}
+
+void CEventTimer::clear()
+{
+	uint64_t expirations;
+	while (::read(m_fd, &expirations, sizeof(expirations)) > 0)
+		;
+
+	// The one-shot timer is now disarmed
+	m_ms = 0U;
+}
+
+int CEventTimer::getFd() const
+{
+	return m_fd;
+}
+
+void CEventTimer::close()
+{
+	if (m_fd < 0)
+		return;
+
+	::close(m_fd);
+	m_fd = -1;
+}
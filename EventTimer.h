@@ -0,0 +1,43 @@
+/*
+ *   Copyright (C) 2026 by BrandMeister
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#pragma once
+
+// One-shot millisecond timer backed by a timerfd, so it can be waited on by CReactor
+class CEventTimer {
+public:
+	CEventTimer();
+	~CEventTimer();
+
+	bool open();
+
+	// Fire once after ms milliseconds, 0 disarms the timer
+	void start(unsigned int ms);
+	void stop();
+
+	// Acknowledge an expiry after the descriptor became readable
+	void clear();
+
+	int  getFd() const;
+
+	void close();
+
+private:
+	int          m_fd;
+	unsigned int m_ms;
+};
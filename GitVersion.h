@@ -0,0 +1 @@
+const char *gitversion = "71ab58ef19";
\ No newline at end of file
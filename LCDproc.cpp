@@ -67,9 +67,9 @@ m_dmr(false),
 m_clockDisplayTimer(1000U, 0U, 250U),   // Update the clock display every 250ms
 m_rssiCount1(0U),
 m_rssiCount2(0U),
-m_socketfd(),
+m_socketfd(-1),
 m_buffer(),
-m_readfds(), m_writefds(),
+m_writefds(),
 m_timeout(),
 m_recvsize(),
 m_rows(0),
@@ -189,7 +189,7 @@ void CLCDproc::setQuitInt()
 
 // LED 1 Green 1 Red 16 Yellow 17
 
-void CLCDproc::writeDMRInt(unsigned int slotNo, const std::string& src, bool group, const std::string& dst, const char* type)
+void CLCDproc::writeDMRInt(unsigned int slotNo, const char* src, bool group, const char* dst, const char* type)
 {
 	assert(type != NULL);
 
@@ -219,17 +219,17 @@ void CLCDproc::writeDMRInt(unsigned int slotNo, const std::string& src, bool gro
 			socketPrintf(m_socketfd, "widget_set DMR Mode 1 1 DMR");
 
 		if (slotNo == 1U)
-			socketPrintf(m_socketfd, "widget_set DMR Slot1 3 %u %u %u h 3 \"%s > %s%s\"", m_rows / 2, m_cols - 1, m_rows / 2, src.c_str(), group ? "TG" : "", dst.c_str());
+			socketPrintf(m_socketfd, "widget_set DMR Slot1 3 %u %u %u h 3 \"%s > %s%s\"", m_rows / 2, m_cols - 1, m_rows / 2, src, group ? "TG" : "", dst);
 		else
-			socketPrintf(m_socketfd, "widget_set DMR Slot2 3 %u %u %u h 3 \"%s > %s%s\"", m_rows / 2 + 1, m_cols - 1, m_rows / 2 + 1, src.c_str(), group ? "TG" : "", dst.c_str());
+			socketPrintf(m_socketfd, "widget_set DMR Slot2 3 %u %u %u h 3 \"%s > %s%s\"", m_rows / 2 + 1, m_cols - 1, m_rows / 2 + 1, src, group ? "TG" : "", dst);
 	} else {
 		socketPrintf(m_socketfd, "widget_set DMR Mode 1 1 DMR");
 
 		if (m_rows == 2U) {
-			socketPrintf(m_socketfd, "widget_set DMR Slot1 1 2 %u 2 h 3 \"%s > %s%s\"", m_cols - 1, src.c_str(), group ? "TG" : "", dst.c_str());
+			socketPrintf(m_socketfd, "widget_set DMR Slot1 1 2 %u 2 h 3 \"%s > %s%s\"", m_cols - 1, src, group ? "TG" : "", dst);
 		} else {
-			socketPrintf(m_socketfd, "widget_set DMR Slot1 1 2 %u 2 h 3 \"%s >\"", m_cols - 1, src.c_str());
-			socketPrintf(m_socketfd, "widget_set DMR Slot2 1 3 %u 3 h 3 \"%s%s\"", m_cols - 1, group ? "TG" : "", dst.c_str());
+			socketPrintf(m_socketfd, "widget_set DMR Slot1 1 2 %u 2 h 3 \"%s >\"", m_cols - 1, src);
+			socketPrintf(m_socketfd, "widget_set DMR Slot2 1 3 %u 3 h 3 \"%s%s\"", m_cols - 1, group ? "TG" : "", dst);
 		}
 	}
 	socketPrintf(m_socketfd, "output 16"); // Set LED1 color red
@@ -325,111 +325,112 @@ void CLCDproc::clockInt(unsigned int ms)
 
 		m_clockDisplayTimer.start();
 	}
+}
 
-	// We must set all this information on each select we do
-	FD_ZERO(&m_readfds);   // empty readfds
+unsigned int CLCDproc::getTimeoutInt()
+{
+	if (!m_displayClock)
+		return 0U;
 
-	// Then we put all the descriptors we want to wait for in a mask = m_readfds
-	FD_SET(m_socketfd, &m_readfds);
+	return m_clockDisplayTimer.getRemainingMS();
+}
 
-	// Timeout, we will stop waiting for information
-	m_timeout.tv_sec = 0;
-	m_timeout.tv_usec = 0;
+int CLCDproc::getFd()
+{
+	return m_socketfd;
+}
 
-	/* The first parameter is the biggest descriptor + 1. The first one was 0, so
-	 * every other descriptor will be bigger
-	 *
-	 * readfds = &m_readfds
-	 * writefds = we are not waiting for writefds
-	 * exceptfds = we are not waiting for exception fds
-	 */
+bool CLCDproc::read()
+{
+	// Only called once the socket is readable, so recv() will not block
+	m_recvsize = recv(m_socketfd, m_buffer, BUFFER_MAX_LEN - 1, 0);
 
-	if (select(m_socketfd + 1, &m_readfds, NULL, NULL, &m_timeout) == -1)
-		LogError("LCDproc, error on select");
+	if (m_recvsize == -1) {
+		LogError("LCDproc, cannot receive information");
+		return true;
+	}
 
-	// If something was received from the server...
-	if (FD_ISSET(m_socketfd, &m_readfds)) {
-		m_recvsize = recv(m_socketfd, m_buffer, BUFFER_MAX_LEN, 0);
-
-		if (m_recvsize == -1)
-			LogError("LCDproc, cannot receive information");
-
-		m_buffer[m_recvsize] = '\0';
-
-		char *argv[256];
-		size_t len = strlen(m_buffer);
-
-		// Now split the string into tokens...
-		int argc = 0;
-		int newtoken = 1;
-
-		for (size_t i = 0U; i < len; i++) {
-			switch (m_buffer[i]) {
-				case ' ':
-					newtoken = 1;
-					m_buffer[i] = 0;
-					break;
-				default:	/* regular chars, keep tokenizing */
-					if (newtoken)
-						argv[argc++] = m_buffer + i;
-					newtoken = 0;
-					break;
-				case '\0':
-				case '\n':
-					m_buffer[i] = 0;
-					if (argc > 0) {
-						if (0 == strcmp(argv[0], "listen")) {
-							LogDebug("LCDproc, the %s screen is displayed", argv[1]);
-						} else if (0 == strcmp(argv[0], "ignore")) {
-							LogDebug("LCDproc, the %s screen is hidden", argv[1]);
-						} else if (0 == strcmp(argv[0], "key")) {
-							LogDebug("LCDproc, Key %s", argv[1]);
-						} else if (0 == strcmp(argv[0], "menu")) {
-						} else if (0 == strcmp(argv[0], "connect")) {
-		 					// connect LCDproc 0.5.7 protocol 0.3 lcd wid 16 hgt 2 cellwid 5 cellhgt 8
-							int a;
-
-							for (a = 1; a < argc; a++) {
-								if (0 == strcmp(argv[a], "wid"))
-									m_cols = atoi(argv[++a]);
-								else if (0 == strcmp(argv[a], "hgt"))
-									m_rows = atoi(argv[++a]);
-								else if (0 == strcmp(argv[a], "cellwid")) {
-									//lcd_cellwid = atoi(argv[++a]);
-								} else if (0 == strcmp(argv[a], "cellhgt")) {
-									//lcd_cellhgt = atoi(argv[++a]);
-								}
-							}
+	if (m_recvsize == 0) {
+		LogWarning("LCDproc, the server has closed the connection");
+		m_connected = false;
+		return false;
+	}
 
-							m_connected = true;
-							socketPrintf(m_socketfd, "client_set -name MMDVMHost");
-						} else if (0 == strcmp(argv[0], "bye")) {
-							//close the socket- todo
-						} else if (0 == strcmp(argv[0], "success")) {
-							//LogDebug("LCDproc, command successful");
-						} else if (0 == strcmp(argv[0], "huh?")) {
-							sprintf(m_displayBuffer1, "LCDproc, command failed:");
-							sprintf(m_displayBuffer2, " ");
-
-							int j;
-							for (j = 1; j < argc; j++) {
-								strcat(m_displayBuffer1, m_displayBuffer2);
-								strcat(m_displayBuffer1, argv[j]);
+	m_buffer[m_recvsize] = '\0';
+
+	char *argv[256];
+	size_t len = strlen(m_buffer);
+
+	// Now split the string into tokens...
+	int argc = 0;
+	int newtoken = 1;
+
+	for (size_t i = 0U; i < len; i++) {
+		switch (m_buffer[i]) {
+			case ' ':
+				newtoken = 1;
+				m_buffer[i] = 0;
+				break;
+			default:	/* regular chars, keep tokenizing */
+				if (newtoken)
+					argv[argc++] = m_buffer + i;
+				newtoken = 0;
+				break;
+			case '\0':
+			case '\n':
+				m_buffer[i] = 0;
+				if (argc > 0) {
+					if (0 == strcmp(argv[0], "listen")) {
+						LogDebug("LCDproc, the %s screen is displayed", argv[1]);
+					} else if (0 == strcmp(argv[0], "ignore")) {
+						LogDebug("LCDproc, the %s screen is hidden", argv[1]);
+					} else if (0 == strcmp(argv[0], "key")) {
+						LogDebug("LCDproc, Key %s", argv[1]);
+					} else if (0 == strcmp(argv[0], "menu")) {
+					} else if (0 == strcmp(argv[0], "connect")) {
+	 					// connect LCDproc 0.5.7 protocol 0.3 lcd wid 16 hgt 2 cellwid 5 cellhgt 8
+						int a;
+
+						for (a = 1; a < argc; a++) {
+							if (0 == strcmp(argv[a], "wid"))
+								m_cols = atoi(argv[++a]);
+							else if (0 == strcmp(argv[a], "hgt"))
+								m_rows = atoi(argv[++a]);
+							else if (0 == strcmp(argv[a], "cellwid")) {
+								//lcd_cellwid = atoi(argv[++a]);
+							} else if (0 == strcmp(argv[a], "cellhgt")) {
+								//lcd_cellhgt = atoi(argv[++a]);
 							}
-							LogDebug("%s", m_displayBuffer1);
 						}
+
+						m_connected = true;
+						socketPrintf(m_socketfd, "client_set -name MMDVMHost");
+					} else if (0 == strcmp(argv[0], "bye")) {
+						//close the socket- todo
+					} else if (0 == strcmp(argv[0], "success")) {
+						//LogDebug("LCDproc, command successful");
+					} else if (0 == strcmp(argv[0], "huh?")) {
+						int len = snprintf(m_displayBuffer1, BUFFER_MAX_LEN, "LCDproc, command failed:");
+
+						int j;
+						for (j = 1; j < argc && len < BUFFER_MAX_LEN; j++)
+							len += snprintf(m_displayBuffer1 + len, BUFFER_MAX_LEN - len, " %s", argv[j]);
+
+						LogDebug("%s", m_displayBuffer1);
 					}
+				}
 
-					/* Restart tokenizing */
-					argc = 0;
-					newtoken = 1;
-					break;
-			}	/* switch( m_buffer[i] ) */
-		}
+				/* Restart tokenizing */
+				argc = 0;
+				newtoken = 1;
+				break;
+		}	/* switch( m_buffer[i] ) */
 	}
 
 	if (!m_screensDefined && m_connected)
 		defineScreens();
+
+	return true;
 }
 
 void CLCDproc::close()
@@ -467,6 +468,8 @@ int CLCDproc::socketPrintf(int fd, const char *format, ...)
 			LogError("LCDproc, cannot send data");
 			return -1;
 		}
+
+		addWritten((unsigned int)strlen(buf) + 1U);
 	}
 
 	return 0;
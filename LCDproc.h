@@ -37,12 +37,15 @@ public:
 
   virtual void close() override;
 
+  virtual int  getFd() override;
+  virtual bool read() override;
+
 protected:
   virtual void setIdleInt() override;
   virtual void setErrorInt(const char* text) override;
   virtual void setQuitInt() override;
 
-  virtual void writeDMRInt(unsigned int slotNo, const std::string& src, bool group, const std::string& dst, const char* type) override;
+  virtual void writeDMRInt(unsigned int slotNo, const char* src, bool group, const char* dst, const char* type) override;
   virtual void writeDMRRSSIInt(unsigned int slotNo, unsigned char rssi) override;
   virtual void clearDMRInt(unsigned int slotNo) override;
 
@@ -52,6 +55,7 @@ protected:
   virtual void clearCWInt() override;
 
   virtual void clockInt(unsigned int ms) override;
+  virtual unsigned int getTimeoutInt() override;
 
 private:
 	std::string  m_address;
@@ -73,7 +77,7 @@ private:
 
 	int            m_socketfd;
 	char           m_buffer[BUFFER_MAX_LEN];
-	fd_set         m_readfds, m_writefds;
+	fd_set         m_writefds;
 	struct timeval m_timeout;
 	int            m_recvsize;
 	unsigned int   m_rows;
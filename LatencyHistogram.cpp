@@ -0,0 +1,94 @@
+/*
+ *   Copyright (C) 2026 by BrandMeister
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "LatencyHistogram.h"
+
+#include <cassert>
+
+CLatencyHistogram::CLatencyHistogram() :
+m_sum(0ULL),
+m_max(0U)
+{
+	for (unsigned int i = 0U; i < LATENCY_BUCKETS; i++)
+		m_buckets[i] = 0ULL;
+}
+
+unsigned long long CLatencyHistogram::getCount() const
+{
+	unsigned long long count = 0ULL;
+
+	for (unsigned int i = 0U; i < LATENCY_BUCKETS; i++)
+		count += m_buckets[i].load(std::memory_order_relaxed);
+
+	return count;
+}
+
+unsigned long long CLatencyHistogram::getSum() const
+{
+	return m_sum.load(std::memory_order_relaxed);
+}
+
+unsigned int CLatencyHistogram::getMax() const
+{
+	return m_max.load(std::memory_order_relaxed);
+}
+
+unsigned long long CLatencyHistogram::getBucket(unsigned int n) const
+{
+	assert(n < LATENCY_BUCKETS);
+
+	return m_buckets[n].load(std::memory_order_relaxed);
+}
+
+unsigned int CLatencyHistogram::getPercentile(unsigned int percent) const
+{
+	assert(percent <= 100U);
+
+	unsigned long long counts[LATENCY_BUCKETS];
+	unsigned long long count = 0ULL;
+
+	// One snapshot, so the buckets add up to the total used
+	for (unsigned int i = 0U; i < LATENCY_BUCKETS; i++) {
+		counts[i] = m_buckets[i].load(std::memory_order_relaxed);
+		count    += counts[i];
+	}
+
+	if (count == 0ULL)
+		return 0U;
+
+	unsigned long long target = (count * percent + 99ULL) / 100ULL;
+	unsigned long long seen   = 0ULL;
+
+	for (unsigned int i = 0U; i < LATENCY_BUCKETS - 1U; i++) {
+		seen += counts[i];
+		if (seen >= target && seen > 0ULL)
+			return getLimit(i);
+	}
+
+	return getMax();
+}
+
+unsigned int CLatencyHistogram::getLimit(unsigned int n)
+{
+	assert(n < LATENCY_BUCKETS);
+
+	if (n == LATENCY_BUCKETS - 1U)
+		return 0U;
+
+	return 1U << n;
+}
@@ -0,0 +1,62 @@
+/*
+ *   Copyright (C) 2026 by BrandMeister
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// Bucket n counts samples below 2^n us, the last one everything longer
+const unsigned int LATENCY_BUCKETS = 24U;
+
+// Fixed log2 bucket histogram of latencies in microseconds. Only one thread
+// may add() to a histogram, any thread may read it while that goes on.
+class CLatencyHistogram {
+public:
+	CLatencyHistogram();
+
+	void add(unsigned int us)
+	{
+		unsigned int n = us == 0U ? 0U : 32U - __builtin_clz(us);
+		if (n >= LATENCY_BUCKETS)
+			n = LATENCY_BUCKETS - 1U;
+
+		// A single writer needs no read-modify-write, only untorn values
+		m_buckets[n].store(m_buckets[n].load(std::memory_order_relaxed) + 1U, std::memory_order_relaxed);
+		m_sum.store(m_sum.load(std::memory_order_relaxed) + us, std::memory_order_relaxed);
+
+		if (us > m_max.load(std::memory_order_relaxed))
+			m_max.store(us, std::memory_order_relaxed);
+	}
+
+	unsigned long long getCount() const;
+	unsigned long long getSum() const;
+	unsigned int       getMax() const;
+	unsigned long long getBucket(unsigned int n) const;
+
+	// The upper bound of the bucket the given percentage of samples is below
+	unsigned int getPercentile(unsigned int percent) const;
+
+	// Exclusive upper bound of bucket n in us, 0 for the last, open ended, one
+	static unsigned int getLimit(unsigned int n);
+
+private:
+	std::atomic<unsigned long long> m_buckets[LATENCY_BUCKETS];
+	std::atomic<unsigned long long> m_sum;
+	std::atomic<unsigned int>       m_max;
+};
@@ -0,0 +1,337 @@
+/*
+ *   Copyright (C) 2026 by BrandMeister
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "MetricsServer.h"
+#include "Log.h"
+#include "StopWatch.h"
+
+#include <cassert>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#include <netdb.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// Longest request read, anything after it is ignored
+const unsigned int METRICS_REQUEST_LENGTH = 2048U;
+
+// How long a client gets to send its request and read the reply
+const unsigned int METRICS_TIMEOUT = 1000U;	// ms
+
+IMetricsSource::~IMetricsSource()
+{
+}
+
+CMetricsServer::CMetricsServer(const std::string& address, unsigned int port, IMetricsSource* source) :
+CThread(),
+m_address(address),
+m_port(port),
+m_source(source),
+m_fd(-1),
+m_stopFd(-1),
+m_reactor(),
+m_stop(false),
+m_text()
+{
+	assert(source != NULL);
+}
+
+CMetricsServer::~CMetricsServer()
+{
+}
+
+bool CMetricsServer::start()
+{
+	if (!listen())
+		return false;
+
+	m_stopFd = ::eventfd(0U, EFD_NONBLOCK | EFD_CLOEXEC);
+	if (m_stopFd < 0 || !m_reactor.open()) {
+		LogError("Cannot set up the metrics thread, err: %d", errno);
+		::close(m_fd);
+		m_fd = -1;
+		return false;
+	}
+
+	m_reactor.add(m_fd, this);
+	m_reactor.add(m_stopFd, this);
+
+	return run();
+}
+
+void CMetricsServer::stop()
+{
+	m_stop = true;
+
+	uint64_t value = 1U;
+	if (::write(m_stopFd, &value, sizeof(value)) < 0)
+		LogError("Cannot wake the metrics thread, err: %d", errno);
+
+	wait();
+
+	m_reactor.close();
+
+	::close(m_stopFd);
+	m_stopFd = -1;
+
+	::close(m_fd);
+	m_fd = -1;
+
+	if (m_address[0U] == '/')
+		::unlink(m_address.c_str());
+}
+
+void CMetricsServer::entry()
+{
+	LogInfo("Started the metrics thread");
+
+	while (!m_stop) {
+		if (m_reactor.wait() < 0)
+			break;
+	}
+
+	LogInfo("Stopped the metrics thread");
+}
+
+bool CMetricsServer::readable(int fd)
+{
+	if (fd == m_stopFd) {
+		uint64_t value;
+		while (::read(m_stopFd, &value, sizeof(value)) > 0)
+			;
+		return true;
+	}
+
+	// One client at a time, a scrape is quick and nothing else waits on it
+	int client;
+	while ((client = ::accept4(m_fd, NULL, NULL, SOCK_CLOEXEC)) >= 0) {
+		serve(client);
+		::close(client);
+	}
+
+	if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+		LogWarning("Cannot accept a metrics connection, err: %d", errno);
+
+	return true;
+}
+
+bool CMetricsServer::listen()
+{
+	if (m_address[0U] == '/') {
+		struct sockaddr_un addr;
+		::memset(&addr, 0, sizeof(addr));
+		addr.sun_family = AF_UNIX;
+
+		if (m_address.length() >= sizeof(addr.sun_path)) {
+			LogError("The metrics socket path is too long - %s", m_address.c_str());
+			return false;
+		}
+		::strcpy(addr.sun_path, m_address.c_str());
+
+		m_fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+		if (m_fd < 0) {
+			LogError("Cannot create the metrics socket, err: %d", errno);
+			return false;
+		}
+
+		// Left behind by an earlier run that didn't stop cleanly
+		::unlink(m_address.c_str());
+
+		if (::bind(m_fd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+			LogError("Cannot bind the metrics socket %s, err: %d", m_address.c_str(), errno);
+			::close(m_fd);
+			m_fd = -1;
+			return false;
+		}
+	} else {
+		struct addrinfo hints;
+		::memset(&hints, 0, sizeof(hints));
+		hints.ai_family   = AF_UNSPEC;
+		hints.ai_socktype = SOCK_STREAM;
+		hints.ai_flags    = AI_PASSIVE | AI_NUMERICHOST;
+
+		char port[10U];
+		::snprintf(port, sizeof(port), "%u", m_port);
+
+		struct addrinfo* res;
+		int err = ::getaddrinfo(m_address.c_str(), port, &hints, &res);
+		if (err != 0) {
+			LogError("Cannot use %s as the metrics address, %s", m_address.c_str(), ::gai_strerror(err));
+			return false;
+		}
+
+		m_fd = ::socket(res->ai_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+		if (m_fd < 0) {
+			LogError("Cannot create the metrics socket, err: %d", errno);
+			::freeaddrinfo(res);
+			return false;
+		}
+
+		int reuse = 1;
+		::setsockopt(m_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+		if (::bind(m_fd, res->ai_addr, res->ai_addrlen) < 0) {
+			LogError("Cannot bind the metrics address %s:%u, err: %d", m_address.c_str(), m_port, errno);
+			::freeaddrinfo(res);
+			::close(m_fd);
+			m_fd = -1;
+			return false;
+		}
+
+		::freeaddrinfo(res);
+	}
+
+	if (::listen(m_fd, 4) < 0) {
+		LogError("Cannot listen for metrics connections, err: %d", errno);
+		::close(m_fd);
+		m_fd = -1;
+		return false;
+	}
+
+	if (m_address[0U] == '/')
+		LogInfo("Serving metrics on %s", m_address.c_str());
+	else
+		LogInfo("Serving metrics on %s:%u", m_address.c_str(), m_port);
+
+	return true;
+}
+
+void CMetricsServer::serve(int fd)
+{
+	struct timeval tv;
+	tv.tv_sec  = METRICS_TIMEOUT / 1000U;
+	tv.tv_usec = (METRICS_TIMEOUT % 1000U) * 1000U;
+	::setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+
+	// Only the request line matters, but the headers are read to their end
+	// so that the client doesn't see a reset
+	char request[METRICS_REQUEST_LENGTH + 1U];
+	unsigned int length = 0U;
+
+	// The timeout covers the whole request, not each recv, so a client
+	// trickling it a byte at a time can't hold the thread
+	CStopWatch watch;
+	watch.start();
+
+	while (length < METRICS_REQUEST_LENGTH) {
+		unsigned int elapsed = watch.elapsed();
+		if (elapsed >= METRICS_TIMEOUT) {
+			LogWarning("Timed out reading a metrics request");
+			return;
+		}
+
+		unsigned int remaining = METRICS_TIMEOUT - elapsed;
+		tv.tv_sec  = remaining / 1000U;
+		tv.tv_usec = (remaining % 1000U) * 1000U;
+		::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+		ssize_t n = ::recv(fd, request + length, METRICS_REQUEST_LENGTH - length, 0);
+		if (n < 0 && errno == EINTR)
+			continue;
+		if (n <= 0)
+			return;
+
+		length += n;
+		request[length] = '\0';
+
+		if (::strstr(request, "\r\n\r\n") != NULL || ::strstr(request, "\n\n") != NULL)
+			break;
+	}
+
+	request[length] = '\0';
+
+	const char* status = "200 OK";
+	if (::strncmp(request, "GET ", 4U) != 0)
+		status = "405 Method Not Allowed";
+	else if (::strncmp(request + 4U, "/metrics ", 9U) != 0 && ::strncmp(request + 4U, "/ ", 2U) != 0)
+		status = "404 Not Found";
+
+	m_text.clear();
+	if (::strcmp(status, "200 OK") == 0)
+		m_source->writeMetrics(m_text);
+
+	char header[200U];
+	int n = ::snprintf(header, sizeof(header),
+			   "HTTP/1.0 %s\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: %u\r\nConnection: close\r\n\r\n",
+			   status, (unsigned int)m_text.length());
+
+	if (send(fd, header, n))
+		send(fd, m_text.data(), m_text.length());
+}
+
+bool CMetricsServer::send(int fd, const char* data, size_t length)
+{
+	while (length > 0U) {
+		ssize_t n = ::send(fd, data, length, MSG_NOSIGNAL);
+		if (n < 0) {
+			if (errno == EINTR)
+				continue;
+			return false;
+		}
+
+		data   += n;
+		length -= n;
+	}
+
+	return true;
+}
+
+void CMetricsServer::addHeader(std::string& text, const char* name, const char* type, const char* help)
+{
+	assert(name != NULL);
+	assert(type != NULL);
+	assert(help != NULL);
+
+	text += "# HELP ";
+	text += name;
+	text += ' ';
+	text += help;
+	text += "\n# TYPE ";
+	text += name;
+	text += ' ';
+	text += type;
+	text += '\n';
+}
+
+void CMetricsServer::addValue(std::string& text, const char* name, const char* labels, unsigned long long value)
+{
+	char buffer[200U];
+	if (labels != NULL)
+		::snprintf(buffer, sizeof(buffer), "%s{%s} %llu\n", name, labels, value);
+	else
+		::snprintf(buffer, sizeof(buffer), "%s %llu\n", name, value);
+
+	text += buffer;
+}
+
+void CMetricsServer::addValue(std::string& text, const char* name, const char* labels, double value)
+{
+	char buffer[200U];
+	if (labels != NULL)
+		::snprintf(buffer, sizeof(buffer), "%s{%s} %.6g\n", name, labels, value);
+	else
+		::snprintf(buffer, sizeof(buffer), "%s %.6g\n", name, value);
+
+	text += buffer;
+}
@@ -0,0 +1,75 @@
+/*
+ *   Copyright (C) 2026 by BrandMeister
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#pragma once
+
+#include "Reactor.h"
+#include "Thread.h"
+
+#include <atomic>
+#include <string>
+
+// Supplies the metrics, called on the metrics thread for each request so
+// everything it reads must be safe to read from there
+class IMetricsSource {
+public:
+	virtual ~IMetricsSource() = 0;
+
+	// Appends the metrics in the Prometheus text format
+	virtual void writeMetrics(std::string& text) = 0;
+
+private:
+};
+
+// Serves GET /metrics over HTTP from a thread of its own, so that a slow or
+// stuck scraper never holds up the display. Nothing is formatted until a
+// request comes in.
+class CMetricsServer : public CThread, public IReactorHandler {
+public:
+	// An address starting with '/' is the path of a unix socket to listen
+	// on, the port is then unused
+	CMetricsServer(const std::string& address, unsigned int port, IMetricsSource* source);
+	virtual ~CMetricsServer();
+
+	bool start();
+
+	void stop();
+
+	virtual void entry() override;
+
+	virtual bool readable(int fd) override;
+
+	// Prometheus text format, labels is the text between the braces or NULL
+	static void addHeader(std::string& text, const char* name, const char* type, const char* help);
+	static void addValue(std::string& text, const char* name, const char* labels, unsigned long long value);
+	static void addValue(std::string& text, const char* name, const char* labels, double value);
+
+private:
+	std::string       m_address;
+	unsigned int      m_port;
+	IMetricsSource*   m_source;
+	int               m_fd;
+	int               m_stopFd;
+	CReactor          m_reactor;
+	std::atomic<bool> m_stop;
+	std::string       m_text;		// kept, so that requests after the first don't allocate
+
+	bool listen();
+	void serve(int fd);
+	bool send(int fd, const char* data, size_t length);
+};
@@ -0,0 +1,251 @@
+/*
+ *   Copyright (C) 2026 by BrandMeister
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "MockSerialPort.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <ctime>
+
+const uint64_t NS_PER_SECOND = 1000000000ULL;
+
+static uint64_t now()
+{
+	struct timespec ts;
+	::clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return uint64_t(ts.tv_sec) * NS_PER_SECOND + ts.tv_nsec;
+}
+
+static void sleepUntil(uint64_t time)
+{
+	struct timespec ts;
+	ts.tv_sec  = time / NS_PER_SECOND;
+	ts.tv_nsec = time % NS_PER_SECOND;
+
+	while (::clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) != 0)
+		;
+}
+
+CMockSerialPort::CMockSerialPort() :
+m_data(),
+m_input(),
+m_fifoSize(0U),
+m_byteTime(0ULL),
+m_emptyAt(0ULL),
+m_latency(0U),
+m_maxWrite(0U),
+m_blocking(true),
+m_bytes(0ULL),
+m_writes(0ULL),
+m_shortWrites(0ULL),
+m_refused(0ULL),
+m_blockedTime(0ULL),
+m_maxQueued(0U)
+{
+}
+
+CMockSerialPort::~CMockSerialPort()
+{
+}
+
+bool CMockSerialPort::open()
+{
+	m_data.clear();
+	m_input.clear();
+
+	m_emptyAt     = 0ULL;
+	m_bytes       = 0ULL;
+	m_writes      = 0ULL;
+	m_shortWrites = 0ULL;
+	m_refused     = 0ULL;
+	m_blockedTime = 0ULL;
+	m_maxQueued   = 0U;
+
+	return true;
+}
+
+int CMockSerialPort::read(unsigned char* buffer, unsigned int length)
+{
+	assert(buffer != NULL);
+
+	unsigned int n = length < m_input.size() ? length : (unsigned int)m_input.size();
+	if (n == 0U)
+		return 0;
+
+	::memcpy(buffer, m_input.data(), n);
+	m_input.erase(0U, n);
+
+	return int(n);
+}
+
+int CMockSerialPort::write(const unsigned char* buffer, unsigned int length)
+{
+	assert(buffer != NULL);
+
+	if (m_latency > 0U)
+		sleepUntil(now() + m_latency * 1000ULL);
+
+	unsigned int n = length;
+	if (m_maxWrite > 0U && n > m_maxWrite)
+		n = m_maxWrite;
+
+	if (m_byteTime > 0ULL)
+		n = queue(n);
+
+	m_data.insert(m_data.end(), buffer, buffer + n);
+
+	if (n < length) {
+		m_shortWrites++;
+		m_refused += length - n;
+	}
+
+	m_bytes += n;
+	m_writes++;
+
+	return int(n);
+}
+
+// Takes as much of length as the FIFO has room for, waiting for the rest when blocking
+unsigned int CMockSerialPort::queue(unsigned int length)
+{
+	unsigned int done = 0U;
+
+	while (done < length) {
+		uint64_t time = now();
+
+		unsigned int queued = getQueued(time);
+		unsigned int room   = m_fifoSize > queued ? m_fifoSize - queued : 0U;
+
+		// What is left, or a FIFO full of it
+		unsigned int wanted = std::min(length - done, m_fifoSize);
+
+		if (room == 0U || (room < wanted && m_blocking)) {
+			if (!m_blocking)
+				break;
+
+			sleepUntil(m_emptyAt - (m_fifoSize - wanted) * m_byteTime);
+			m_blockedTime += now() - time;
+			continue;
+		}
+
+		unsigned int n = std::min(room, length - done);
+		m_emptyAt = std::max(time, m_emptyAt) + n * m_byteTime;
+		done += n;
+
+		m_maxQueued = std::max(m_maxQueued, queued + n);
+	}
+
+	return done;
+}
+
+void CMockSerialPort::close()
+{
+}
+
+void CMockSerialPort::setInput(const unsigned char* buffer, unsigned int length)
+{
+	assert(buffer != NULL);
+
+	m_input.append((const char*)buffer, length);
+}
+
+void CMockSerialPort::setBaudRate(unsigned int baud, unsigned int fifoSize)
+{
+	assert(baud == 0U || fifoSize > 0U);
+
+	// A start bit, 8 data bits and a stop bit
+	m_byteTime = baud > 0U ? 10ULL * NS_PER_SECOND / baud : 0ULL;
+	m_fifoSize = fifoSize;
+}
+
+void CMockSerialPort::setLatency(unsigned int us)
+{
+	m_latency = us;
+}
+
+void CMockSerialPort::setMaxWrite(unsigned int length)
+{
+	m_maxWrite = length;
+}
+
+void CMockSerialPort::setBlocking(bool blocking)
+{
+	m_blocking = blocking;
+}
+
+void CMockSerialPort::drain()
+{
+	if (m_emptyAt > now())
+		sleepUntil(m_emptyAt);
+}
+
+unsigned int CMockSerialPort::getQueued() const
+{
+	return getQueued(now());
+}
+
+unsigned int CMockSerialPort::getQueued(uint64_t time) const
+{
+	if (m_byteTime == 0ULL || m_emptyAt <= time)
+		return 0U;
+
+	// A byte partly sent still counts
+	return (unsigned int)((m_emptyAt - time + m_byteTime - 1U) / m_byteTime);
+}
+
+const std::vector<unsigned char>& CMockSerialPort::getData() const
+{
+	return m_data;
+}
+
+void CMockSerialPort::clear()
+{
+	m_data.clear();
+}
+
+unsigned long long CMockSerialPort::getBytes() const
+{
+	return m_bytes;
+}
+
+unsigned long long CMockSerialPort::getWrites() const
+{
+	return m_writes;
+}
+
+unsigned long long CMockSerialPort::getShortWrites() const
+{
+	return m_shortWrites;
+}
+
+unsigned long long CMockSerialPort::getRefused() const
+{
+	return m_refused;
+}
+
+unsigned long long CMockSerialPort::getBlockedTime() const
+{
+	return m_blockedTime;
+}
+
+unsigned int CMockSerialPort::getMaxQueued() const
+{
+	return m_maxQueued;
+}
@@ -0,0 +1,98 @@
+/*
+ *   Copyright (C) 2026 by BrandMeister
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#pragma once
+
+#include "SerialPort.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// An in-memory port for running the serial display drivers without a
+// display, e.g. in the benchmarks. Everything written is recorded until
+// clear(), reads return the bytes given to setInput().
+//
+// With a baud rate set it also plays the UART: bytes leave at the speed of
+// the wire through a transmit FIFO, and write() waits for room in it as a
+// blocking tty would. Latency and short writes can be added, to see how a
+// driver and its pacing fare on a slow or awkward link.
+class CMockSerialPort : public ISerialPort {
+public:
+	CMockSerialPort();
+	virtual ~CMockSerialPort();
+
+	virtual bool open() override;
+
+	virtual int read(unsigned char* buffer, unsigned int length) override;
+
+	virtual int write(const unsigned char* buffer, unsigned int length) override;
+
+	virtual void close() override;
+
+	void setInput(const unsigned char* buffer, unsigned int length);
+
+	// 8N1, so baud / 10 bytes a second, through a FIFO of fifoSize bytes
+	// (the tty buffer of a serial port). 0 for no throttling.
+	void setBaudRate(unsigned int baud, unsigned int fifoSize = 4096U);
+
+	// Each write() takes this long before it returns, as through a USB adapter
+	void setLatency(unsigned int us);
+
+	// write() takes no more than length bytes and returns the short count, 0 for no limit
+	void setMaxWrite(unsigned int length);
+
+	// Not blocking, write() returns what fits in a full FIFO rather than waiting
+	void setBlocking(bool blocking);
+
+	// Waits for the FIFO to empty, like tcdrain()
+	void drain();
+
+	// Bytes still in the FIFO
+	unsigned int getQueued() const;
+
+	const std::vector<unsigned char>& getData() const;
+	void clear();
+
+	// Since open()
+	unsigned long long getBytes() const;
+	unsigned long long getWrites() const;
+	unsigned long long getShortWrites() const;
+	unsigned long long getRefused() const;		// bytes not taken by short writes
+	unsigned long long getBlockedTime() const;	// ns spent waiting for the FIFO
+	unsigned int       getMaxQueued() const;
+
+private:
+	std::vector<unsigned char> m_data;
+	std::string                m_input;
+	unsigned int               m_fifoSize;
+	uint64_t                   m_byteTime;		// ns on the wire, 0 for no throttling
+	uint64_t                   m_emptyAt;		// when the FIFO will have emptied
+	unsigned int               m_latency;		// us
+	unsigned int               m_maxWrite;
+	bool                       m_blocking;
+	unsigned long long         m_bytes;
+	unsigned long long         m_writes;
+	unsigned long long         m_shortWrites;
+	unsigned long long         m_refused;
+	unsigned long long         m_blockedTime;
+	unsigned int               m_maxQueued;
+
+	unsigned int queue(unsigned int length);
+	unsigned int getQueued(uint64_t time) const;
+};
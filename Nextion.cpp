@@ -64,7 +64,8 @@ m_txFrequency(txFrequency),
 m_rxFrequency(rxFrequency),
 m_fl_txFrequency(0.0F),
 m_fl_rxFrequency(0.0F),
-m_displayTempInF(displayTempInF)
+m_displayTempInF(displayTempInF),
+m_commandDelay(10U)
 {
 	assert(serial != NULL);
 
@@ -232,7 +233,7 @@ void CNextion::setQuitInt()
 	m_mode = MODE_QUIT;
 }
 
-void CNextion::writeDMRInt(unsigned int slotNo, const std::string& src, bool group, const std::string& dst, const char* type)
+void CNextion::writeDMRInt(unsigned int slotNo, const char* src, bool group, const char* dst, const char* type)
 {
 	assert(type != NULL);
 
@@ -271,7 +272,7 @@ void CNextion::writeDMRInt(unsigned int slotNo, const std::string& src, bool gro
 	}
 
 	if (slotNo == 1U) {
-		::sprintf(text, "t0.txt=\"1 %s %s\"", type, src.c_str());
+		::sprintf(text, "t0.txt=\"1 %s %s\"", type, src);
 
 		if (m_screenLayout & LAYOUT_TA_ENABLE) {
 			if (m_screenLayout & LAYOUT_TA_COLOUR)
@@ -283,11 +284,11 @@ void CNextion::writeDMRInt(unsigned int slotNo, const std::string& src, bool gro
 		sendCommand(text);
 		sendCommandAction(62U);
 
-		::sprintf(text, "t1.txt=\"%s%s\"", group ? "TG" : "", dst.c_str());
+		::sprintf(text, "t1.txt=\"%s%s\"", group ? "TG" : "", dst);
 		sendCommand(text);
 		sendCommandAction(65U);
 	} else {
-		::sprintf(text, "t2.txt=\"2 %s %s\"", type, src.c_str());
+		::sprintf(text, "t2.txt=\"2 %s %s\"", type, src);
 
 		if (m_screenLayout & LAYOUT_TA_ENABLE) {
 			if (m_screenLayout & LAYOUT_TA_COLOUR)
@@ -299,7 +300,7 @@ void CNextion::writeDMRInt(unsigned int slotNo, const std::string& src, bool gro
 		sendCommand(text);
 		sendCommandAction(70U);
 
-		::sprintf(text, "t3.txt=\"%s%s\"", group ? "TG" : "", dst.c_str());
+		::sprintf(text, "t3.txt=\"%s%s\"", group ? "TG" : "", dst);
 		sendCommand(text);
 		sendCommandAction(73U);
 	}
@@ -538,6 +539,31 @@ void CNextion::clockInt(unsigned int ms)
 	}
 }
 
+unsigned int CNextion::getTimeoutInt()
+{
+	if (m_displayClock && (m_mode == MODE_IDLE || m_mode == MODE_CW))
+		return m_clockDisplayTimer.getRemainingMS();
+
+	return 0U;
+}
+
+int CNextion::getFd()
+{
+	return m_serial->getFd();
+}
+
+bool CNextion::read()
+{
+	// Nothing is requested from the display, discard whatever it sends back
+	unsigned char c;
+	int n;
+	while ((n = m_serial->read(&c, 1U)) > 0)
+		;
+
+	// 0 once drained, -1 when the port has failed or hung up
+	return n == 0;
+}
+
 void CNextion::close()
 {
 	m_serial->close();
@@ -561,8 +587,15 @@ void CNextion::sendCommand(const char* command)
 
 	m_serial->write((unsigned char*)command, (unsigned int)::strlen(command));
 	m_serial->write((unsigned char*)"\xFF\xFF\xFF", 3U);
+	addWritten((unsigned int)::strlen(command) + 3U);
 	// Since we just firing commands at the display, and not listening for the response,
 	// we must add a bit of a delay to allow the display to process the commands, else some are getting mangled.
 	// 10 ms is just a guess, but seems to be sufficient.
-    CThread::sleep(10U);
+	if (m_commandDelay > 0U)
+		CThread::sleep(m_commandDelay);
+}
+
+void CNextion::setCommandDelay(unsigned int ms)
+{
+	m_commandDelay = ms;
 }
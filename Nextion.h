@@ -35,12 +35,18 @@ public:
 
   virtual void close() override;
 
+  virtual int  getFd() override;
+  virtual bool read() override;
+
+  // Pause after each command so the panel can keep up, 0 for none
+  void setCommandDelay(unsigned int ms);
+
 protected:
   virtual void setIdleInt() override;
   virtual void setErrorInt(const char* text) override;
   virtual void setQuitInt() override;
 
-  virtual void writeDMRInt(unsigned int slotNo, const std::string& src, bool group, const std::string& dst, const char* type) override;
+  virtual void writeDMRInt(unsigned int slotNo, const char* src, bool group, const char* dst, const char* type) override;
   virtual void writeDMRRSSIInt(unsigned int slotNo, unsigned char rssi) override;
   virtual void writeDMRTAInt(unsigned int slotNo, unsigned char* talkerAlias, const char* type) override;
 
@@ -54,6 +60,7 @@ protected:
   virtual void clearCWInt() override;
 
   virtual void clockInt(unsigned int ms) override;
+  virtual unsigned int getTimeoutInt() override;
 
 private:
   std::string   m_callsign;
@@ -80,6 +87,7 @@ private:
   double        m_fl_txFrequency;
   double        m_fl_rxFrequency;
   bool          m_displayTempInF;
+  unsigned int  m_commandDelay;
   
   void sendCommand(const char* command);
   void sendCommandAction(unsigned int status);
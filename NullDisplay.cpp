@@ -44,7 +44,7 @@ void CNullDisplay::setQuitInt()
 {
 }
 
-void CNullDisplay::writeDMRInt(unsigned int slotNo, const std::string& src, bool group, const std::string& dst, const char* type)
+void CNullDisplay::writeDMRInt(unsigned int slotNo, const char* src, bool group, const char* dst, const char* type)
 {
 }
 
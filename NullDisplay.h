@@ -37,7 +37,7 @@ protected:
 	virtual void setErrorInt(const char* text) override;
 	virtual void setQuitInt() override;
 
-	virtual void writeDMRInt(unsigned int slotNo, const std::string& src, bool group, const std::string& dst, const char* type) override;
+	virtual void writeDMRInt(unsigned int slotNo, const char* src, bool group, const char* dst, const char* type) override;
 	virtual void clearDMRInt(unsigned int slotNo) override;
 
 	virtual void writePOCSAGInt(uint32_t ric, const std::string& message) override;
@@ -139,12 +139,12 @@ bool COLED::open()
     // init done
     m_display.setTextWrap(false); // disable text wrap as default
     m_display.clearDisplay();   // clears the screen  buffer
-    m_display.display();        // display it (clear display)
+    sendBuffer();        // display it (clear display)
 
     OLED_statusbar();
     m_display.setCursor(0,OLED_LINE3);
     m_display.print("Startup");
-    m_display.display();
+    sendBuffer();
 
     return true;
 }
@@ -163,7 +163,7 @@ void COLED::setIdleInt()
 //    m_display.setTextSize(1);
     if (m_displayScroll && m_displayLogoScreensaver)
         m_display.startscrolldiagleft(0x00,0x0f);  //the MMDVM logo scrolls the whole screen
-    m_display.display();
+    sendBuffer();
 
     passCounter ++;
     if (passCounter > 253U)
@@ -197,7 +197,7 @@ void COLED::setErrorInt(const char* text)
     m_display.printf("%s\n",text);
     m_display.setTextWrap(false);
 
-    m_display.display();
+    sendBuffer();
 }
 
 void COLED::setQuitInt()
@@ -212,20 +212,19 @@ void COLED::setQuitInt()
     m_display.print("Stopped");
 
     m_display.setTextSize(1);
-    m_display.display();
+    sendBuffer();
 }
 
-void COLED::writeDMRInt(unsigned int slotNo,const std::string& src,bool group,const std::string& dst,const char* type)
+void COLED::writeDMRInt(unsigned int slotNo,const char* src,bool group,const char* dst,const char* type)
 {
     CUserDBentry tmp;
 
-    tmp.set(keyCALLSIGN, src);
+    tmp.set(UDF_CALLSIGN, src);
+    tmp.format();
     writeDMRIntEx(slotNo, tmp, group, dst, type);
 }
 
-#define CALLandNAME(u) ((u).get(keyCALLSIGN) + " " + (u).get(keyFIRST_NAME))
-
-int COLED::writeDMRIntEx(unsigned int slotNo, const class CUserDBentry& src, bool group, const std::string& dst, const char* type)
+int COLED::writeDMRIntEx(unsigned int slotNo, const class CUserDBentry& src, bool group, const char* dst, const char* type)
 {
 
     if (m_mode != MODE_DMR) {
@@ -240,17 +239,17 @@ int COLED::writeDMRIntEx(unsigned int slotNo, const class CUserDBentry& src, boo
         if (slotNo == 1U) {
             m_display.fillRect(0,OLED_LINE2,m_display.width(),40,BLACK);
             m_display.setCursor(0,OLED_LINE2);
-            m_display.printf("%s",CALLandNAME(src).c_str());
+            m_display.print(src.getLine(UDL_CALL_NAME));
             m_display.setCursor(0,OLED_LINE3);
-            m_display.printf("Slot: %i %s %s%s",slotNo,type,group ? "TG: " : "",dst.c_str());
+            m_display.printf("Slot: %i %s %s%s",slotNo,type,group ? "TG: " : "",dst);
         }
         else
         {
             m_display.fillRect(0,OLED_LINE4,m_display.width(),40,BLACK);
             m_display.setCursor(0,OLED_LINE4);
-            m_display.printf("%s",CALLandNAME(src).c_str());
+            m_display.print(src.getLine(UDL_CALL_NAME));
             m_display.setCursor(0,OLED_LINE5);
-            m_display.printf("Slot: %i %s %s%s",slotNo,type,group ? "TG: " : "",dst.c_str());
+            m_display.printf("Slot: %i %s %s%s",slotNo,type,group ? "TG: " : "",dst);
         }
 
         m_display.fillRect(0,OLED_LINE6,m_display.width(),20,BLACK);
@@ -261,19 +260,19 @@ int COLED::writeDMRIntEx(unsigned int slotNo, const class CUserDBentry& src, boo
     {
         m_display.fillRect(0,OLED_LINE2,m_display.width(),m_display.height(),BLACK);
         m_display.setCursor(0,OLED_LINE2);
-        m_display.printf("%s",CALLandNAME(src).c_str());
+        m_display.print(src.getLine(UDL_CALL_NAME));
         m_display.setCursor(0,OLED_LINE3);
-        m_display.printf("Slot: %i %s %s%s",slotNo,type,group ? "TG: " : "",dst.c_str());
+        m_display.printf("Slot: %i %s %s%s",slotNo,type,group ? "TG: " : "",dst);
         m_display.setCursor(0,OLED_LINE4);
-        m_display.printf("%s",src.get(keyCITY).c_str());
+        m_display.printf("%s",src.get(UDF_CITY));
         m_display.setCursor(0,OLED_LINE5);
-        m_display.printf("%s",src.get(keySTATE).c_str());
+        m_display.printf("%s",src.get(UDF_STATE));
         m_display.setCursor(0,OLED_LINE6);
-        m_display.printf("%s",src.get(keyCOUNTRY).c_str());
+        m_display.printf("%s",src.get(UDF_COUNTRY));
     }
 
     OLED_statusbar();
-    m_display.display();
+    sendBuffer();
 
     // must be 0, to avoid calling writeDMRInt() from CDisplay::writeDMR()
     return 0;
@@ -304,7 +303,7 @@ void COLED::clearDMRInt(unsigned int slotNo)
     m_display.fillRect(0, OLED_LINE6, m_display.width(), 20, BLACK);
     m_display.setCursor(0,OLED_LINE6);
     m_display.printf("%s",m_ipaddress.c_str());
-    m_display.display();
+    sendBuffer();
 }
 
 void COLED::writePOCSAGInt(uint32_t ric, const std::string& message)
@@ -366,7 +365,7 @@ void COLED::writePOCSAGInt(uint32_t ric, const std::string& message)
     m_display.setTextWrap(false);
 
     OLED_statusbar();
-    m_display.display();
+    sendBuffer();
 
 }
 
@@ -380,7 +379,7 @@ void COLED::clearPOCSAGInt()
     m_display.setCursor(0,OLED_LINE6);
     m_display.printf("%s",m_ipaddress.c_str());
 
-    m_display.display();
+    sendBuffer();
 }
 
 void COLED::writeCWInt()
@@ -392,7 +391,7 @@ void COLED::writeCWInt()
     m_display.print("CW TX");
 
     m_display.setTextSize(1);
-    m_display.display();
+    sendBuffer();
     if (m_displayScroll)
         m_display.startscrollleft(0x02,0x0f);
 }
@@ -406,7 +405,7 @@ void COLED::clearCWInt()
     m_display.print("Idle");
 
     m_display.setTextSize(1);
-    m_display.display();
+    sendBuffer();
     if (m_displayScroll)
         m_display.startscrollleft(0x02,0x0f);
 }
@@ -420,11 +419,18 @@ void COLED::close()
     m_display.setCursor(0,00);
     m_display.setTextSize(2);
     m_display.print("-CLOSE-");
-    m_display.display();
+    sendBuffer();
 
     m_display.close();
 }
 
+// Every update sends the whole frame buffer
+void COLED::sendBuffer()
+{
+    m_display.display();
+    addWritten((unsigned int)(m_display.width() * m_display.height() / 8));
+}
+
 void COLED::OLED_statusbar()
 {
     m_display.stopscroll();
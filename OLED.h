@@ -52,8 +52,8 @@ public:
   virtual void setErrorInt(const char* text) override;
   virtual void setQuitInt() override;
 
-  virtual void writeDMRInt(unsigned int slotNo, const std::string& src, bool group, const std::string& dst, const char* type) override;
-  virtual int writeDMRIntEx(unsigned int slotNo, const class CUserDBentry& src, bool group, const std::string& dst, const char* type);
+  virtual void writeDMRInt(unsigned int slotNo, const char* src, bool group, const char* dst, const char* type) override;
+  virtual int writeDMRIntEx(unsigned int slotNo, const class CUserDBentry& src, bool group, const char* dst, const char* type) override;
   virtual void clearDMRInt(unsigned int slotNo) override;
 
   virtual void writePOCSAGInt(uint32_t ric, const std::string& message) override;
@@ -79,5 +79,6 @@ private:
   ArduiPi_OLED  m_display;
 
   void OLED_statusbar();
+  void sendBuffer();
 };
 #endif
@@ -0,0 +1,135 @@
+/*
+ *   Copyright (C) 2026 by BrandMeister
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "Reactor.h"
+#include "Log.h"
+
+#include <cassert>
+#include <cerrno>
+
+#include <sys/epoll.h>
+#include <unistd.h>
+
+const unsigned int MAX_EVENTS = 16U;
+
+IReactorHandler::~IReactorHandler()
+{
+}
+
+CReactor::CReactor() :
+m_fd(-1),
+m_handlers(),
+m_wakeups(0ULL)
+{
+}
+
+CReactor::~CReactor()
+{
+}
+
+bool CReactor::open()
+{
+	m_fd = ::epoll_create1(EPOLL_CLOEXEC);
+	if (m_fd < 0) {
+		LogError("Cannot create the epoll instance, err: %d", errno);
+		return false;
+	}
+
+	return true;
+}
+
+bool CReactor::add(int fd, IReactorHandler* handler)
+{
+	assert(m_fd >= 0);
+	assert(fd >= 0);
+	assert(handler != NULL);
+
+	struct epoll_event ev;
+	ev.events  = EPOLLIN;
+	ev.data.fd = fd;
+
+	if (::epoll_ctl(m_fd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+		LogError("Cannot add descriptor %d to epoll, err: %d", fd, errno);
+		return false;
+	}
+
+	m_handlers[fd] = handler;
+
+	return true;
+}
+
+void CReactor::remove(int fd)
+{
+	if (m_handlers.erase(fd) == 0U)
+		return;
+
+	::epoll_ctl(m_fd, EPOLL_CTL_DEL, fd, NULL);
+}
+
+int CReactor::wait(int timeout)
+{
+	assert(m_fd >= 0);
+
+	struct epoll_event events[MAX_EVENTS];
+
+	int n = ::epoll_wait(m_fd, events, MAX_EVENTS, timeout);
+	if (n < 0) {
+		if (errno == EINTR)
+			return 0;
+
+		LogError("Error returned from epoll_wait, err: %d", errno);
+		return -1;
+	}
+
+	m_wakeups.fetch_add(1U, std::memory_order_relaxed);
+
+	for (int i = 0; i < n; i++) {
+		int fd = events[i].data.fd;
+
+		// A previous handler in this batch may have removed it
+		auto it = m_handlers.find(fd);
+		if (it == m_handlers.end())
+			continue;
+
+		bool keep = it->second->readable(fd);
+
+		if (!keep || (events[i].events & EPOLLHUP) != 0U) {
+			if (keep)
+				LogWarning("Descriptor %d has hung up, no longer watching it", fd);
+			remove(fd);
+		}
+	}
+
+	return n;
+}
+
+void CReactor::close()
+{
+	if (m_fd < 0)
+		return;
+
+	m_handlers.clear();
+
+	::close(m_fd);
+	m_fd = -1;
+}
+
+unsigned long long CReactor::getWakeups() const
+{
+	return m_wakeups.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,55 @@
+/*
+ *   Copyright (C) 2026 by BrandMeister
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <unordered_map>
+
+class IReactorHandler {
+public:
+	virtual ~IReactorHandler() = 0;
+
+	// Called when fd is readable or has hung up, return false to stop watching it
+	virtual bool readable(int fd) = 0;
+
+private:
+};
+
+class CReactor {
+public:
+	CReactor();
+	~CReactor();
+
+	bool open();
+
+	bool add(int fd, IReactorHandler* handler);
+	void remove(int fd);
+
+	// Sleep until at least one descriptor is ready, or timeout ms (-1 = forever)
+	int  wait(int timeout = -1);
+
+	void close();
+
+	unsigned long long getWakeups() const;
+
+private:
+	int                                       m_fd;
+	std::unordered_map<int, IReactorHandler*> m_handlers;
+	std::atomic<unsigned long long>           m_wakeups;	// may be read by other threads
+};
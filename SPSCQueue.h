@@ -0,0 +1,118 @@
+/*
+ *   Copyright (C) 2026 by BrandMeister
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cassert>
+
+// Bounded lock-free queue for exactly one producer thread and one consumer thread
+template<class T> class CSPSCQueue {
+public:
+	CSPSCQueue(unsigned int size) :
+	m_size(1U),
+	m_items(NULL),
+	m_pad1(),
+	m_head(0U),
+	m_pad2(),
+	m_tail(0U),
+	m_maxDepth(0U),
+	m_overflows(0ULL)
+	{
+		assert(size > 0U);
+
+		// A power of two lets the indexes wrap with a mask
+		while (m_size < size)
+			m_size <<= 1;
+
+		m_items = new T[m_size];
+	}
+
+	~CSPSCQueue()
+	{
+		delete[] m_items;
+	}
+
+	// Producer side, returns false and counts an overflow when the queue is full
+	bool push(const T& item)
+	{
+		unsigned int tail = m_tail.load(std::memory_order_relaxed);
+		unsigned int head = m_head.load(std::memory_order_acquire);
+
+		unsigned int depth = tail - head;
+		if (depth >= m_size) {
+			m_overflows.fetch_add(1U, std::memory_order_relaxed);
+			return false;
+		}
+
+		m_items[tail & (m_size - 1U)] = item;
+		m_tail.store(tail + 1U, std::memory_order_release);
+
+		if (depth + 1U > m_maxDepth.load(std::memory_order_relaxed))
+			m_maxDepth.store(depth + 1U, std::memory_order_relaxed);
+
+		return true;
+	}
+
+	// Consumer side
+	bool pop(T& item)
+	{
+		unsigned int head = m_head.load(std::memory_order_relaxed);
+		unsigned int tail = m_tail.load(std::memory_order_acquire);
+
+		if (head == tail)
+			return false;
+
+		item = m_items[head & (m_size - 1U)];
+		m_head.store(head + 1U, std::memory_order_release);
+
+		return true;
+	}
+
+	unsigned int depth() const
+	{
+		return m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_acquire);
+	}
+
+	unsigned int size() const
+	{
+		return m_size;
+	}
+
+	unsigned int getMaxDepth() const
+	{
+		return m_maxDepth.load(std::memory_order_relaxed);
+	}
+
+	unsigned long long getOverflows() const
+	{
+		return m_overflows.load(std::memory_order_relaxed);
+	}
+
+private:
+	unsigned int m_size;
+	T*           m_items;
+
+	// Keep the producer and consumer indexes on separate cache lines
+	char                            m_pad1[64U];
+	std::atomic<unsigned int>       m_head;
+	char                            m_pad2[64U];
+	std::atomic<unsigned int>       m_tail;
+	std::atomic<unsigned int>       m_maxDepth;
+	std::atomic<unsigned long long> m_overflows;
+};
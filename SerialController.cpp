@@ -207,6 +207,13 @@ int CSerialController::read(unsigned char* buffer, unsigned int length)
 				}
 			}
 
+			// Readable but nothing to read means the device has hung up, unlike
+			// no data yet which select() has already returned 0 for
+			if (len == 0) {
+				LogError("The serial port has hung up");
+				return -1;
+			}
+
 			if (len > 0)
 				offset += len;
 		}
@@ -270,3 +277,7 @@ void CSerialController::close()
 	m_fd = -1;
 }
 
+int CSerialController::getFd() const
+{
+	return m_fd;
+}
@@ -36,6 +36,8 @@ public:
 
 	virtual void close() override;
 
+	virtual int getFd() const override;
+
 #if defined(__APPLE__)
 	virtual int setNonblock(bool nonblock);
 #endif
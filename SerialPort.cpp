@@ -21,3 +21,8 @@
 ISerialPort::~ISerialPort()
 {
 }
+
+int ISerialPort::getFd() const
+{
+	return -1;
+}
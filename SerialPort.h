@@ -30,5 +30,8 @@ public:
 
 	virtual void close() = 0;
 
+	// Descriptor to wait on for incoming data, -1 if the port has none
+	virtual int getFd() const;
+
 private:
 };
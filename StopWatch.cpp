@@ -21,7 +21,8 @@
 #include <ctime>
 
 CStopWatch::CStopWatch() :
-m_startMS(0ULL)
+m_startMS(0ULL),
+m_startUS(0ULL)
 {
 }
 
@@ -43,6 +44,7 @@ unsigned long long CStopWatch::start()
 	::clock_gettime(CLOCK_MONOTONIC, &now);
 
 	m_startMS = now.tv_sec * 1000ULL + now.tv_nsec / 1000000ULL;
+	m_startUS = now.tv_sec * 1000000ULL + now.tv_nsec / 1000ULL;
 
 	return m_startMS;
 }
@@ -56,3 +58,13 @@ unsigned int CStopWatch::elapsed()
 
 	return nowMS - m_startMS;
 }
+
+unsigned int CStopWatch::elapsedUS()
+{
+	struct timespec now;
+	::clock_gettime(CLOCK_MONOTONIC, &now);
+
+	unsigned long long nowUS = now.tv_sec * 1000000ULL + now.tv_nsec / 1000ULL;
+
+	return nowUS - m_startUS;
+}
@@ -30,7 +30,9 @@ public:
 
 	unsigned long long start();
 	unsigned int       elapsed();
+	unsigned int       elapsedUS();
 
 private:
 	unsigned long long m_startMS;
+	unsigned long long m_startUS;
 };
@@ -89,7 +89,8 @@ m_duplex(duplex),
 m_refresh(false),
 m_refreshTimer(1000U, 0U, REFRESH_PERIOD),
 m_lineBuf(NULL),
-m_temp()
+m_temp(),
+m_commandDelay(5U)
 {
 	assert(serial != NULL);
 }
@@ -159,7 +160,7 @@ void CTFTSurenoo::setQuitInt()
 	m_mode = MODE_QUIT;
 }
 
-void CTFTSurenoo::writeDMRInt(unsigned int slotNo, const std::string& src, bool group, const std::string& dst, const char* type)
+void CTFTSurenoo::writeDMRInt(unsigned int slotNo, const char* src, bool group, const char* dst, const char* type)
 {
 	assert(type != NULL);
 
@@ -174,16 +175,16 @@ void CTFTSurenoo::writeDMRInt(unsigned int slotNo, const std::string& src, bool
 	}		
 
 	int pos = m_duplex ? (slotNo - 1) : 0;
-	::snprintf(m_temp, sizeof(m_temp), "%s %s", type, src.c_str());
+	::snprintf(m_temp, sizeof(m_temp), "%s %s", type, src);
 	setStatusLine(statusLineNo(pos * 2), m_temp);
 
-	::snprintf(m_temp, sizeof(m_temp), "TS%u %s%s", slotNo, group ? "TG" : "", dst.c_str());
+	::snprintf(m_temp, sizeof(m_temp), "TS%u %s%s", slotNo, group ? "TG" : "", dst);
 	setStatusLine(statusLineNo(pos * 2 + 1), m_temp);
 
 	m_mode = MODE_DMR;
 }
 
-int CTFTSurenoo::writeDMRIntEx(unsigned int slotNo, const class CUserDBentry& src, bool group, const std::string& dst, const char* type)
+int CTFTSurenoo::writeDMRIntEx(unsigned int slotNo, const class CUserDBentry& src, bool group, const char* dst, const char* type)
 {
 	assert(type != NULL);
 
@@ -192,10 +193,10 @@ int CTFTSurenoo::writeDMRIntEx(unsigned int slotNo, const class CUserDBentry& sr
 		return -1;
 
 	setModeLine(STR_DMR);
-	setStatusLine(statusLineNo(2), (src.get(keyFIRST_NAME) + " " + src.get(keyLAST_NAME)).c_str());
-	setStatusLine(statusLineNo(3), src.get(keyCITY).c_str());
-	setStatusLine(statusLineNo(4), src.get(keySTATE).c_str());
-	setStatusLine(statusLineNo(5), src.get(keyCOUNTRY).c_str());
+	setStatusLine(statusLineNo(2), src.getLine(UDL_FULL_NAME));
+	setStatusLine(statusLineNo(3), src.get(UDF_CITY));
+	setStatusLine(statusLineNo(4), src.get(UDF_STATE));
+	setStatusLine(statusLineNo(5), src.get(UDF_COUNTRY));
 
 	m_mode = MODE_DMR;
 
@@ -258,6 +259,37 @@ void CTFTSurenoo::clockInt(unsigned int ms)
 	}
 }
 
+unsigned int CTFTSurenoo::getTimeoutInt()
+{
+	// Nothing to refresh, no need to wake up
+	if (!m_refresh)
+		return 0U;
+
+	return m_refreshTimer.getRemainingMS();
+}
+
+void CTFTSurenoo::setCommandDelay(unsigned int ms)
+{
+	m_commandDelay = ms;
+}
+
+int CTFTSurenoo::getFd()
+{
+	return m_serial->getFd();
+}
+
+bool CTFTSurenoo::read()
+{
+	// Discard the "OK" acknowledgements sent back for each command
+	unsigned char c;
+	int n;
+	while ((n = m_serial->read(&c, 1U)) > 0)
+		;
+
+	// 0 once drained, -1 when the port has failed or hung up
+	return n == 0;
+}
+
 void CTFTSurenoo::setLineBuffer(char *buf, const char *text, int maxchar)
 {
 	int i;
@@ -288,24 +320,25 @@ void CTFTSurenoo::refreshDisplay(void)
 
 	// send CR+LF to avoid first command is not processed
 	::snprintf(m_temp, sizeof(m_temp), STR_CRLF);
-	m_serial->write((unsigned char*)m_temp, (unsigned int)::strlen(m_temp));
+	sendTemp();
 
 	// config display
 	setRotation(ROTATION_LANDSCAPE);
 	setBrightness(m_brightness);
 	setBackground(BG_COLOUR);
-	m_serial->write((unsigned char*)m_temp, (unsigned int)::strlen(m_temp));
-	CThread::sleep(5);
+	sendTemp();
+	if (m_commandDelay > 0U)
+		CThread::sleep(m_commandDelay);
 
 	// clear display
 	::snprintf(m_temp, sizeof(m_temp), "BOXF(%d,%d,%d,%d,%d);",
 		   0, 0, X_WIDTH - 1, Y_WIDTH - 1, BG_COLOUR);
-	m_serial->write((unsigned char*)m_temp, ::strlen(m_temp));
+	sendTemp();
 
 	// mode line
 	::snprintf(m_temp, sizeof(m_temp), "DCV%d(%d,%d,'%s',%d);",
 		   MODE_FONT_SIZE, 0, 0, m_lineBuf, MODE_COLOUR);
-	m_serial->write((unsigned char*)m_temp, (unsigned int)::strlen(m_temp));
+	sendTemp();
 
 	// status line
 	for (int i = 0; i < STATUS_LINES; i++) {
@@ -316,44 +349,53 @@ void CTFTSurenoo::refreshDisplay(void)
 			   STATUS_FONT_SIZE, 0,
 			   STATUS_MARGIN + STATUS_FONT_SIZE * i, p,
 			   (!m_duplex && i >= INFO_LINES) ? EXT_COLOUR : INFO_COLOUR);
-		m_serial->write((unsigned char*)m_temp, (unsigned int)::strlen(m_temp));
+		sendTemp();
 	}
 
 	// sending CR+LF finishes commands
 	::snprintf(m_temp, sizeof(m_temp), STR_CRLF);
-	m_serial->write((unsigned char*)m_temp, (unsigned int)::strlen(m_temp));
+	sendTemp();
 
 	m_refresh = false;
 }
 
+// Sends the command in m_temp
+void CTFTSurenoo::sendTemp(void)
+{
+	unsigned int length = (unsigned int)::strlen(m_temp);
+
+	m_serial->write((unsigned char*)m_temp, length);
+	addWritten(length);
+}
+
 void CTFTSurenoo::lcdReset(void)
 {
 	::snprintf(m_temp, sizeof(m_temp), "RESET;" STR_CRLF);
-	m_serial->write((unsigned char*)m_temp, (unsigned int)::strlen(m_temp));
+	sendTemp();
 	CThread::sleep(250);	// document says 230ms
 }
 
 void CTFTSurenoo::clearScreen(unsigned char colour)
 {
 	::snprintf(m_temp, sizeof(m_temp), "CLR(%d);" STR_CRLF, colour);
-	m_serial->write((unsigned char*)m_temp, (unsigned int)::strlen(m_temp));
+	sendTemp();
 	CThread::sleep(100);	// at least 60ms (@240x320 panel)
 }
 
 void CTFTSurenoo::setBackground(unsigned char colour)
 {
 	::snprintf(m_temp, sizeof(m_temp), "SBC(%d);", colour);
-	m_serial->write((unsigned char*)m_temp, (unsigned int)::strlen(m_temp));
+	sendTemp();
 }
 
 void CTFTSurenoo::setRotation(unsigned char rotation)
 {
 	::snprintf(m_temp, sizeof(m_temp), "DIR(%d);", rotation);
-	m_serial->write((unsigned char*)m_temp, (unsigned int)::strlen(m_temp));
+	sendTemp();
 }
 
 void CTFTSurenoo::setBrightness(unsigned char brightness)
 {
 	::snprintf(m_temp, sizeof(m_temp), "BL(%d);", brightness);
-	m_serial->write((unsigned char*)m_temp, (unsigned int)::strlen(m_temp));
+	sendTemp();
 }
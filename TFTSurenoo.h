@@ -38,13 +38,19 @@ public:
 
   virtual void close() override;
 
+  virtual int  getFd() override;
+  virtual bool read() override;
+
+  // Pause after setting the panel up on each refresh so it can keep up, 0 for none
+  void setCommandDelay(unsigned int ms);
+
 protected:
 	virtual void setIdleInt() override;
 	virtual void setErrorInt(const char* text) override;
 	virtual void setQuitInt() override;
 
-	virtual void writeDMRInt(unsigned int slotNo, const std::string& src, bool group, const std::string& dst, const char* type) override;
-	virtual int writeDMRIntEx(unsigned int slotNo, const class CUserDBentry& src, bool group, const std::string& dst, const char* type);
+	virtual void writeDMRInt(unsigned int slotNo, const char* src, bool group, const char* dst, const char* type) override;
+	virtual int writeDMRIntEx(unsigned int slotNo, const class CUserDBentry& src, bool group, const char* dst, const char* type) override;
 	virtual void clearDMRInt(unsigned int slotNo) override;
 
 	virtual void writePOCSAGInt(uint32_t ric, const std::string& message) override;
@@ -54,6 +60,7 @@ protected:
 	virtual void clearCWInt() override;
 
 	virtual void clockInt(unsigned int ms) override;
+	virtual unsigned int getTimeoutInt() override;
 
 private:
    std::string   m_callsign;
@@ -66,11 +73,13 @@ private:
    CTimer        m_refreshTimer;
    char*         m_lineBuf;
    char          m_temp[128];
+   unsigned int  m_commandDelay;
 
   void setLineBuffer(char *buf, const char *text, int maxchar);
   void setModeLine(const char *text);
   void setStatusLine(unsigned int line, const char *text);
   void refreshDisplay(void);
+  void sendTemp(void);
 
   void lcdReset(void);
   void clearScreen(unsigned char colour);
@@ -36,6 +36,18 @@ public:
 		return (m_timeout - m_timer) / m_ticksPerSec;
 	}
 
+	// Time until expiry in ms, 0 when stopped or already expired
+	unsigned int getRemainingMS()
+	{
+		if (m_timeout == 0U || m_timer == 0U)
+			return 0U;
+
+		if (m_timer >= m_timeout)
+			return 0U;
+
+		return (unsigned int)(((m_timeout - m_timer) * 1000ULL + m_ticksPerSec - 1U) / m_ticksPerSec);
+	}
+
 	bool isRunning()
 	{
 		return m_timer > 0U;
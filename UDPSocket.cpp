@@ -196,6 +196,33 @@ int CUDPSocket::read(unsigned char* buffer, unsigned int length, sockaddr_storag
 	return len;
 }
 
+int CUDPSocket::read(struct mmsghdr* messages, unsigned int count)
+{
+	assert(messages != NULL);
+	assert(count > 0U);
+
+	if (m_fd < 0)
+		return 0;
+
+	// Take everything that is queued, up to count datagrams, in one call
+	int ret = ::recvmmsg(m_fd, messages, count, MSG_DONTWAIT, NULL);
+	if (ret < 0) {
+		if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+			return 0;
+
+		LogError("Error returned from recvmmsg, err: %d", errno);
+
+		if (errno == ENOTSOCK) {
+			LogMessage("Re-opening UDP port on %hu", m_port);
+			close();
+			open();
+		}
+		return -1;
+	}
+
+	return ret;
+}
+
 bool CUDPSocket::write(const unsigned char* buffer, unsigned int length, const sockaddr_storage& address, unsigned int address_length)
 {
 	assert(buffer != NULL);
@@ -220,3 +247,7 @@ void CUDPSocket::close()
 	::close(m_fd);
 }
 
+int CUDPSocket::getFd() const
+{
+	return m_fd;
+}
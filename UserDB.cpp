@@ -16,158 +16,492 @@
  *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
  */
 #include "UserDB.h"
+#include "UserDBJSON.h"
+#include "UserDBParser.h"
+#include "UserDBStream.h"
 #include "Log.h"
+#include "StopWatch.h"
+#include "Thread.h"
 
+#include <algorithm>
 #include <cstdio>
+#include <cstdlib>
 #include <cstring>
 #include <cctype>
 
-CUserDB::CUserDB() :
-m_table(),
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+// Below this a file isn't worth splitting between threads
+const size_t USERDB_MIN_CHUNK_SIZE = 256U * 1024U;
+
+// How much of a compressed or JSON file is parsed at a time
+const size_t USERDB_STREAM_BLOCK_SIZE = 256U * 1024U;
+
+// True if the first thing in the file opens a JSON object or array
+static bool isJSON(const std::string& filename)
+{
+	FILE* fp = ::fopen(filename.c_str(), "rb");
+	if (fp == NULL)
+		return false;
+
+	int c;
+	while ((c = ::fgetc(fp)) != EOF && ::isspace(c))
+		;
+
+	::fclose(fp);
+
+	return c == '{' || c == '[';
+}
+
+// The resident set size of the whole process in kB, 0 if it isn't known
+static unsigned int getResident()
+{
+	FILE* fp = ::fopen("/proc/self/statm", "r");
+	if (fp == NULL)
+		return 0U;
+
+	unsigned long size, resident;
+	int n = ::fscanf(fp, "%lu %lu", &size, &resident);
+	::fclose(fp);
+
+	if (n != 2)
+		return 0U;
+
+	return (unsigned int)(resident * (unsigned long)::sysconf(_SC_PAGESIZE) / 1024UL);
+}
+
+CUserDB::CUserDB(unsigned int threads, bool upperCase) :
+m_threads(threads > 0U ? threads : 1U),
+m_upperCase(upperCase),
+m_filter(),
+m_maxEntries(0U),
+m_lazy(false),
+m_table(new CUserDBTable),
+m_readers(0U),
+m_generation(0U),
+m_size(0U),
+m_memory(0U),
+m_loadTime(0U),
 m_mutex()
 {
 }
 
 CUserDB::~CUserDB()
 {
+	delete m_table;
 }
 
 bool CUserDB::lookup(unsigned int id, class CUserDBentry *entry)
 {
-	bool rv;
+	// publish() frees a table only once m_readers has dropped to zero, a
+	// lookup counts itself before it loads the table pointer
+	m_readers.fetch_add(1U);
 
-	m_mutex.lock();
+	bool rv = m_table.load()->lookup(id, entry);
 
-	try {
-		if (entry != NULL)
-			*entry = m_table.at(id);
-		else
-			(void)m_table.at(id);
+	m_readers.fetch_sub(1U);
 
-		rv = true;
-	} catch (...) {
-		rv = false;
-	}
+	return rv;
+}
 
-	m_mutex.unlock();
+bool CUserDB::setFilter(const std::string& filter, unsigned int maxEntries)
+{
+	m_maxEntries = maxEntries;
 
-	return rv;
+	return m_filter.parse(filter);
+}
+
+void CUserDB::setLazy(bool lazy)
+{
+	m_lazy = lazy;
 }
 
 bool CUserDB::load(std::string const& filename)
 {
-	FILE* fp = ::fopen(filename.c_str(), "r");
-	if (fp == NULL) {
-		LogWarning("Cannot open ID lookup file - %s", filename.c_str());
+	CStopWatch watch;
+	watch.start();
+
+	// Build the new table without holding the lock, lookups carry on
+	// using the old one until it is swapped in
+	unsigned int skipped = 0U;
+	CUserDBTable* table  = NULL;
+	if (CUserDBTable::isCompiled(filename))
+		table = readCompiled(filename);
+	else if (CUserDBStream::getCompression(filename) != UDC_NONE || isJSON(filename))
+		table = readStream(filename, skipped);
+	else
+		table = readCSV(filename, skipped);
+
+	if (table == NULL)
 		return false;
+
+	// A CSV file is filtered while it is parsed, a compiled one is copied
+	// into memory with just the rows wanted
+	bool filtered = !m_filter.isEmpty() || m_maxEntries > 0U;
+	if (filtered && (table->isMapped() || (m_maxEntries > 0U && table->size() > m_maxEntries))) {
+		unsigned int dropped;
+		CUserDBTable* selected = table->select(m_filter, m_maxEntries, dropped);
+
+		delete table;
+		table    = selected;
+		skipped += dropped;
 	}
 
-	m_mutex.lock();
+	unsigned int size = table->size();
+	size_t memory     = table->getMemory();
+	bool mapped       = table->isMapped();
+	bool lazy         = table->isLazy();
 
-	// Remove the old entries;
-	m_table.clear();
+	unsigned int added, changed, removed;
+	publish(table, added, changed, removed);
 
-	// set index for entries
-	char buffer[256U];
-	if (::fgets(buffer, sizeof(buffer), fp) == NULL) {
-		LogWarning("ID lookup file has no entry - %s", filename.c_str());
-		m_mutex.unlock();
-		::fclose(fp);
-		return false;
+#if defined(__GLIBC__)
+	// Hand the memory used while building back to the system
+	if (!mapped)
+		::malloc_trim(0U);
+#endif
+
+	unsigned int ms = watch.elapsed();
+
+	m_size.store(size, std::memory_order_relaxed);
+	m_memory.store(memory, std::memory_order_relaxed);
+	m_loadTime.store(ms, std::memory_order_relaxed);
+
+	LogInfo("%s %u IDs to lookup table (%u kB), %u added, %u changed, %u removed in %u ms - %s", mapped ? "Mapped" : (lazy ? "Indexed" : "Loaded"),
+		size, (unsigned int)(memory / 1024U), added, changed, removed, ms, filename.c_str());
+
+	if (filtered)
+		LogInfo("Kept %u IDs and skipped %u by the filter, resident memory %u kB", size, skipped, getResident());
+
+	return size != 0U;
+}
+
+CUserDBTable* CUserDB::readCSV(std::string const& filename, unsigned int& skipped)
+{
+	int fd = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd < 0) {
+		LogWarning("Cannot open ID lookup file - %s", filename.c_str());
+		return NULL;
 	}
 
-	// no index - set default
-	std::unordered_map<std::string, int> index;
-	if (!makeindex(buffer, index)) {
-		::strncpy(buffer, keyRADIO_ID "," keyCALLSIGN "," keyFIRST_NAME, sizeof(buffer));
-		makeindex(buffer, index);
-		::rewind(fp);
+	struct stat st;
+	if (::fstat(fd, &st) < 0 || st.st_size == 0) {
+		LogWarning("ID lookup file has no entry - %s", filename.c_str());
+		::close(fd);
+		return NULL;
 	}
 
-	while (::fgets(buffer, sizeof(buffer), fp) != NULL) {
-		if (buffer[0U] != '#')
-			parse(buffer, index);
+	size_t size = st.st_size;
+
+	// A lazy table keeps the file open, to check that it hasn't been rewritten
+	void* map = ::mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (!m_lazy || map == MAP_FAILED)
+		::close(fd);
+
+	if (map == MAP_FAILED) {
+		LogError("Cannot map the ID lookup file - %s", filename.c_str());
+		return NULL;
 	}
 
-	::fclose(fp);
+	::madvise(map, size, MADV_SEQUENTIAL);
 
-	size_t size = m_table.size();
-	m_mutex.unlock();
+	const char* p   = (const char*)map;
+	const char* end = p + size;
 
-	LogInfo("Loaded %u IDs to lookup table - %s", size, filename.c_str());
+	std::vector<int> index;
+	p = readHeader(p, end, index);
 
-	return size != 0U;
-}
+	// Split the rest into newline aligned chunks, the first is parsed on
+	// this thread and the others each on a thread of their own
+	unsigned int threads = m_threads;
+	if (size_t(end - p) < threads * USERDB_MIN_CHUNK_SIZE)
+		threads = size_t(end - p) / USERDB_MIN_CHUNK_SIZE + 1U;
 
-bool CUserDB::makeindex(char* buf, std::unordered_map<std::string, int>& index)
-{
-	int i;
-	char *p1, *p2;
+	std::vector<CUserDBParser*> parsers;
 
-	// Remove the old index
-	index.clear();
+	const char* begin = p;
+	for (unsigned int i = 1U; i <= threads; i++) {
+		const char* chunkEnd = end;
 
-	for (i = 0, p1 = tokenize(buf, &p2); p1 != NULL;
-	     i++, p1 = tokenize(p2, &p2)) {
+		if (i < threads) {
+			chunkEnd = std::max(begin, p + (end - p) / threads * i);
 
-		// create [column keyword] - [column number] table
-		if (CUserDBentry::isValidKey(p1))
-			index[p1] = i;
+			const char* eol = (const char*)::memchr(chunkEnd, '\n', end - chunkEnd);
+			chunkEnd = eol != NULL ? eol + 1 : end;
+		}
+
+		parsers.push_back(new CUserDBParser(begin, chunkEnd, index, m_upperCase, m_filter.isEmpty() ? NULL : &m_filter, m_lazy ? (const char*)map : NULL));
+		begin = chunkEnd;
 	}
 
-	try {
-		(void)index.at(keyRADIO_ID);
-		(void)index.at(keyCALLSIGN);
-		return true;
-	} catch (...) {
-		return false;
+	std::vector<bool> started(parsers.size(), false);
+	for (unsigned int i = 1U; i < parsers.size(); i++)
+		started[i] = parsers[i]->run();
+
+	parsers[0U]->parse();
+
+	// The others are appended to the first chunk's table in file order, so
+	// the last of several rows with the same ID still wins. A chunk whose
+	// thread couldn't be started is parsed here.
+	CUserDBTable* table = parsers[0U]->release();
+	skipped = parsers[0U]->getSkipped();
+	delete parsers[0U];
+
+	for (unsigned int i = 1U; i < parsers.size(); i++) {
+		if (started[i])
+			parsers[i]->wait();
+		else
+			parsers[i]->parse();
+
+		CUserDBTable* chunk = parsers[i]->release();
+		table->append(*chunk);
+		skipped += parsers[i]->getSkipped();
+
+		delete chunk;
+		delete parsers[i];
+	}
+
+	if (m_lazy) {
+		// Only the lines looked up are needed from now on, drop the pages
+		// the index was built from
+		::madvise(map, size, MADV_RANDOM);
+		::madvise(map, size, MADV_DONTNEED);
+
+		table->attach(map, size, fd, index, m_upperCase);
+	} else {
+		::munmap(map, size);
 	}
+
+	table->finish();
+
+	return table;
 }
 
-void CUserDB::parse(char* buf, std::unordered_map<std::string, int>& index)
+// Reads the file a block at a time, through the decompressor if it is
+// compressed, and parses each block's whole lines or JSON as it comes
+CUserDBTable* CUserDB::readStream(std::string const& filename, unsigned int& skipped)
 {
-	int i;
-	char *p1, *p2;
-	std::unordered_map<std::string, char*> ptr;
-	unsigned int id;
+	CUserDBStream stream;
+	if (!stream.open(filename))
+		return NULL;
 
-	for (i = 0, p1 = tokenize(buf, &p2); p1 != NULL;
-	     i++, p1 = tokenize(p2, &p2)) {
+	std::vector<char> buffer(USERDB_STREAM_BLOCK_SIZE);
+	size_t used = 0U;		// bytes not parsed yet
+	bool eof    = false;
+
+	std::vector<int> index;
+	CUserDBParser* parser = NULL;
+	CUserDBJSON* json     = NULL;
+	bool ok               = true;
+
+	while (!eof && ok) {
+		// A line longer than the buffer
+		if (used == buffer.size())
+			buffer.resize(buffer.size() * 2U);
+
+		int n = stream.read(buffer.data() + used, buffer.size() - used);
+		if (n < 0) {
+			ok = false;
+			break;
+		}
+
+		eof   = n == 0;
+		used += n;
+
+		const char* begin = buffer.data();
+		const char* end   = begin + used;
+
+		if (parser == NULL) {
+			const char* p = begin;
+			while (p < end && ::isspace((unsigned char)*p))
+				p++;
+
+			if (p == end && !eof)
+				continue;
+
+			if (p < end && (*p == '{' || *p == '[')) {
+				parser = new CUserDBParser(begin, begin, index, m_upperCase, m_filter.isEmpty() ? NULL : &m_filter);
+				json   = new CUserDBJSON(*parser);
+			} else {
+				// The whole header line is needed first
+				const char* eol = (const char*)::memchr(begin, '\n', used);
+				if (eol == NULL && !eof)
+					continue;
 
-		for (auto it = index.begin(); it != index.end(); it++) {
-			// first: column keyword, second: column number
-			if (it->second == i) {
-				ptr[it->first] = p1;
-				break;
+				const char* rows = readHeader(begin, end, index);
+				parser = new CUserDBParser(begin, begin, index, m_upperCase, m_filter.isEmpty() ? NULL : &m_filter);
+
+				used -= rows - begin;
+				::memmove(buffer.data(), rows, used);
+				end = begin + used;
 			}
 		}
+
+		if (json != NULL) {
+			ok   = json->feed(begin, used);
+			used = 0U;
+			continue;
+		}
+
+		// Parse the whole lines, the rest is kept for the next block
+		const char* last = end;
+		if (!eof) {
+			while (last > begin && last[-1] != '\n')
+				last--;
+		}
+
+		parser->parse(begin, last);
+
+		used = end - last;
+		::memmove(buffer.data(), last, used);
 	}
 
-	try {
-		(void)ptr.at(keyRADIO_ID);
-		(void)ptr.at(keyCALLSIGN);
-	} catch (...) {
-		return;
+	if (ok && json != NULL && !json->finish()) {
+		LogWarning("JSON ID lookup file ends part way through - %s", filename.c_str());
+		ok = false;
 	}
 
-	id = (unsigned int)::atoi(ptr[keyRADIO_ID]);
-	toupper_string(ptr[keyCALLSIGN]);
+	CUserDBTable* table = NULL;
 
-	for (auto it = ptr.begin(); it != ptr.end(); it++) {
-		// no need to regist radio ID
-		if (it->first == keyRADIO_ID)
-			continue;
+	if (ok && parser != NULL) {
+		table   = parser->release();
+		skipped = parser->getSkipped();
+		table->finish();
+	} else if (ok) {
+		LogWarning("ID lookup file has no entry - %s", filename.c_str());
+	}
+
+	delete json;
+	delete parser;
 
-		m_table[id].set(it->first, it->second);
+	return table;
+}
+
+CUserDBTable* CUserDB::readCompiled(std::string const& filename)
+{
+	CUserDBTable* table = new CUserDBTable;
+
+	if (!table->map(filename)) {
+		delete table;
+		return NULL;
 	}
+
+	return table;
+}
+
+// Swaps the new table in, then waits for the lookups that may still be
+// using the old one before freeing it. An identical table is dropped
+// and the current one kept.
+void CUserDB::publish(CUserDBTable* table, unsigned int& added, unsigned int& changed, unsigned int& removed)
+{
+	m_mutex.lock();
+
+	CUserDBTable* old = m_table.load();
+
+	old->diff(*table, added, changed, removed);
+
+	if (added == 0U && changed == 0U && removed == 0U) {
+		m_mutex.unlock();
+		delete table;
+		return;
+	}
+
+	// A lookup that sees the new generation is sure to see the new table
+	m_table.exchange(table);
+	m_generation++;
+
+	while (m_readers.load() != 0U)
+		CThread::sleep(1U);
+
+	m_mutex.unlock();
+
+	delete old;
+}
+
+unsigned int CUserDB::getGeneration() const
+{
+	return m_generation.load();
+}
+
+unsigned int CUserDB::getSize() const
+{
+	return m_size.load(std::memory_order_relaxed);
+}
+
+size_t CUserDB::getMemory() const
+{
+	return m_memory.load(std::memory_order_relaxed);
+}
+
+unsigned int CUserDB::getLoadTime() const
+{
+	return m_loadTime.load(std::memory_order_relaxed);
+}
+
+bool CUserDB::save(std::string const& filename)
+{
+	m_mutex.lock();
+
+	bool ret = m_table.load()->save(filename);
+
+	m_mutex.unlock();
+
+	return ret;
 }
 
-void CUserDB::toupper_string(char* str)
+// Sets the column index from the header line at p, or to the default
+// RADIO_ID,CALLSIGN,FIRST_NAME if there is none. Returns the start of the
+// first row.
+const char* CUserDB::readHeader(const char* p, const char* end, std::vector<int>& index)
 {
-	while (*str != '\0') {  
-		*str = ::toupper(*str);
-		str++;
+	// The header line is copied as the mapping is read only
+	const char* eol = (const char*)::memchr(p, '\n', end - p);
+	size_t length   = (eol != NULL ? eol : end) - p;
+
+	char buffer[256U];
+	if (length > sizeof(buffer) - 1U)
+		length = sizeof(buffer) - 1U;
+	::memcpy(buffer, p, length);
+	buffer[length] = '\0';
+
+	if (makeindex(buffer, index))
+		return eol != NULL ? eol + 1 : end;
+
+	::strncpy(buffer, keyRADIO_ID "," keyCALLSIGN "," keyFIRST_NAME, sizeof(buffer));
+	makeindex(buffer, index);
+
+	return p;
+}
+
+bool CUserDB::makeindex(char* buf, std::vector<int>& index)
+{
+	int i;
+	char *p1, *p2;
+	bool id = false, callsign = false;
+
+	// Remove the old index
+	index.clear();
+
+	for (i = 0, p1 = tokenize(buf, &p2); p1 != NULL;
+	     i++, p1 = tokenize(p2, &p2)) {
+
+		// create [column number] - [field] table
+		int field = ::strcmp(p1, keyRADIO_ID) == 0 ? USERDB_INDEX_RADIO_ID : CUserDBentry::getField(p1);
+		index.push_back(field);
+
+		id       = id || field == USERDB_INDEX_RADIO_ID;
+		callsign = callsign || field == UDF_CALLSIGN;
 	}
+
+	return id && callsign;
 }
 
 char* CUserDB::tokenize(char* str, char** next)
@@ -18,23 +18,63 @@
 
 #pragma once
 
-#include "UserDBentry.h"
+#include "UserDBFilter.h"
+#include "UserDBTable.h"
 #include "Mutex.h"
 
+#include <atomic>
+#include <string>
+#include <vector>
+
 class CUserDB {
 public:
-	CUserDB();
+	// threads is how many threads split the parsing of a CSV file, upperCase
+	// is false for tables whose CALLSIGN column holds names, not callsigns
+	CUserDB(unsigned int threads = 1U, bool upperCase = true);
 	~CUserDB();
 
+	// Set before the first load(), see CUserDBFilter. maxEntries limits
+	// the table to that many IDs, 0 for no limit.
+	bool setFilter(const std::string& filter, unsigned int maxEntries);
+
+	// Set before the first load(), a CSV file is then kept mapped and only
+	// indexed, see CUserDBTable
+	void setLazy(bool lazy);
+
+	// Takes no lock, a reload never blocks or empties lookups
 	bool lookup(unsigned int id, class CUserDBentry *entry);
 	bool load(std::string const& filename);
 
+	// Changes each time a different table is swapped in
+	unsigned int getGeneration() const;
+
+	// Of the last table loaded, for the metrics
+	unsigned int getSize() const;
+	size_t       getMemory() const;
+	unsigned int getLoadTime() const;	// ms
+
+	// Writes the loaded table as a compiled file that load() can mmap()
+	bool save(std::string const& filename);
+
 private:
-	bool makeindex(char* buf, std::unordered_map<std::string, int>& index);
-	void parse(char* buf, std::unordered_map<std::string, int>& index);
-	void toupper_string(char* str);
+	CUserDBTable* readCSV(std::string const& filename, unsigned int& skipped);
+	CUserDBTable* readStream(std::string const& filename, unsigned int& skipped);
+	CUserDBTable* readCompiled(std::string const& filename);
+	void publish(CUserDBTable* table, unsigned int& added, unsigned int& changed, unsigned int& removed);
+	const char* readHeader(const char* p, const char* end, std::vector<int>& index);
+	bool makeindex(char* buf, std::vector<int>& index);
 	char* tokenize(char* str, char** next);
 
-	std::unordered_map<unsigned int, class CUserDBentry>    m_table;
-	CMutex                                                  m_mutex;
+	unsigned int               m_threads;
+	bool                       m_upperCase;
+	CUserDBFilter              m_filter;
+	unsigned int               m_maxEntries;
+	bool                       m_lazy;
+	std::atomic<CUserDBTable*> m_table;
+	std::atomic<unsigned int>  m_readers;	// lookups in progress
+	std::atomic<unsigned int>  m_generation;
+	std::atomic<unsigned int>  m_size;
+	std::atomic<size_t>        m_memory;
+	std::atomic<unsigned int>  m_loadTime;
+	CMutex                     m_mutex;	// serialises reloads and saves
 };
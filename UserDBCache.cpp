@@ -0,0 +1,94 @@
+/*
+ *   Copyright (C) 2026 by BrandMeister
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "UserDBCache.h"
+
+#include <cstdio>
+
+CUserDBCache::CUserDBCache() :
+m_ids(),
+m_used(),
+m_entries(),
+m_count(0U),
+m_tick(0ULL),
+m_generation(0U),
+m_hits(0ULL),
+m_misses(0ULL)
+{
+}
+
+CUserDBCache::~CUserDBCache()
+{
+}
+
+// With this few entries a scan of the packed IDs beats hashing
+const CUserDBentry* CUserDBCache::find(unsigned int id, unsigned int generation)
+{
+	if (generation != m_generation) {
+		clear();
+		m_generation = generation;
+	}
+
+	for (unsigned int i = 0U; i < m_count; i++) {
+		if (m_ids[i] == id) {
+			m_used[i] = ++m_tick;
+			m_hits.fetch_add(1U, std::memory_order_relaxed);
+			return &m_entries[i];
+		}
+	}
+
+	m_misses.fetch_add(1U, std::memory_order_relaxed);
+
+	return NULL;
+}
+
+const CUserDBentry& CUserDBCache::add(unsigned int id, const CUserDBentry& entry)
+{
+	unsigned int n = m_count;
+
+	if (m_count < USERDB_CACHE_SIZE) {
+		m_count++;
+	} else {
+		n = 0U;
+		for (unsigned int i = 1U; i < USERDB_CACHE_SIZE; i++) {
+			if (m_used[i] < m_used[n])
+				n = i;
+		}
+	}
+
+	m_ids[n]     = id;
+	m_used[n]    = ++m_tick;
+	m_entries[n] = entry;
+
+	return m_entries[n];
+}
+
+void CUserDBCache::clear()
+{
+	m_count = 0U;
+}
+
+unsigned long long CUserDBCache::getHits() const
+{
+	return m_hits.load(std::memory_order_relaxed);
+}
+
+unsigned long long CUserDBCache::getMisses() const
+{
+	return m_misses.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,56 @@
+/*
+ *   Copyright (C) 2026 by BrandMeister
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#pragma once
+
+#include "UserDBentry.h"
+
+#include <atomic>
+#include <cstdint>
+
+const unsigned int USERDB_CACHE_SIZE = 64U;
+
+// The most recently used IDs with their entries ready to display, unknown
+// IDs included. Owned by the one thread that does the lookups, so it
+// takes no lock, only the hit and miss counts may be read elsewhere.
+class CUserDBCache {
+public:
+	CUserDBCache();
+	~CUserDBCache();
+
+	// Everything cached under another generation of the table is dropped first
+	const CUserDBentry* find(unsigned int id, unsigned int generation);
+
+	// Replaces the least recently used entry once the cache is full
+	const CUserDBentry& add(unsigned int id, const CUserDBentry& entry);
+
+	void clear();
+
+	unsigned long long getHits() const;
+	unsigned long long getMisses() const;
+
+private:
+	uint32_t           m_ids[USERDB_CACHE_SIZE];
+	unsigned long long m_used[USERDB_CACHE_SIZE];
+	CUserDBentry       m_entries[USERDB_CACHE_SIZE];
+	unsigned int       m_count;
+	unsigned long long m_tick;
+	unsigned int       m_generation;
+	std::atomic<unsigned long long> m_hits;		// the counts are read by the metrics thread
+	std::atomic<unsigned long long> m_misses;
+};
@@ -0,0 +1,123 @@
+/*
+ *   Copyright (C) 2026 by BrandMeister
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "UserDBFilter.h"
+#include "Log.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <cctype>
+
+#include <strings.h>
+
+CUserDBFilter::CUserDBFilter() :
+m_prefixes(),
+m_rangeFrom(),
+m_rangeTo(),
+m_countries()
+{
+}
+
+CUserDBFilter::~CUserDBFilter()
+{
+}
+
+bool CUserDBFilter::parse(const std::string& filter)
+{
+	bool ret = true;
+
+	size_t start = 0U;
+	while (start < filter.length()) {
+		size_t end = filter.find(',', start);
+		if (end == std::string::npos)
+			end = filter.length();
+
+		size_t first = filter.find_first_not_of(" \t", start);
+		size_t last  = filter.find_last_not_of(" \t", end - 1U);
+
+		if (first < end && last != std::string::npos && last >= first) {
+			std::string item = filter.substr(first, last - first + 1U);
+			size_t dash      = item.find('-');
+
+			if (item.find_first_not_of("0123456789") == std::string::npos) {
+				unsigned int prefix = (unsigned int)::strtoul(item.c_str(), NULL, 10);
+
+				if (prefix == 0U) {
+					LogWarning("Ignoring the ID filter prefix %s", item.c_str());
+					ret = false;
+				} else {
+					m_prefixes.push_back(prefix);
+				}
+			} else if (dash != std::string::npos && dash > 0U && item.find_first_not_of("0123456789-") == std::string::npos &&
+				   item.find('-', dash + 1U) == std::string::npos && dash + 1U < item.length()) {
+				unsigned int from = (unsigned int)::strtoul(item.c_str(), NULL, 10);
+				unsigned int to   = (unsigned int)::strtoul(item.c_str() + dash + 1U, NULL, 10);
+
+				if (from > to) {
+					LogWarning("Ignoring the ID filter range %s", item.c_str());
+					ret = false;
+				} else {
+					m_rangeFrom.push_back(from);
+					m_rangeTo.push_back(to);
+				}
+			} else if (::isalpha((unsigned char)item[0U])) {
+				m_countries.push_back(item);
+			} else {
+				LogWarning("Ignoring the ID filter item %s", item.c_str());
+				ret = false;
+			}
+		}
+
+		start = end + 1U;
+	}
+
+	return ret;
+}
+
+bool CUserDBFilter::isEmpty() const
+{
+	return m_prefixes.empty() && m_rangeFrom.empty() && m_countries.empty();
+}
+
+bool CUserDBFilter::match(unsigned int id, const char* country, unsigned int countryLength) const
+{
+	if (isEmpty())
+		return true;
+
+	for (unsigned int i = 0U; i < m_rangeFrom.size(); i++) {
+		if (id >= m_rangeFrom[i] && id <= m_rangeTo[i])
+			return true;
+	}
+
+	// Drop trailing digits until the ID is no longer than the prefix
+	for (unsigned int i = 0U; i < m_prefixes.size(); i++) {
+		unsigned int value = id;
+		while (value > m_prefixes[i])
+			value /= 10U;
+
+		if (value == m_prefixes[i])
+			return true;
+	}
+
+	for (unsigned int i = 0U; i < m_countries.size(); i++) {
+		if (m_countries[i].length() == countryLength && ::strncasecmp(m_countries[i].c_str(), country, countryLength) == 0)
+			return true;
+	}
+
+	return false;
+}
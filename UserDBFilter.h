@@ -0,0 +1,46 @@
+/*
+ *   Copyright (C) 2026 by BrandMeister
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+// Which IDs a hotspot keeps in its lookup table. The filter is a comma
+// separated list of ID prefixes ("262"), ID ranges ("3100000-3169999")
+// and country names ("Germany"), an ID is kept if any of them matches.
+// An empty filter keeps everything.
+class CUserDBFilter {
+public:
+	CUserDBFilter();
+	~CUserDBFilter();
+
+	// False if an item couldn't be parsed, the others are still used
+	bool parse(const std::string& filter);
+
+	bool isEmpty() const;
+
+	// country need not be NUL terminated
+	bool match(unsigned int id, const char* country, unsigned int countryLength) const;
+
+private:
+	std::vector<unsigned int> m_prefixes;
+	std::vector<unsigned int> m_rangeFrom;
+	std::vector<unsigned int> m_rangeTo;
+	std::vector<std::string>  m_countries;
+};
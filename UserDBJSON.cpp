@@ -0,0 +1,332 @@
+/*
+ *   Copyright (C) 2026 by BrandMeister
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "UserDBJSON.h"
+#include "Log.h"
+
+#include <cstdlib>
+#include <cstring>
+
+#include <strings.h>
+
+// radioid.net's names for the fields, the CSV column names are tried after these
+struct JSONKey {
+	const char*  name;
+	int          field;
+};
+
+static const JSONKey JSON_KEYS[] = {
+	{ "radio_id", USERDB_INDEX_RADIO_ID },
+	{ "id",       USERDB_INDEX_RADIO_ID },
+	{ "callsign", UDF_CALLSIGN },
+	{ "fname",    UDF_FIRST_NAME },
+	{ "surname",  UDF_LAST_NAME },
+	{ "city",     UDF_CITY },
+	{ "state",    UDF_STATE },
+	{ "country",  UDF_COUNTRY }
+};
+
+static int getKeyField(const std::string& key)
+{
+	for (unsigned int i = 0U; i < sizeof(JSON_KEYS) / sizeof(JSON_KEYS[0U]); i++) {
+		if (::strcasecmp(key.c_str(), JSON_KEYS[i].name) == 0)
+			return JSON_KEYS[i].field;
+	}
+
+	for (unsigned int i = 0U; i < UDF_COUNT; i++) {
+		if (::strcasecmp(key.c_str(), CUserDBentry::keyList[i]) == 0)
+			return i;
+	}
+
+	return -1;
+}
+
+CUserDBJSON::CUserDBJSON(CUserDBParser& parser) :
+m_parser(parser),
+m_state(JS_VALUE),
+m_stack(),
+m_expectKey(false),
+m_key(),
+m_value(),
+m_unicode(0U),
+m_unicodeDigits(0U),
+m_surrogate(0U),
+m_fields(),
+m_hasField(),
+m_id(0U),
+m_hasId(false),
+m_rows(0U)
+{
+	m_key.reserve(32U);
+	m_value.reserve(256U);
+}
+
+CUserDBJSON::~CUserDBJSON()
+{
+}
+
+bool CUserDBJSON::feed(const char* data, unsigned int length)
+{
+	for (const char* p = data; p < data + length; p++) {
+		char c = *p;
+
+		switch (m_state) {
+			case JS_STRING:
+				// Copy up to the next quote or backslash in one go
+				if (c != '"' && c != '\\') {
+					const char* q = p;
+					while (q < data + length && *q != '"' && *q != '\\')
+						q++;
+
+					m_value.append(p, q - p);
+					p = q - 1;
+				} else if (c == '\\') {
+					m_state = JS_ESCAPE;
+				} else {
+					m_state = JS_VALUE;
+					endValue(true);
+				}
+				break;
+
+			case JS_ESCAPE:
+				m_state = JS_STRING;
+				switch (c) {
+					case 'b': m_value += '\b'; break;
+					case 'f': m_value += '\f'; break;
+					case 'n': m_value += '\n'; break;
+					case 'r': m_value += '\r'; break;
+					case 't': m_value += '\t'; break;
+					case 'u':
+						m_state         = JS_UNICODE;
+						m_unicode       = 0U;
+						m_unicodeDigits = 0U;
+						break;
+					default:  m_value += c; break;
+				}
+				break;
+
+			case JS_UNICODE: {
+				unsigned int digit;
+				if (c >= '0' && c <= '9')
+					digit = c - '0';
+				else if (c >= 'a' && c <= 'f')
+					digit = c - 'a' + 10U;
+				else if (c >= 'A' && c <= 'F')
+					digit = c - 'A' + 10U;
+				else {
+					error("bad \\u escape");
+					return false;
+				}
+
+				m_unicode = (m_unicode << 4) | digit;
+
+				if (++m_unicodeDigits == 4U) {
+					m_state = JS_STRING;
+					appendUTF8(m_unicode);
+				}
+				break;
+			}
+
+			case JS_LITERAL:
+				if ((c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || c == '-' || c == '+' || c == '.' || c == 'E') {
+					m_value += c;
+					break;
+				}
+
+				// Numbers are taken as they come, words must be one of JSON's
+				if (m_value[0U] >= 'a' && m_value[0U] <= 'z' && m_value != "true" && m_value != "false" && m_value != "null") {
+					error("unexpected literal");
+					return false;
+				}
+
+				m_state = JS_VALUE;
+				endValue(false);
+				p--;		// the delimiter is handled as a value
+				break;
+
+			case JS_VALUE:
+				switch (c) {
+					case ' ':
+					case '\t':
+					case '\r':
+					case '\n':
+						break;
+
+					case '{':
+						m_stack.push_back('{');
+						m_expectKey = true;
+						beginObject();
+						break;
+
+					case '[':
+						m_stack.push_back('[');
+						m_expectKey = false;
+						break;
+
+					case '}':
+					case ']':
+						if (m_stack.empty() || m_stack.back() != (c == '}' ? '{' : '[')) {
+							error("unbalanced brackets");
+							return false;
+						}
+
+						if (c == '}')
+							endObject();
+
+						m_stack.pop_back();
+						m_expectKey = false;
+						break;
+
+					case ',':
+						m_expectKey = !m_stack.empty() && m_stack.back() == '{';
+						break;
+
+					case ':':
+						m_expectKey = false;
+						break;
+
+					case '"':
+						m_state = JS_STRING;
+						m_value.clear();
+						break;
+
+					default:
+						if ((c >= '0' && c <= '9') || c == '-' || (c >= 'a' && c <= 'z')) {
+							m_state = JS_LITERAL;
+							m_value.assign(1U, c);
+						} else {
+							error("unexpected character");
+							return false;
+						}
+						break;
+				}
+				break;
+
+			default:
+				return false;
+		}
+	}
+
+	return true;
+}
+
+bool CUserDBJSON::finish() const
+{
+	return m_state != JS_ERROR && m_stack.empty() && (m_state == JS_VALUE || m_state == JS_LITERAL);
+}
+
+unsigned int CUserDBJSON::getRows() const
+{
+	return m_rows;
+}
+
+void CUserDBJSON::beginObject()
+{
+	for (unsigned int i = 0U; i < UDF_COUNT; i++) {
+		m_fields[i].clear();
+		m_hasField[i] = false;
+	}
+
+	m_id    = 0U;
+	m_hasId = false;
+}
+
+void CUserDBJSON::endObject()
+{
+	if (!m_hasId || !m_hasField[UDF_CALLSIGN])
+		return;
+
+	const char* fields[UDF_COUNT];
+	unsigned int lengths[UDF_COUNT];
+
+	for (unsigned int i = 0U; i < UDF_COUNT; i++) {
+		fields[i]  = m_hasField[i] ? m_fields[i].data() : NULL;
+		lengths[i] = m_fields[i].length();
+	}
+
+	m_parser.add(m_id, fields, lengths);
+	m_rows++;
+
+	// A nested object shouldn't give its parent's row a second time
+	beginObject();
+}
+
+void CUserDBJSON::endValue(bool string)
+{
+	if (m_expectKey) {
+		m_key.swap(m_value);
+		return;
+	}
+
+	if (m_stack.empty() || m_stack.back() != '{')
+		return;
+
+	int field = getKeyField(m_key);
+
+	if (field == USERDB_INDEX_RADIO_ID) {
+		// radio_id wins over id, whatever the order
+		if (m_hasId && ::strcasecmp(m_key.c_str(), "id") == 0)
+			return;
+
+		m_id    = (unsigned int)::strtoul(m_value.c_str(), NULL, 10);
+		m_hasId = m_value.length() > 0U && m_value[0U] >= '0' && m_value[0U] <= '9';
+	} else if (field >= 0 && (string || m_value != "null")) {
+		m_fields[field].swap(m_value);
+		m_hasField[field] = true;
+	}
+}
+
+void CUserDBJSON::appendUTF8(unsigned int c)
+{
+	if (c >= 0xD800U && c <= 0xDBFFU) {
+		m_surrogate = c;
+		return;
+	}
+
+	if (c >= 0xDC00U && c <= 0xDFFFU) {
+		if (m_surrogate == 0U)
+			return;
+
+		c = 0x10000U + ((m_surrogate - 0xD800U) << 10) + (c - 0xDC00U);
+	}
+
+	m_surrogate = 0U;
+
+	if (c < 0x80U) {
+		m_value += char(c);
+	} else if (c < 0x800U) {
+		m_value += char(0xC0U | (c >> 6));
+		m_value += char(0x80U | (c & 0x3FU));
+	} else if (c < 0x10000U) {
+		m_value += char(0xE0U | (c >> 12));
+		m_value += char(0x80U | ((c >> 6) & 0x3FU));
+		m_value += char(0x80U | (c & 0x3FU));
+	} else {
+		m_value += char(0xF0U | (c >> 18));
+		m_value += char(0x80U | ((c >> 12) & 0x3FU));
+		m_value += char(0x80U | ((c >> 6) & 0x3FU));
+		m_value += char(0x80U | (c & 0x3FU));
+	}
+}
+
+void CUserDBJSON::error(const char* reason)
+{
+	LogWarning("Malformed JSON ID lookup file, %s after %u users", reason, m_rows);
+
+	m_state = JS_ERROR;
+}
@@ -0,0 +1,74 @@
+/*
+ *   Copyright (C) 2026 by BrandMeister
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#pragma once
+
+#include "UserDBParser.h"
+
+#include <string>
+#include <vector>
+
+// A streaming (SAX style) reader for radioid.net's users.json. It is fed
+// the file in blocks of any size and adds each flat object that has a
+// radio_id (or id) and a callsign to the parser's table, so the whole
+// document is never held in memory. Keys are matched without regard to
+// case, the CSV column names are accepted too.
+class CUserDBJSON {
+public:
+	CUserDBJSON(CUserDBParser& parser);
+	~CUserDBJSON();
+
+	// False once the document is found to be malformed
+	bool feed(const char* data, unsigned int length);
+
+	// False if the document ended part way through
+	bool finish() const;
+
+	unsigned int getRows() const;
+
+private:
+	enum JSON_STATE {
+		JS_VALUE,
+		JS_STRING,
+		JS_ESCAPE,
+		JS_UNICODE,
+		JS_LITERAL,
+		JS_ERROR
+	};
+
+	CUserDBParser&    m_parser;
+	JSON_STATE        m_state;
+	std::vector<char> m_stack;		// '{' or '[' for each open container
+	bool              m_expectKey;
+	std::string       m_key;
+	std::string       m_value;
+	unsigned int      m_unicode;		// \uXXXX being read
+	unsigned int      m_unicodeDigits;
+	unsigned int      m_surrogate;		// a high surrogate waiting for its low half
+	std::string       m_fields[UDF_COUNT];
+	bool              m_hasField[UDF_COUNT];
+	unsigned int      m_id;
+	bool              m_hasId;
+	unsigned int      m_rows;
+
+	void beginObject();
+	void endObject();
+	void endValue(bool string);
+	void appendUTF8(unsigned int c);
+	void error(const char* reason);
+};
@@ -0,0 +1,313 @@
+/*
+ *   Copyright (C) 2026 by BrandMeister
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "UserDBParser.h"
+
+#include <cassert>
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+
+const char* CUserDBParser::findDelimiter(const char* p, const char* end)
+{
+#if defined(__SSE2__)
+	const __m128i comma = _mm_set1_epi8(',');
+	const __m128i tab   = _mm_set1_epi8('\t');
+	const __m128i cr    = _mm_set1_epi8('\r');
+	const __m128i lf    = _mm_set1_epi8('\n');
+
+	while (end - p >= 16) {
+		__m128i v = _mm_loadu_si128((const __m128i*)p);
+		__m128i m = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, comma), _mm_cmpeq_epi8(v, tab)),
+					 _mm_or_si128(_mm_cmpeq_epi8(v, cr), _mm_cmpeq_epi8(v, lf)));
+
+		int mask = _mm_movemask_epi8(m);
+		if (mask != 0)
+			return p + __builtin_ctz(mask);
+
+		p += 16;
+	}
+#elif defined(__ARM_NEON)
+	const uint8x16_t comma = vdupq_n_u8(',');
+	const uint8x16_t tab   = vdupq_n_u8('\t');
+	const uint8x16_t cr    = vdupq_n_u8('\r');
+	const uint8x16_t lf    = vdupq_n_u8('\n');
+
+	while (end - p >= 16) {
+		uint8x16_t v = vld1q_u8((const uint8_t*)p);
+		uint8x16_t m = vorrq_u8(vorrq_u8(vceqq_u8(v, comma), vceqq_u8(v, tab)),
+					vorrq_u8(vceqq_u8(v, cr), vceqq_u8(v, lf)));
+
+		// NEON has no movemask, narrow each byte to 4 bits of a 64 bit mask
+		uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(m), 4)), 0);
+		if (mask != 0U)
+			return p + (__builtin_ctzll(mask) >> 2);
+
+		p += 16;
+	}
+#endif
+
+	return findDelimiterScalar(p, end);
+}
+
+const char* CUserDBParser::findDelimiterScalar(const char* p, const char* end)
+{
+	while (p < end && *p != ',' && *p != '\t' && *p != '\r' && *p != '\n')
+		p++;
+
+	return p;
+}
+
+const char* CUserDBParser::getScanner()
+{
+#if defined(__SSE2__)
+	return "sse2";
+#elif defined(__ARM_NEON)
+	return "neon";
+#else
+	return "scalar";
+#endif
+}
+
+CUserDBParser::CUserDBParser(const char* begin, const char* end, const std::vector<int>& index, bool upperCase, const CUserDBFilter* filter, const char* base) :
+CThread(),
+m_begin(begin),
+m_end(end),
+m_index(index),
+m_table(new CUserDBTable(base != NULL)),
+m_upperCase(upperCase),
+m_filter(filter),
+m_skipped(0U),
+m_base(base),
+m_idColumn(-1)
+{
+	assert(begin != NULL);
+	assert(end >= begin);
+
+	for (unsigned int i = 0U; i < index.size(); i++) {
+		if (index[i] == USERDB_INDEX_RADIO_ID) {
+			m_idColumn = i;
+			break;
+		}
+	}
+}
+
+CUserDBParser::~CUserDBParser()
+{
+	delete m_table;
+}
+
+void CUserDBParser::parse()
+{
+	const char* p = m_begin;
+
+	// A filter needs the fields, so a lazy table is then built the long way
+	if (m_base != NULL && m_filter == NULL) {
+		while (p < m_end)
+			p = indexLine(p);
+	} else {
+		while (p < m_end)
+			p = parseLine(p);
+	}
+}
+
+void CUserDBParser::parse(const char* begin, const char* end)
+{
+	assert(m_base == NULL);
+
+	m_begin = begin;
+	m_end   = end;
+
+	parse();
+}
+
+void CUserDBParser::entry()
+{
+	parse();
+}
+
+void CUserDBParser::add(unsigned int id, const char* fields[UDF_COUNT], unsigned int lengths[UDF_COUNT])
+{
+	if (m_filter != NULL && !m_filter->match(id, fields[UDF_COUNTRY], lengths[UDF_COUNTRY])) {
+		m_skipped++;
+		return;
+	}
+
+	// Callsigns are stored in upper case, talkgroup names as they are
+	char callsign[USERDB_CALLSIGN_LENGTH];
+	if (m_upperCase) {
+		lengths[UDF_CALLSIGN] = upperCase(fields[UDF_CALLSIGN], lengths[UDF_CALLSIGN], callsign);
+		fields[UDF_CALLSIGN]  = callsign;
+	}
+
+	m_table->add(id, fields, lengths);
+}
+
+CUserDBTable* CUserDBParser::release()
+{
+	CUserDBTable* table = m_table;
+	m_table = NULL;
+
+	return table;
+}
+
+unsigned int CUserDBParser::getSkipped() const
+{
+	return m_skipped;
+}
+
+// Parses the line starting at p straight into the table, returns the start
+// of the next line
+const char* CUserDBParser::parseLine(const char* p)
+{
+	const char* end = m_end;
+
+	if (*p == '#') {
+		const char* eol = (const char*)::memchr(p, '\n', end - p);
+		return eol != NULL ? eol + 1 : end;
+	}
+
+	const char* line = p;
+
+	const char* fields[UDF_COUNT]   = { NULL };
+	unsigned int lengths[UDF_COUNT] = { 0U };
+	const char* id = NULL;
+	const char* idEnd = NULL;
+
+	p = parseFields(p, end, m_index, fields, lengths, id, idEnd);
+
+	if (id == NULL || fields[UDF_CALLSIGN] == NULL)
+		return p;
+
+	unsigned int radioId = parseId(id, idEnd);
+
+	if (m_base == NULL) {
+		add(radioId, fields, lengths);
+		return p;
+	}
+
+	if (m_filter != NULL && !m_filter->match(radioId, fields[UDF_COUNTRY], lengths[UDF_COUNTRY])) {
+		m_skipped++;
+		return p;
+	}
+
+	m_table->addLine(radioId, line - m_base);
+
+	return p;
+}
+
+// Only finds the ID of the line starting at p, for a lazy table
+const char* CUserDBParser::indexLine(const char* p)
+{
+	const char* end  = m_end;
+	const char* line = p;
+
+	const char* eol = (const char*)::memchr(p, '\n', end - p);
+	const char* next = eol != NULL ? eol + 1 : end;
+
+	if (*p == '#' || m_idColumn < 0)
+		return next;
+
+	const char* q;
+	for (int i = 0; ; i++) {
+		q = findDelimiter(p, end);
+
+		if (i == m_idColumn)
+			break;
+
+		// A short line
+		if (q == end || *q == '\r' || *q == '\n')
+			return next;
+
+		p = q + 1;
+	}
+
+	if (p == q)
+		return next;
+
+	m_table->addLine(parseId(p, q), line - m_base);
+
+	return next;
+}
+
+const char* CUserDBParser::parseFields(const char* p, const char* end, const std::vector<int>& index, const char* fields[UDF_COUNT],
+				       unsigned int lengths[UDF_COUNT], const char*& id, const char*& idEnd)
+{
+	for (unsigned int i = 0U; ; i++) {
+		const char* q = findDelimiter(p, end);
+
+		if (i < index.size()) {
+			if (index[i] == USERDB_INDEX_RADIO_ID) {
+				id    = p;
+				idEnd = q;
+			} else if (index[i] >= 0) {
+				fields[index[i]]  = p;
+				lengths[index[i]] = q - p;
+			}
+		}
+
+		if (q == end) {
+			p = end;
+			break;
+		}
+
+		p = q + 1;
+
+		if (*q == '\n')
+			break;
+
+		if (*q == '\r') {
+			if (p < end && *p == '\n')
+				p++;
+			break;
+		}
+	}
+
+	return p;
+}
+
+unsigned int CUserDBParser::upperCase(const char* callsign, unsigned int length, char* buffer)
+{
+	if (length > USERDB_CALLSIGN_LENGTH)
+		length = USERDB_CALLSIGN_LENGTH;
+
+	for (unsigned int i = 0U; i < length; i++)
+		buffer[i] = ::toupper(callsign[i]);
+
+	return length;
+}
+
+// As atoi(), but the number isn't NUL terminated
+unsigned int CUserDBParser::parseId(const char* p, const char* end)
+{
+	while (p < end && *p == ' ')
+		p++;
+
+	unsigned int id = 0U;
+	while (p < end && *p >= '0' && *p <= '9')
+		id = id * 10U + (*p++ - '0');
+
+	return id;
+}
@@ -0,0 +1,93 @@
+/*
+ *   Copyright (C) 2026 by BrandMeister
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#pragma once
+
+#include "Thread.h"
+#include "UserDBFilter.h"
+#include "UserDBTable.h"
+
+#include <vector>
+
+// Longer callsigns are truncated
+const unsigned int USERDB_CALLSIGN_LENGTH = 32U;
+
+// Column index value for RADIO_ID, other columns hold their USERDB_FIELD or -1
+const int USERDB_INDEX_RADIO_ID = UDF_COUNT;
+
+// Parses the whole lines in [begin, end) of a mapped CSV file into a table
+// of its own, either on the calling thread with parse() or on a thread of
+// its own with run() and wait()
+class CUserDBParser : public CThread {
+public:
+	// Rows the filter doesn't match are skipped, a NULL filter keeps them all.
+	// With a base the table is a lazy one, holding each row's offset from base
+	// rather than its fields.
+	CUserDBParser(const char* begin, const char* end, const std::vector<int>& index, bool upperCase = true, const CUserDBFilter* filter = NULL, const char* base = NULL);
+	virtual ~CUserDBParser();
+
+	void parse();
+
+	// For a file read in blocks, parses the whole lines in [begin, end) into
+	// the same table
+	void parse(const char* begin, const char* end);
+
+	virtual void entry() override;
+
+	// Adds a row from another source (e.g. JSON), filtered and with the
+	// callsign in upper case like those parsed here
+	void add(unsigned int id, const char* fields[UDF_COUNT], unsigned int lengths[UDF_COUNT]);
+
+	// The unfinished table, the caller owns it afterwards
+	CUserDBTable* release();
+
+	unsigned int getSkipped() const;
+
+	// Splits the line at p into its fields, which aren't NUL terminated.
+	// Returns the start of the next line.
+	static const char* parseFields(const char* p, const char* end, const std::vector<int>& index, const char* fields[UDF_COUNT],
+				       unsigned int lengths[UDF_COUNT], const char*& id, const char*& idEnd);
+
+	// Copies the callsign to buffer in upper case, returns its new length
+	static unsigned int upperCase(const char* callsign, unsigned int length, char* buffer);
+
+	// Returns the first ',', '\t', '\r' or '\n' in [p, end), or end. It
+	// scans 16 bytes at a time with SSE2 or NEON where the target has them,
+	// and must always agree with findDelimiterScalar().
+	static const char* findDelimiter(const char* p, const char* end);
+	static const char* findDelimiterScalar(const char* p, const char* end);
+
+	// "sse2", "neon" or "scalar", what findDelimiter() was built with
+	static const char* getScanner();
+
+private:
+	const char*          m_begin;
+	const char*          m_end;
+	std::vector<int>     m_index;
+	CUserDBTable*        m_table;
+	bool                 m_upperCase;
+	const CUserDBFilter* m_filter;
+	unsigned int         m_skipped;
+	const char*          m_base;
+	int                  m_idColumn;
+
+	const char* parseLine(const char* p);
+	const char* indexLine(const char* p);
+
+	static unsigned int parseId(const char* p, const char* end);
+};
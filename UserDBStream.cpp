@@ -0,0 +1,239 @@
+/*
+ *   Copyright (C) 2026 by BrandMeister
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "UserDBStream.h"
+#include "Log.h"
+
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+const unsigned char GZIP_MAGIC[2U] = { 0x1FU, 0x8BU };
+const unsigned char ZSTD_MAGIC[4U] = { 0x28U, 0xB5U, 0x2FU, 0xFDU };
+
+CUserDBStream::CUserDBStream() :
+m_filename(),
+m_compression(UDC_NONE),
+m_fd(-1)
+#if defined(HAVE_ZLIB)
+,m_gz(NULL)
+#endif
+#if defined(HAVE_ZSTD)
+,m_zstd(NULL),
+m_input(),
+m_in(),
+m_eof(false),
+m_frame(0U)
+#endif
+{
+}
+
+CUserDBStream::~CUserDBStream()
+{
+	close();
+}
+
+bool CUserDBStream::open(const std::string& filename)
+{
+	assert(m_fd < 0);
+
+	m_filename    = filename;
+	m_compression = getCompression(filename);
+
+	m_fd = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+	if (m_fd < 0) {
+		LogWarning("Cannot open ID lookup file - %s", filename.c_str());
+		return false;
+	}
+
+	::posix_fadvise(m_fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+	switch (m_compression) {
+		case UDC_GZIP:
+#if defined(HAVE_ZLIB)
+			m_gz = ::gzdopen(m_fd, "rb");
+			if (m_gz == NULL)
+				break;
+			m_fd = -1;		// now owned by m_gz
+			::gzbuffer(m_gz, 128U * 1024U);
+			return true;
+#else
+			LogError("gzip support isn't compiled in - %s", filename.c_str());
+			break;
+#endif
+
+		case UDC_ZSTD:
+#if defined(HAVE_ZSTD)
+			m_zstd = ::ZSTD_createDStream();
+			if (m_zstd == NULL)
+				break;
+			::ZSTD_initDStream(m_zstd);
+			m_input.resize(::ZSTD_DStreamInSize());
+			m_in.src  = m_input.data();
+			m_in.size = 0U;
+			m_in.pos  = 0U;
+			m_eof     = false;
+			m_frame   = 0U;
+			return true;
+#else
+			LogError("zstd support isn't compiled in - %s", filename.c_str());
+			break;
+#endif
+
+		default:
+			return true;
+	}
+
+	close();
+	return false;
+}
+
+int CUserDBStream::read(char* buffer, unsigned int length)
+{
+	assert(buffer != NULL);
+
+	switch (m_compression) {
+#if defined(HAVE_ZLIB)
+		case UDC_GZIP: {
+			if (m_gz == NULL)
+				return -1;
+
+			int n = ::gzread(m_gz, buffer, length);
+
+			// A file cut short ends with Z_BUF_ERROR rather than an error from gzread
+			int err = Z_OK;
+			if (n <= 0)
+				::gzerror(m_gz, &err);
+
+			if (n < 0 || err == Z_BUF_ERROR) {
+				LogError("Cannot decompress the ID lookup file, %s - %s", ::gzerror(m_gz, &err), m_filename.c_str());
+				return -1;
+			}
+
+			return n;
+		}
+#endif
+
+#if defined(HAVE_ZSTD)
+		case UDC_ZSTD: {
+			if (m_zstd == NULL)
+				return -1;
+
+			ZSTD_outBuffer out = { buffer, length, 0U };
+
+			while (out.pos < out.size) {
+				if (m_in.pos == m_in.size && !m_eof) {
+					ssize_t n;
+					do {
+						n = ::read(m_fd, m_input.data(), m_input.size());
+					} while (n < 0 && errno == EINTR);
+
+					if (n < 0) {
+						LogError("Cannot read the ID lookup file, err: %d - %s", errno, m_filename.c_str());
+						return -1;
+					}
+
+					m_eof     = n == 0;
+					m_in.size = n;
+					m_in.pos  = 0U;
+				}
+
+				// With the whole file read, only what the decoder still holds is
+				// left, none once the last frame is finished. Called again then,
+				// it would start on the next frame's header.
+				bool drained = m_in.pos == m_in.size;
+				if (drained && m_frame == 0U)
+					break;
+
+				size_t pos = out.pos;
+
+				m_frame = ::ZSTD_decompressStream(m_zstd, &out, &m_in);
+				if (::ZSTD_isError(m_frame)) {
+					LogError("Cannot decompress the ID lookup file, %s - %s", ::ZSTD_getErrorName(m_frame), m_filename.c_str());
+					return -1;
+				}
+
+				if (drained && out.pos == pos) {
+					LogError("Cannot decompress the ID lookup file, it ends part way through a frame - %s", m_filename.c_str());
+					return -1;
+				}
+			}
+
+			return int(out.pos);
+		}
+#endif
+
+		default: {
+			if (m_fd < 0)
+				return -1;
+
+			ssize_t n;
+			do {
+				n = ::read(m_fd, buffer, length);
+			} while (n < 0 && errno == EINTR);
+
+			if (n < 0)
+				LogError("Cannot read the ID lookup file, err: %d - %s", errno, m_filename.c_str());
+
+			return int(n);
+		}
+	}
+}
+
+void CUserDBStream::close()
+{
+#if defined(HAVE_ZLIB)
+	if (m_gz != NULL) {
+		::gzclose(m_gz);
+		m_gz = NULL;
+	}
+#endif
+#if defined(HAVE_ZSTD)
+	if (m_zstd != NULL) {
+		::ZSTD_freeDStream(m_zstd);
+		m_zstd = NULL;
+	}
+#endif
+
+	if (m_fd >= 0) {
+		::close(m_fd);
+		m_fd = -1;
+	}
+}
+
+USERDB_COMPRESSION CUserDBStream::getCompression(const std::string& filename)
+{
+	int fd = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd < 0)
+		return UDC_NONE;
+
+	unsigned char magic[4U];
+	ssize_t n = ::read(fd, magic, sizeof(magic));
+	::close(fd);
+
+	if (n >= 2 && ::memcmp(magic, GZIP_MAGIC, sizeof(GZIP_MAGIC)) == 0)
+		return UDC_GZIP;
+
+	if (n >= 4 && ::memcmp(magic, ZSTD_MAGIC, sizeof(ZSTD_MAGIC)) == 0)
+		return UDC_ZSTD;
+
+	return UDC_NONE;
+}
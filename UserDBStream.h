@@ -0,0 +1,69 @@
+/*
+ *   Copyright (C) 2026 by BrandMeister
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#if defined(HAVE_ZLIB)
+#include <zlib.h>
+#endif
+#if defined(HAVE_ZSTD)
+#include <zstd.h>
+#endif
+
+enum USERDB_COMPRESSION {
+	UDC_NONE,
+	UDC_GZIP,
+	UDC_ZSTD
+};
+
+// Reads an ID file front to back, decompressing gzip and zstd files on the
+// fly, so that they can be parsed without being unpacked to disk first.
+// Support for each is only there if the library was found at build time.
+class CUserDBStream {
+public:
+	CUserDBStream();
+	~CUserDBStream();
+
+	bool open(const std::string& filename);
+
+	// Returns the number of bytes read, 0 at the end and -1 on an error
+	int read(char* buffer, unsigned int length);
+
+	void close();
+
+	// Looks at the magic number at the start of the file
+	static USERDB_COMPRESSION getCompression(const std::string& filename);
+
+private:
+	std::string        m_filename;
+	USERDB_COMPRESSION m_compression;
+	int                m_fd;
+#if defined(HAVE_ZLIB)
+	gzFile             m_gz;
+#endif
+#if defined(HAVE_ZSTD)
+	ZSTD_DStream*      m_zstd;
+	std::vector<char>  m_input;
+	ZSTD_inBuffer      m_in;
+	bool               m_eof;
+	size_t             m_frame;		// non-zero while a frame is unfinished
+#endif
+};
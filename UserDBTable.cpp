@@ -0,0 +1,654 @@
+/*
+ *   Copyright (C) 2026 by BrandMeister
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "UserDBTable.h"
+#include "DMRCountry.h"
+#include "UserDBParser.h"
+
+#include "Log.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+const uint32_t FNV_OFFSET_BASIS = 2166136261U;
+const uint32_t FNV_PRIME        = 16777619U;
+
+struct UserDBFileHeader {
+	char     magic[4U];
+	uint32_t version;
+	uint32_t count;
+	uint32_t arenaSize;
+	uint32_t checksum;
+	uint32_t countries;
+	uint32_t reserved[2U];
+};
+
+CUserDBTable::CUserDBTable(bool lazy) :
+m_ids(),
+m_fields(),
+m_countryRows(),
+m_countryOffsets(),
+m_arena(1U, '\0'),
+m_strings(1024U, 0U),
+m_stringCount(0U),
+m_idsPtr(NULL),
+m_fieldsPtr(NULL),
+m_countryRowsPtr(NULL),
+m_countryOffsetsPtr(NULL),
+m_arenaPtr(NULL),
+m_count(0U),
+m_countryCount(0U),
+m_arenaSize(0U),
+m_map(NULL),
+m_mapSize(0U),
+m_lazy(lazy),
+m_index(),
+m_upperCase(true),
+m_fd(-1),
+m_mtime(),
+m_stale(false)
+{
+}
+
+CUserDBTable::~CUserDBTable()
+{
+	if (m_map != NULL)
+		::munmap(m_map, m_mapSize);
+	if (m_fd >= 0)
+		::close(m_fd);
+}
+
+void CUserDBTable::add(unsigned int id, const char* const fields[UDF_COUNT], const unsigned int lengths[UDF_COUNT])
+{
+	assert(fields != NULL);
+	assert(lengths != NULL);
+
+	m_ids.push_back(id);
+
+	for (unsigned int i = 0U; i < UDF_COUNT; i++)
+		m_fields.push_back(fields[i] != NULL ? intern(fields[i], lengths[i]) : 0U);
+}
+
+void CUserDBTable::addLine(unsigned int id, uint32_t offset)
+{
+	assert(m_lazy);
+
+	m_ids.push_back(id);
+	m_fields.push_back(offset);
+}
+
+void CUserDBTable::attach(void* map, size_t size, int fd, const std::vector<int>& index, bool upperCase)
+{
+	assert(m_lazy);
+	assert(m_map == NULL);
+	assert(fd >= 0);
+
+	m_map       = map;
+	m_mapSize   = size;
+	m_fd        = fd;
+	m_index     = index;
+	m_upperCase = upperCase;
+
+	struct stat st;
+	if (::fstat(fd, &st) == 0)
+		m_mtime = st.st_mtim;
+	else
+		m_stale = true;
+}
+
+void CUserDBTable::finish()
+{
+	unsigned int count = m_ids.size();
+
+	std::vector<uint32_t> order(count);
+	for (unsigned int i = 0U; i < count; i++)
+		order[i] = i;
+
+	// Stable, so that of several rows with the same ID the last one in the file wins
+	std::stable_sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b) { return m_ids[a] < m_ids[b]; });
+
+	// Of several rows with the same ID only the last is kept
+	std::vector<uint32_t> rows;
+	rows.reserve(count);
+
+	for (unsigned int i = 0U; i < count; i++) {
+		if (!rows.empty() && m_ids[rows.back()] == m_ids[order[i]])
+			rows.back() = order[i];
+		else
+			rows.push_back(order[i]);
+	}
+
+	std::vector<uint32_t> ids;
+	std::vector<uint32_t> fields;
+	ids.reserve(rows.size());
+	fields.reserve(rows.size() * (m_lazy ? 1U : USERDB_ROW_FIELDS));
+
+	m_countryRows.clear();
+	m_countryOffsets.clear();
+
+	for (unsigned int i = 0U; i < rows.size(); i++) {
+		uint32_t row = rows[i];
+		uint32_t id  = m_ids[row];
+
+		ids.push_back(id);
+
+		if (m_lazy) {
+			fields.push_back(m_fields[row]);
+			continue;
+		}
+		fields.insert(fields.end(), m_fields.begin() + row * UDF_COUNT, m_fields.begin() + row * UDF_COUNT + USERDB_ROW_FIELDS);
+
+		uint32_t country    = m_fields[row * UDF_COUNT + UDF_COUNTRY];
+		const char* derived = CDMRCountry::find(id);
+
+		if (::strcmp(&m_arena[country], derived != NULL ? derived : "") != 0) {
+			m_countryRows.push_back(i);
+			m_countryOffsets.push_back(country);
+		}
+	}
+
+	m_ids.swap(ids);
+	m_fields.swap(fields);
+	std::vector<uint32_t>(m_countryRows).swap(m_countryRows);
+	std::vector<uint32_t>(m_countryOffsets).swap(m_countryOffsets);
+
+	// Release the build time memory
+	std::vector<char>(m_arena).swap(m_arena);
+	std::vector<uint32_t>().swap(m_strings);
+	m_stringCount = 0U;
+
+	m_idsPtr            = m_ids.data();
+	m_fieldsPtr         = m_fields.data();
+	m_countryRowsPtr    = m_countryRows.data();
+	m_countryOffsetsPtr = m_countryOffsets.data();
+	m_arenaPtr          = m_arena.data();
+	m_count             = m_ids.size();
+	m_countryCount      = m_countryRows.size();
+	m_arenaSize         = m_arena.size();
+}
+
+void CUserDBTable::append(const CUserDBTable& other)
+{
+	assert(m_lazy == other.m_lazy);
+
+	if (m_lazy) {
+		m_ids.insert(m_ids.end(), other.m_ids.begin(), other.m_ids.end());
+		m_fields.insert(m_fields.end(), other.m_fields.begin(), other.m_fields.end());
+		return;
+	}
+
+	// Each of other's strings once, in arena order, giving the offset it
+	// now has in this arena
+	std::vector<uint32_t> remap(other.m_arena.size(), 0U);
+
+	for (uint32_t offset = 1U; offset < other.m_arena.size(); ) {
+		const char* str     = &other.m_arena[offset];
+		unsigned int length = ::strlen(str);
+
+		remap[offset] = intern(str, length);
+
+		offset += length + 1U;
+	}
+
+	m_ids.insert(m_ids.end(), other.m_ids.begin(), other.m_ids.end());
+
+	m_fields.reserve(m_fields.size() + other.m_fields.size());
+	for (unsigned int i = 0U; i < other.m_fields.size(); i++)
+		m_fields.push_back(remap[other.m_fields[i]]);
+}
+
+bool CUserDBTable::map(const std::string& filename)
+{
+	assert(m_map == NULL);
+
+	int fd = ::open(filename.c_str(), O_RDONLY);
+	if (fd < 0) {
+		LogWarning("Cannot open ID lookup file - %s", filename.c_str());
+		return false;
+	}
+
+	struct stat st;
+	if (::fstat(fd, &st) < 0 || size_t(st.st_size) < USERDB_FILE_HEADER_SIZE) {
+		LogWarning("Compiled ID lookup file is too short - %s", filename.c_str());
+		::close(fd);
+		return false;
+	}
+
+	size_t size = st.st_size;
+
+	void* map = ::mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+	::close(fd);
+
+	if (map == MAP_FAILED) {
+		LogError("Cannot map the ID lookup file - %s", filename.c_str());
+		return false;
+	}
+
+	const unsigned char* data = (const unsigned char*)map;
+
+	UserDBFileHeader header;
+	::memcpy(&header, data, sizeof(header));
+
+	uint64_t expected = uint64_t(USERDB_FILE_HEADER_SIZE) + uint64_t(header.count) * (USERDB_ROW_FIELDS + 1U) * sizeof(uint32_t) +
+			    uint64_t(header.countries) * 2U * sizeof(uint32_t) + header.arenaSize;
+
+	if (::memcmp(header.magic, USERDB_FILE_MAGIC, sizeof(header.magic)) != 0 || header.version != USERDB_FILE_VERSION) {
+		LogWarning("Unknown compiled ID lookup file format, compile it again - %s", filename.c_str());
+		::munmap(map, size);
+		return false;
+	}
+
+	// The arena must end with a NUL so that every string in it is terminated
+	if (expected != size || header.arenaSize == 0U || data[size - 1U] != '\0') {
+		LogWarning("Compiled ID lookup file is truncated or corrupt - %s", filename.c_str());
+		::munmap(map, size);
+		return false;
+	}
+
+	if (checksum(data + USERDB_FILE_HEADER_SIZE, size - USERDB_FILE_HEADER_SIZE, FNV_OFFSET_BASIS) != header.checksum) {
+		LogWarning("Compiled ID lookup file has a bad checksum - %s", filename.c_str());
+		::munmap(map, size);
+		return false;
+	}
+
+	m_map               = map;
+	m_mapSize           = size;
+	m_count             = header.count;
+	m_countryCount      = header.countries;
+	m_arenaSize         = header.arenaSize;
+	m_idsPtr            = (const uint32_t*)(data + USERDB_FILE_HEADER_SIZE);
+	m_fieldsPtr         = m_idsPtr + m_count;
+	m_countryRowsPtr    = m_fieldsPtr + m_count * USERDB_ROW_FIELDS;
+	m_countryOffsetsPtr = m_countryRowsPtr + m_countryCount;
+	m_arenaPtr          = (const char*)(m_countryOffsetsPtr + m_countryCount);
+
+	return true;
+}
+
+// Written to a temporary file and renamed into place, a running server may
+// have the old file mapped and would fault if it were truncated underneath it
+bool CUserDBTable::save(const std::string& filename) const
+{
+	if (m_lazy) {
+		LogError("Cannot compile a lazily loaded ID lookup table - %s", filename.c_str());
+		return false;
+	}
+
+	UserDBFileHeader header;
+	::memset(&header, 0x00U, sizeof(header));
+	::memcpy(header.magic, USERDB_FILE_MAGIC, sizeof(header.magic));
+	header.version   = USERDB_FILE_VERSION;
+	header.count     = m_count;
+	header.arenaSize = m_arenaSize;
+	header.countries = m_countryCount;
+
+	uint32_t hash = FNV_OFFSET_BASIS;
+	hash = checksum((const unsigned char*)m_idsPtr, m_count * sizeof(uint32_t), hash);
+	hash = checksum((const unsigned char*)m_fieldsPtr, m_count * USERDB_ROW_FIELDS * sizeof(uint32_t), hash);
+	hash = checksum((const unsigned char*)m_countryRowsPtr, m_countryCount * sizeof(uint32_t), hash);
+	hash = checksum((const unsigned char*)m_countryOffsetsPtr, m_countryCount * sizeof(uint32_t), hash);
+	hash = checksum((const unsigned char*)m_arenaPtr, m_arenaSize, hash);
+	header.checksum = hash;
+
+	std::string temp = filename + ".tmp";
+
+	FILE* fp = ::fopen(temp.c_str(), "wb");
+	if (fp == NULL) {
+		LogError("Cannot create the compiled ID lookup file - %s", temp.c_str());
+		return false;
+	}
+
+	bool ok = ::fwrite(&header, sizeof(header), 1U, fp) == 1U &&
+		  ::fwrite(m_idsPtr, sizeof(uint32_t), m_count, fp) == m_count &&
+		  ::fwrite(m_fieldsPtr, sizeof(uint32_t), m_count * USERDB_ROW_FIELDS, fp) == m_count * USERDB_ROW_FIELDS &&
+		  ::fwrite(m_countryRowsPtr, sizeof(uint32_t), m_countryCount, fp) == m_countryCount &&
+		  ::fwrite(m_countryOffsetsPtr, sizeof(uint32_t), m_countryCount, fp) == m_countryCount &&
+		  ::fwrite(m_arenaPtr, 1U, m_arenaSize, fp) == m_arenaSize;
+
+	ok = (::fclose(fp) == 0) && ok;
+
+	if (!ok || ::rename(temp.c_str(), filename.c_str()) < 0) {
+		LogError("Cannot write the compiled ID lookup file - %s", filename.c_str());
+		::unlink(temp.c_str());
+		return false;
+	}
+
+	return true;
+}
+
+bool CUserDBTable::isCompiled(const std::string& filename)
+{
+	FILE* fp = ::fopen(filename.c_str(), "rb");
+	if (fp == NULL)
+		return false;
+
+	char magic[4U];
+	bool ret = ::fread(magic, sizeof(magic), 1U, fp) == 1U && ::memcmp(magic, USERDB_FILE_MAGIC, sizeof(magic)) == 0;
+
+	::fclose(fp);
+
+	return ret;
+}
+
+CUserDBTable* CUserDBTable::select(const CUserDBFilter& filter, unsigned int maxEntries, unsigned int& skipped) const
+{
+	CUserDBTable* table = new CUserDBTable;
+
+	skipped = 0U;
+
+	CUserDBentry entry;
+
+	// Checked once, a stale lazy table's rows come back empty
+	isCurrent();
+
+	for (unsigned int row = 0U; row < m_count; row++) {
+		const char* fields[UDF_COUNT];
+		unsigned int lengths[UDF_COUNT];
+
+		if (m_lazy)
+			getRow(row, entry);
+
+		for (unsigned int i = 0U; i < UDF_COUNT; i++) {
+			fields[i]  = m_lazy ? entry.get(USERDB_FIELD(i)) : getField(row, i);
+			lengths[i] = ::strlen(fields[i]);
+		}
+
+		if ((maxEntries > 0U && table->m_ids.size() >= maxEntries) ||
+		    !filter.match(m_idsPtr[row], fields[UDF_COUNTRY], lengths[UDF_COUNTRY])) {
+			skipped++;
+			continue;
+		}
+
+		table->add(m_idsPtr[row], fields, lengths);
+	}
+
+	table->finish();
+
+	return table;
+}
+
+bool CUserDBTable::lookup(unsigned int id, CUserDBentry* entry) const
+{
+	int row = findRow(id);
+	if (row < 0)
+		return false;
+
+	if (m_lazy)
+		return isCurrent() && parseLine(row, entry);
+
+	if (entry != NULL) {
+		entry->clear();
+
+		for (unsigned int i = 0U; i < UDF_COUNT; i++)
+			entry->set(USERDB_FIELD(i), getField(row, i));
+	}
+
+	return true;
+}
+
+// Both ID arrays are sorted, so one merge pass finds every difference
+void CUserDBTable::diff(const CUserDBTable& other, unsigned int& added, unsigned int& changed, unsigned int& removed) const
+{
+	added   = 0U;
+	changed = 0U;
+	removed = 0U;
+
+	// A lazy table's rows have to be parsed to be compared, a stale one's
+	// rows then come back empty
+	bool parse = m_lazy || other.m_lazy;
+	if (parse) {
+		isCurrent();
+		other.isCurrent();
+	}
+	CUserDBentry entry, otherEntry;
+
+	unsigned int i = 0U, j = 0U;
+
+	while (i < m_count || j < other.m_count) {
+		if (j >= other.m_count || (i < m_count && m_idsPtr[i] < other.m_idsPtr[j])) {
+			removed++;
+			i++;
+		} else if (i >= m_count || other.m_idsPtr[j] < m_idsPtr[i]) {
+			added++;
+			j++;
+		} else {
+			if (parse) {
+				getRow(i, entry);
+				other.getRow(j, otherEntry);
+			}
+
+			for (unsigned int k = 0U; k < UDF_COUNT; k++) {
+				const char* field      = parse ? entry.get(USERDB_FIELD(k)) : getField(i, k);
+				const char* otherField = parse ? otherEntry.get(USERDB_FIELD(k)) : other.getField(j, k);
+
+				if (::strcmp(field, otherField) != 0) {
+					changed++;
+					break;
+				}
+			}
+
+			i++;
+			j++;
+		}
+	}
+}
+
+unsigned int CUserDBTable::size() const
+{
+	return m_count;
+}
+
+bool CUserDBTable::isMapped() const
+{
+	return m_map != NULL && !m_lazy;
+}
+
+bool CUserDBTable::isLazy() const
+{
+	return m_lazy;
+}
+
+size_t CUserDBTable::getMemory() const
+{
+	return (m_ids.capacity() + m_fields.capacity() + m_countryRows.capacity() + m_countryOffsets.capacity()) * sizeof(uint32_t) +
+	       m_arena.capacity();
+}
+
+uint32_t CUserDBTable::intern(const char* str, unsigned int length)
+{
+	if (length == 0U)
+		return 0U;
+
+	// Kept at most half full
+	if ((m_stringCount + 1U) * 2U > m_strings.size())
+		growStrings();
+
+	unsigned int mask = m_strings.size() - 1U;
+
+	for (unsigned int i = hash(str, length) & mask; ; i = (i + 1U) & mask) {
+		uint32_t offset = m_strings[i];
+
+		if (offset == 0U) {
+			offset = m_arena.size();
+			m_arena.insert(m_arena.end(), str, str + length);
+			m_arena.push_back('\0');
+
+			m_strings[i] = offset;
+			m_stringCount++;
+
+			return offset;
+		}
+
+		if (offset + length < m_arena.size() && ::memcmp(&m_arena[offset], str, length) == 0 && m_arena[offset + length] == '\0')
+			return offset;
+	}
+}
+
+void CUserDBTable::growStrings()
+{
+	std::vector<uint32_t> strings(m_strings.size() * 2U, 0U);
+	unsigned int mask = strings.size() - 1U;
+
+	for (unsigned int i = 0U; i < m_strings.size(); i++) {
+		uint32_t offset = m_strings[i];
+		if (offset == 0U)
+			continue;
+
+		const char* str = &m_arena[offset];
+
+		unsigned int j = hash(str, ::strlen(str)) & mask;
+		while (strings[j] != 0U)
+			j = (j + 1U) & mask;
+
+		strings[j] = offset;
+	}
+
+	m_strings.swap(strings);
+}
+
+int CUserDBTable::findRow(unsigned int id) const
+{
+	const uint32_t* end = m_idsPtr + m_count;
+
+	const uint32_t* it = std::lower_bound(m_idsPtr, end, uint32_t(id));
+	if (it == end || *it != id)
+		return -1;
+
+	return it - m_idsPtr;
+}
+
+// The offsets of a mapped file are only covered by the checksum, so check them
+const char* CUserDBTable::getField(unsigned int row, unsigned int field) const
+{
+	if (field == UDF_COUNTRY)
+		return getCountry(row);
+
+	uint32_t offset = m_fieldsPtr[row * USERDB_ROW_FIELDS + field];
+
+	return offset < m_arenaSize ? m_arenaPtr + offset : "";
+}
+
+const char* CUserDBTable::getCountry(unsigned int row) const
+{
+	const uint32_t* end = m_countryRowsPtr + m_countryCount;
+
+	const uint32_t* it = std::lower_bound(m_countryRowsPtr, end, uint32_t(row));
+	if (it != end && *it == row) {
+		uint32_t offset = m_countryOffsetsPtr[it - m_countryRowsPtr];
+
+		return offset < m_arenaSize ? m_arenaPtr + offset : "";
+	}
+
+	const char* country = CDMRCountry::find(m_idsPtr[row]);
+
+	return country != NULL ? country : "";
+}
+
+// One fstat() per lookup, and the lookup caches in front of the table keep
+// it off the path of IDs already seen
+bool CUserDBTable::isCurrent() const
+{
+	if (!m_lazy)
+		return true;
+
+	if (m_stale.load(std::memory_order_relaxed))
+		return false;
+
+	struct stat st;
+	if (::fstat(m_fd, &st) == 0 && size_t(st.st_size) == m_mapSize &&
+	    st.st_mtim.tv_sec == m_mtime.tv_sec && st.st_mtim.tv_nsec == m_mtime.tv_nsec)
+		return true;
+
+	if (!m_stale.exchange(true))
+		LogWarning("The lazily loaded ID lookup file was rewritten in place, no IDs are found until it is reloaded. Rename a new file over it instead.");
+
+	return false;
+}
+
+// Parses a lazy table's row, false if the line has no callsign
+bool CUserDBTable::parseLine(unsigned int row, CUserDBentry* entry) const
+{
+	const char* begin = (const char*)m_map;
+	const char* end   = begin + m_mapSize;
+
+	uint32_t offset = m_fieldsPtr[row];
+	if (offset >= m_mapSize)
+		return false;
+
+	const char* fields[UDF_COUNT]   = { NULL };
+	unsigned int lengths[UDF_COUNT] = { 0U };
+	const char* id    = NULL;
+	const char* idEnd = NULL;
+
+	CUserDBParser::parseFields(begin + offset, end, m_index, fields, lengths, id, idEnd);
+
+	if (fields[UDF_CALLSIGN] == NULL)
+		return false;
+
+	if (entry != NULL) {
+		char callsign[USERDB_CALLSIGN_LENGTH];
+		if (m_upperCase) {
+			lengths[UDF_CALLSIGN] = CUserDBParser::upperCase(fields[UDF_CALLSIGN], lengths[UDF_CALLSIGN], callsign);
+			fields[UDF_CALLSIGN]  = callsign;
+		}
+
+		entry->clear();
+
+		for (unsigned int i = 0U; i < UDF_COUNT; i++)
+			entry->set(USERDB_FIELD(i), fields[i], lengths[i]);
+	}
+
+	return true;
+}
+
+// Any row as an entry, for the code that has to handle lazy tables too
+void CUserDBTable::getRow(unsigned int row, CUserDBentry& entry) const
+{
+	if (m_lazy) {
+		if (m_stale.load(std::memory_order_relaxed) || !parseLine(row, &entry))
+			entry.clear();
+		return;
+	}
+
+	entry.clear();
+
+	for (unsigned int i = 0U; i < UDF_COUNT; i++)
+		entry.set(USERDB_FIELD(i), getField(row, i));
+}
+
+uint32_t CUserDBTable::hash(const char* str, unsigned int length)
+{
+	return checksum((const unsigned char*)str, length, FNV_OFFSET_BASIS);
+}
+
+uint32_t CUserDBTable::checksum(const unsigned char* data, size_t length, uint32_t hash)
+{
+	for (size_t i = 0U; i < length; i++) {
+		hash ^= data[i];
+		hash *= FNV_PRIME;
+	}
+
+	return hash;
+}
@@ -0,0 +1,150 @@
+/*
+ *   Copyright (C) 2026 by BrandMeister
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#pragma once
+
+#include "UserDBFilter.h"
+#include "UserDBentry.h"
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <sys/stat.h>
+
+// Compiled ID database file, all values in host byte order:
+//
+//   header    magic "DSID", version, count, arena size, checksum, exception
+//             count, 2 reserved words
+//   ids       count x uint32, sorted
+//   fields    count x USERDB_ROW_FIELDS x uint32 arena offsets
+//   countries exception count x uint32 rows, sorted, then as many offsets
+//   arena     NUL terminated strings, offset 0 is the empty string
+//
+// The checksum is FNV-1a over everything after the header.
+const char         USERDB_FILE_MAGIC[4U]   = { 'D', 'S', 'I', 'D' };
+const uint32_t     USERDB_FILE_VERSION     = 2U;
+const unsigned int USERDB_FILE_HEADER_SIZE = 32U;
+
+// Every field but the country is stored per row, the country normally
+// comes from the ID (see CDMRCountry) and only rows where that gives the
+// wrong answer store it, as an exception
+const unsigned int USERDB_ROW_FIELDS = UDF_COUNTRY;
+static_assert(UDF_COUNTRY == UDF_COUNT - 1, "UDF_COUNTRY must be the last field");
+
+// The user database in a compact, read only form: a sorted array of IDs,
+// a fixed row of string offsets per ID and one arena holding every string.
+// Repeated strings (names, cities) are stored once. The arrays are either
+// built in memory from a CSV file or mmap()ed from a compiled one.
+//
+// A lazy table instead keeps the CSV file mapped and holds only each ID's
+// line offset, the line is parsed when the ID is looked up. The file is
+// checked before each lookup and the table stops finding anything once it
+// has been rewritten in place, rather than reading past the end of a file
+// that has shrunk (SIGBUS) or parsing from stale offsets. That still leaves
+// a window between the check and the read, so the file must be replaced by
+// renaming a new one over it.
+class CUserDBTable {
+public:
+	CUserDBTable(bool lazy = false);
+	~CUserDBTable();
+
+	// Building, add() the rows in any order then finish() once. The fields
+	// need not be NUL terminated, a NULL field is left empty.
+	void add(unsigned int id, const char* const fields[UDF_COUNT], const unsigned int lengths[UDF_COUNT]);
+	void finish();
+
+	// Building a lazy table, addLine() the rows then attach() the mapping
+	// they are in and its file, which the table then owns, before finish()
+	void addLine(unsigned int id, uint32_t offset);
+	void attach(void* map, size_t size, int fd, const std::vector<int>& index, bool upperCase);
+
+	// Adds the rows of another unfinished table, re-interning its strings
+	void append(const CUserDBTable& other);
+
+	// Maps a file written by save(), false if it is missing or not valid.
+	// It is only checked here, so the file must be replaced by renaming a
+	// new one over it as save() does, rewriting it in place can SIGBUS.
+	bool map(const std::string& filename);
+	bool save(const std::string& filename) const;
+
+	static bool isCompiled(const std::string& filename);
+
+	// A finished copy holding the rows the filter matches, at most
+	// maxEntries of them (0 for no limit) with the lowest IDs kept
+	CUserDBTable* select(const CUserDBFilter& filter, unsigned int maxEntries, unsigned int& skipped) const;
+
+	bool lookup(unsigned int id, CUserDBentry* entry) const;
+
+	// Counts the IDs that other adds, changes or removes relative to this table
+	void diff(const CUserDBTable& other, unsigned int& added, unsigned int& changed, unsigned int& removed) const;
+
+	unsigned int size() const;
+	bool isMapped() const;		// a compiled file
+	bool isLazy() const;
+
+	// Bytes of heap held by the table once finished, a mapped table holds none
+	size_t getMemory() const;
+
+private:
+	std::vector<uint32_t> m_ids;
+	std::vector<uint32_t> m_fields;		// UDF_COUNT arena offsets per ID while
+						// building, USERDB_ROW_FIELDS once finished,
+						// the line offset in a lazy table
+	std::vector<uint32_t> m_countryRows;	// the rows whose country isn't the
+	std::vector<uint32_t> m_countryOffsets;	// one derived from the ID
+	std::vector<char>     m_arena;		// offset 0 is the empty string
+
+	// Open addressed set of arena offsets used to store each string once,
+	// only while building
+	std::vector<uint32_t> m_strings;
+	unsigned int          m_stringCount;
+
+	// Point into the vectors above or into the mapping
+	const uint32_t* m_idsPtr;
+	const uint32_t* m_fieldsPtr;
+	const uint32_t* m_countryRowsPtr;
+	const uint32_t* m_countryOffsetsPtr;
+	const char*     m_arenaPtr;
+	unsigned int    m_count;
+	unsigned int    m_countryCount;
+	uint32_t        m_arenaSize;
+
+	void*  m_map;
+	size_t m_mapSize;
+
+	bool             m_lazy;
+	std::vector<int> m_index;		// the CSV columns of a lazy table
+	bool             m_upperCase;
+	int              m_fd;			// the CSV file of a lazy table, and
+	struct timespec  m_mtime;		// its modification time when indexed
+	mutable std::atomic<bool> m_stale;	// rewritten in place since
+
+	uint32_t intern(const char* str, unsigned int length);
+	void growStrings();
+	int findRow(unsigned int id) const;
+	const char* getField(unsigned int row, unsigned int field) const;
+	const char* getCountry(unsigned int row) const;
+	bool isCurrent() const;
+	bool parseLine(unsigned int row, CUserDBentry* entry) const;
+	void getRow(unsigned int row, CUserDBentry& entry) const;
+
+	static uint32_t hash(const char* str, unsigned int length);
+	static uint32_t checksum(const unsigned char* data, size_t length, uint32_t hash);
+};
@@ -15,11 +15,22 @@
  *   along with this program; if not, write to the Free Software
  *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
  */
+
 #include "UserDBentry.h"
-#include <algorithm>
+
+#include <cassert>
+#include <cstring>
+
+const char* const CUserDBentry::keyList[UDF_COUNT] = {
+	keyCALLSIGN, keyFIRST_NAME, keyLAST_NAME,
+	keyCITY, keySTATE, keyCOUNTRY,
+};
 
 CUserDBentry::CUserDBentry() :
-m_db()
+m_offsets(),
+m_lines(),
+m_length(1U),
+m_data()
 {
 }
 
@@ -27,33 +38,107 @@ CUserDBentry::~CUserDBentry()
 {
 }
 
-const std::vector<std::string> CUserDBentry::keyList {
-	keyRADIO_ID, keyCALLSIGN, keyFIRST_NAME, keyLAST_NAME,
-	keyCITY, keySTATE, keyCOUNTRY,
-};
+int CUserDBentry::getField(const char* key)
+{
+	assert(key != NULL);
+
+	for (int i = 0; i < UDF_COUNT; i++) {
+		if (::strcmp(key, keyList[i]) == 0)
+			return i;
+	}
 
-bool CUserDBentry::isValidKey(const std::string& key)
+	return -1;
+}
+
+// Offset 0 is always an empty string, the values follow it
+void CUserDBentry::set(USERDB_FIELD field, const char* value)
 {
-	auto it = std::find(keyList.begin(), keyList.end(), key);
-	return it != keyList.end();
+	assert(value != NULL);
+
+	set(field, value, ::strlen(value));
 }
 
-void CUserDBentry::set(const std::string& key, const std::string& value)
+// value need not be NUL terminated
+void CUserDBentry::set(USERDB_FIELD field, const char* value, unsigned int length)
 {
-	if (!value.empty() && isValidKey(key))
-		m_db[key] = value;
+	assert(field < UDF_COUNT);
+	assert(value != NULL || length == 0U);
+
+	m_offsets[field] = append(value, length);
 }
 
-const std::string CUserDBentry::get(const std::string& key) const
+// Either part may be empty, the space is only put between two
+void CUserDBentry::format()
 {
-	try {
-		return m_db.at(key);
-	} catch (...) {
-		return "";
-	}
+	m_lines[UDL_CALL_NAME] = join(get(UDF_CALLSIGN), get(UDF_FIRST_NAME));
+	m_lines[UDL_FULL_NAME] = join(get(UDF_FIRST_NAME), get(UDF_LAST_NAME));
 }
 
-void CUserDBentry::clear(void)
+const char* CUserDBentry::getLine(USERDB_LINE line) const
 {
-	m_db.clear();
+	assert(line < UDL_COUNT);
+
+	return m_data + m_lines[line];
+}
+
+const char* CUserDBentry::get(USERDB_FIELD field) const
+{
+	assert(field < UDF_COUNT);
+
+	return m_data + m_offsets[field];
+}
+
+void CUserDBentry::clear()
+{
+	::memset(m_offsets, 0x00U, sizeof(m_offsets));
+	::memset(m_lines, 0x00U, sizeof(m_lines));
+	m_length  = 1U;
+	m_data[0] = '\0';
+}
+
+// Copies value to the end of the data, returning its offset, 0 for an
+// empty string when it is empty or there is no room left
+unsigned char CUserDBentry::append(const char* value, unsigned int length)
+{
+	if (length == 0U || m_length >= USERDB_ENTRY_LENGTH)
+		return 0U;
+
+	if (length > USERDB_ENTRY_LENGTH - m_length - 1U)
+		length = USERDB_ENTRY_LENGTH - m_length - 1U;
+
+	::memcpy(m_data + m_length, value, length);
+	m_data[m_length + length] = '\0';
+
+	unsigned char offset = m_length;
+	m_length += length + 1U;
+
+	return offset;
+}
+
+// The two fields, already in the data, copied with a space between them
+unsigned char CUserDBentry::join(const char* first, const char* second)
+{
+	// Either part alone is already stored
+	if (*second == '\0')
+		return (unsigned char)(first - m_data);
+	if (*first == '\0')
+		return (unsigned char)(second - m_data);
+
+	unsigned int firstLength  = ::strlen(first);
+	unsigned int secondLength = ::strlen(second);
+
+	// Without room for both, just the first
+	if (m_length + firstLength + 1U + secondLength + 1U > USERDB_ENTRY_LENGTH)
+		return (unsigned char)(first - m_data);
+
+	unsigned char offset = m_length;
+
+	::memcpy(m_data + m_length, first, firstLength);
+	m_data[m_length + firstLength] = ' ';
+	::memcpy(m_data + m_length + firstLength + 1U, second, secondLength);
+	m_data[m_length + firstLength + 1U + secondLength] = '\0';
+
+	m_length += firstLength + 1U + secondLength + 1U;
+
+	return offset;
 }
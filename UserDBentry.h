@@ -18,10 +18,6 @@
 
 #pragma once
 
-#include <string>
-#include <unordered_map>
-#include <vector>
-
 #define keyRADIO_ID	"RADIO_ID"
 #define keyCALLSIGN	"CALLSIGN"
 #define keyFIRST_NAME	"FIRST_NAME"
@@ -30,18 +26,56 @@
 #define keySTATE	"STATE"
 #define keyCOUNTRY	"COUNTRY"
 
+// The stored columns, RADIO_ID is the key and isn't stored as a field
+enum USERDB_FIELD {
+	UDF_CALLSIGN,
+	UDF_FIRST_NAME,
+	UDF_LAST_NAME,
+	UDF_CITY,
+	UDF_STATE,
+	UDF_COUNTRY,
+	UDF_COUNT
+};
+
+// Lines built from the fields by format(), as the displays draw them
+enum USERDB_LINE {
+	UDL_CALL_NAME,		// "CALLSIGN FIRST_NAME"
+	UDL_FULL_NAME,		// "FIRST_NAME LAST_NAME"
+	UDL_COUNT
+};
+
+const unsigned int USERDB_ENTRY_LENGTH = 192U;
+
+// One user's fields, copied out of CUserDBTable. All of the strings live in
+// one fixed buffer so an entry can be passed by value between threads
+// without allocating.
 class CUserDBentry {
 public:
 	CUserDBentry();
 	~CUserDBentry();
 
-	static const std::vector<std::string> keyList;
-	static bool isValidKey(const std::string& key);
+	static const char* const keyList[UDF_COUNT];
+
+	// Returns the field for a column keyword, or -1 for RADIO_ID and unknown columns
+	static int getField(const char* key);
 
-	void set(const std::string& key, const std::string& value);
-	const std::string get(const std::string& key) const;
-	void clear(void);
+	// Values that don't fit in the remaining space are truncated
+	void set(USERDB_FIELD field, const char* value);
+	void set(USERDB_FIELD field, const char* value, unsigned int length);
+	const char* get(USERDB_FIELD field) const;
+	void clear();
+
+	// Builds the lines once the fields are set, CDMRLookup does this before
+	// it caches an entry so that the drivers don't format them on every call
+	void format();
+	const char* getLine(USERDB_LINE line) const;
 
 private:
-	std::unordered_map<std::string, std::string>    m_db;
+	unsigned char m_offsets[UDF_COUNT];
+	unsigned char m_lines[UDL_COUNT];
+	unsigned int  m_length;
+	char          m_data[USERDB_ENTRY_LENGTH];
+
+	unsigned char append(const char* value, unsigned int length);
+	unsigned char join(const char* first, const char* second);
 };
@@ -0,0 +1,98 @@
+/*
+ *   Copyright (C) 2026 by BrandMeister
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <new>
+
+#include <cstdlib>
+
+// Counts every allocation through new on any thread, for allocations per
+// call in the benchmarks and tests. It replaces the global new and delete,
+// so include it in one source file of a program and never in the server.
+// It lives here rather than with the server's headers so that it isn't
+// part of the core library or on its include path.
+//
+// Each form of new and delete is replaced, none inlined, so that the
+// compiler never sees a malloc() reach a delete.
+
+static std::atomic<unsigned long long> allocations(0ULL);
+
+static unsigned long long getAllocations()
+{
+	return allocations.load(std::memory_order_relaxed);
+}
+
+__attribute__((noinline)) void* operator new(size_t size)
+{
+	allocations.fetch_add(1U, std::memory_order_relaxed);
+
+	void* p = ::malloc(size > 0U ? size : 1U);
+	if (p == NULL)
+		throw std::bad_alloc();
+
+	return p;
+}
+
+__attribute__((noinline)) void* operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+__attribute__((noinline)) void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+	allocations.fetch_add(1U, std::memory_order_relaxed);
+
+	return ::malloc(size > 0U ? size : 1U);
+}
+
+__attribute__((noinline)) void* operator new[](size_t size, const std::nothrow_t& tag) noexcept
+{
+	return operator new(size, tag);
+}
+
+__attribute__((noinline)) void operator delete(void* p) noexcept
+{
+	::free(p);
+}
+
+__attribute__((noinline)) void operator delete[](void* p) noexcept
+{
+	::free(p);
+}
+
+__attribute__((noinline)) void operator delete(void* p, size_t) noexcept
+{
+	::free(p);
+}
+
+__attribute__((noinline)) void operator delete[](void* p, size_t) noexcept
+{
+	::free(p);
+}
+
+__attribute__((noinline)) void operator delete(void* p, const std::nothrow_t&) noexcept
+{
+	::free(p);
+}
+
+__attribute__((noinline)) void operator delete[](void* p, const std::nothrow_t&) noexcept
+{
+	::free(p);
+}
@@ -0,0 +1,172 @@
+/*
+ *   Copyright (C) 2026 by BrandMeister
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+// Replaces new and delete, only this file of the test may include it
+#include "AllocCounter.h"
+
+#include "Test.h"
+
+#include "DisplayCoalescer.h"
+#include "DisplayDecoder.h"
+#include "DisplayEvent.h"
+#include "DisplayProtocol.h"
+#include "DMRLookup.h"
+#include "Log.h"
+#include "MockSerialPort.h"
+#include "Nextion.h"
+#include "TFTSurenoo.h"
+#include "UserDBentry.h"
+
+#include <string>
+
+#include <cstdio>
+#include <cstring>
+
+const unsigned int WARMUP = 64U;
+const unsigned int CALLS  = 2000U;
+
+// Calls from known and unknown IDs to a talkgroup or a private call, as
+// the network thread and the display writer see them in the server
+class CCallPath {
+public:
+	CCallPath(CDMRLookup* lookup, CDisplay& display, CMockSerialPort* port) :
+	m_lookup(lookup),
+	m_display(display),
+	m_port(port),
+	m_decoder(),
+	m_coalescer(256U)
+	{
+	}
+
+	// Decode, look up, queue and draw one call, as DisplayServer and DisplayWriter do
+	bool call(unsigned int n)
+	{
+		uint32_t src = n % 2U == 0U ? 2620000U + (n % 100U) * 7U : 9990000U + n;
+		uint32_t dst = n % 3U == 0U ? 2620007U : 91U;
+		unsigned char slotNo = 1U + n % 2U;
+		unsigned char flags  = n % 3U == 0U ? 0U : 1U;
+
+		unsigned char packet[] = {DISPLAY_DMR, slotNo, uint8_t(src >> 24), uint8_t(src >> 16), uint8_t(src >> 8), uint8_t(src),
+			flags, uint8_t(dst >> 24), uint8_t(dst >> 16), uint8_t(dst >> 8), uint8_t(dst), 'R'};
+
+		CDisplayMessage message;
+		if (!m_decoder.decode(packet, sizeof(packet), message))
+			return false;
+
+		CDisplayEvent event;
+		event.m_type       = message.m_type;
+		event.m_slotNo     = message.m_slotNo;
+		event.m_group      = message.m_group;
+		event.m_dmrType[0] = message.m_dmrType;
+
+		m_lookup->findUser(message.m_srcId, event.m_src);
+
+		const char* name = m_lookup->find(message.m_dstId);
+		::snprintf(event.m_dst, DISPLAY_EVENT_CALLSIGN_LENGTH, "%s", name);
+
+		if (!m_coalescer.add(event))
+			return false;
+
+		CDisplayEvent next;
+		if (!m_coalescer.get(next))
+			return false;
+
+		m_display.writeDMR(next.m_slotNo, next.m_src, next.m_group, next.m_dst, next.m_dmrType);
+		m_display.writeDMRRSSI(next.m_slotNo, 80U);
+		m_display.clearDMR(next.m_slotNo);
+		m_display.clock(3000U);
+
+		// Keeps its capacity, so the recorded output isn't an allocation
+		m_port->clear();
+
+		return true;
+	}
+
+private:
+	CDMRLookup*       m_lookup;
+	CDisplay&         m_display;
+	CMockSerialPort*  m_port;
+	CDisplayDecoder   m_decoder;
+	CDisplayCoalescer m_coalescer;
+};
+
+// After the warm up, no call allocates anywhere on its way to the display
+static void testCalls(CDMRLookup* lookup, CDisplay& display, CMockSerialPort* port, const char* name)
+{
+	CCallPath path(lookup, display, port);
+
+	bool ok = true;
+	for (unsigned int i = 0U; i < WARMUP; i++)
+		ok = path.call(i) && ok;
+
+	unsigned long long before = getAllocations();
+
+	for (unsigned int i = 0U; i < CALLS; i++)
+		ok = path.call(WARMUP + i) && ok;
+
+	unsigned long long count = getAllocations() - before;
+
+	::fprintf(stdout, "%s: %llu allocations in %u calls\n", name, count, CALLS);
+
+	CHECK(ok);
+	CHECK(count == 0ULL);
+}
+
+static std::string makeCSV()
+{
+	std::string text = "RADIO_ID,CALLSIGN,FIRST_NAME,LAST_NAME,CITY,STATE,COUNTRY\n";
+
+	char line[200U];
+	for (unsigned int i = 0U; i < 100U; i++) {
+		::snprintf(line, sizeof(line), "%u,DL%uABC,Name%u,Surname%u,City %u,State,Germany\n", 2620000U + i * 7U, i, i, i, i);
+		text += line;
+	}
+
+	return text;
+}
+
+int main()
+{
+	LogInitialise(0U, false);
+
+	CTestDir dir;
+	std::string filename = dir.write("DMRIds.dat", makeCSV());
+
+	CDMRLookup* lookup = new CDMRLookup(filename, 0U);
+	CHECK(lookup->read());
+
+	CMockSerialPort* nextionPort = new CMockSerialPort;
+	CNextion nextion("N0CALL", 1234567U, nextionPort, 50U, false, false, 20U, 2U, 438000000U, 430000000U, false);
+	nextion.setCommandDelay(0U);
+	CHECK(nextion.open());
+	testCalls(lookup, nextion, nextionPort, "nextion");
+	nextion.close();
+
+	CMockSerialPort* surenooPort = new CMockSerialPort;
+	CTFTSurenoo surenoo("N0CALL", 1234567U, surenooPort, 50U, false);
+	surenoo.setCommandDelay(0U);
+	CHECK(surenoo.open());
+	testCalls(lookup, surenoo, surenooPort, "surenoo");
+	surenoo.close();
+
+	lookup->stop();
+
+	LogFinalise();
+
+	return TEST_RESULT();
+}
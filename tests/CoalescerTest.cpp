@@ -0,0 +1,152 @@
+/*
+ *   Copyright (C) 2026 by BrandMeister
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "Test.h"
+
+#include "DisplayCoalescer.h"
+#include "DisplayProtocol.h"
+
+#include <cstring>
+#include <string>
+
+// Events are told apart by their text
+static CDisplayEvent makeEvent(unsigned char type, unsigned int slotNo, const char* text)
+{
+	CDisplayEvent event;
+	event.m_type   = type;
+	event.m_slotNo = slotNo;
+	::strncpy(event.m_text, text, DISPLAY_EVENT_TEXT_LENGTH - 1U);
+
+	return event;
+}
+
+// The texts of the events left to draw, in order, separated by spaces
+static std::string drain(CDisplayCoalescer& coalescer)
+{
+	std::string texts;
+
+	CDisplayEvent event;
+	while (coalescer.get(event)) {
+		if (!texts.empty())
+			texts += ' ';
+		texts += event.m_text;
+	}
+
+	return texts;
+}
+
+// A merged event used to stop the walk back, so a new call after two
+// RSSI reports drew the previous call as well
+static void testMergedIsNotBarrier()
+{
+	CDisplayCoalescer coalescer(16U);
+
+	coalescer.add(makeEvent(DISPLAY_DMR, 1U, "A"));
+	coalescer.add(makeEvent(DISPLAY_DMR_RSSI, 1U, "R1"));
+	coalescer.add(makeEvent(DISPLAY_DMR_RSSI, 1U, "R2"));
+	coalescer.add(makeEvent(DISPLAY_DMR, 1U, "B"));
+
+	CHECK(drain(coalescer) == "B");
+	CHECK(coalescer.getMerged() == 3ULL);
+}
+
+static void testLatestValueWins()
+{
+	CDisplayCoalescer coalescer(16U);
+
+	coalescer.add(makeEvent(DISPLAY_DMR, 1U, "A"));
+	coalescer.add(makeEvent(DISPLAY_DMR_RSSI, 1U, "R1"));
+	coalescer.add(makeEvent(DISPLAY_DMR_BER, 1U, "E1"));
+	coalescer.add(makeEvent(DISPLAY_DMR_RSSI, 1U, "R2"));
+	coalescer.add(makeEvent(DISPLAY_DMR_TA, 1U, "T1"));
+	coalescer.add(makeEvent(DISPLAY_DMR_BER, 1U, "E2"));
+	coalescer.add(makeEvent(DISPLAY_DMR_RSSI, 1U, "R3"));
+
+	CHECK(drain(coalescer) == "A T1 E2 R3");
+	CHECK(coalescer.getMerged() == 3ULL);
+}
+
+static void testSlotsAreSeparate()
+{
+	CDisplayCoalescer coalescer(16U);
+
+	coalescer.add(makeEvent(DISPLAY_DMR, 1U, "A"));
+	coalescer.add(makeEvent(DISPLAY_DMR_RSSI, 1U, "R1"));
+	coalescer.add(makeEvent(DISPLAY_DMR, 2U, "B"));
+	coalescer.add(makeEvent(DISPLAY_DMR_RSSI, 2U, "R2"));
+
+	CHECK(drain(coalescer) == "A R1 B R2");
+	CHECK(coalescer.getMerged() == 0ULL);
+}
+
+// A clear drops the call's reports but the call is still shown
+static void testClearKeepsCall()
+{
+	CDisplayCoalescer coalescer(16U);
+
+	coalescer.add(makeEvent(DISPLAY_DMR, 1U, "A"));
+	coalescer.add(makeEvent(DISPLAY_DMR_RSSI, 1U, "R1"));
+	coalescer.add(makeEvent(DISPLAY_DMR_TA, 1U, "T1"));
+	coalescer.add(makeEvent(DISPLAY_DMR_CLEAR, 1U, "C"));
+
+	CHECK(drain(coalescer) == "A C");
+	CHECK(coalescer.getMerged() == 2ULL);
+}
+
+// Nothing is merged across a mode change, even past merged events
+static void testBarrier()
+{
+	CDisplayCoalescer coalescer(16U);
+
+	coalescer.add(makeEvent(DISPLAY_DMR, 1U, "A"));
+	coalescer.add(makeEvent(DISPLAY_DMR_RSSI, 1U, "R1"));
+	coalescer.add(makeEvent(DISPLAY_DMR_RSSI, 1U, "R2"));
+	coalescer.add(makeEvent(DISPLAY_IDLE, 0U, "I"));
+	coalescer.add(makeEvent(DISPLAY_DMR_RSSI, 1U, "R3"));
+	coalescer.add(makeEvent(DISPLAY_DMR, 1U, "B"));
+
+	CHECK(drain(coalescer) == "A R2 I B");
+	CHECK(coalescer.getMerged() == 2ULL);
+}
+
+// Merged events still take their place until they are got
+static void testFull()
+{
+	CDisplayCoalescer coalescer(3U);
+
+	CHECK(coalescer.add(makeEvent(DISPLAY_DMR_RSSI, 1U, "R1")));
+	CHECK(coalescer.add(makeEvent(DISPLAY_DMR_RSSI, 1U, "R2")));
+	CHECK(coalescer.add(makeEvent(DISPLAY_DMR_RSSI, 1U, "R3")));
+	CHECK(coalescer.isFull());
+	CHECK(!coalescer.add(makeEvent(DISPLAY_DMR_RSSI, 1U, "R4")));
+
+	CHECK(drain(coalescer) == "R3");
+	CHECK(!coalescer.isFull());
+}
+
+int main()
+{
+	testMergedIsNotBarrier();
+	testLatestValueWins();
+	testSlotsAreSeparate();
+	testClearKeepsCall();
+	testBarrier();
+	testFull();
+
+	return TEST_RESULT();
+}
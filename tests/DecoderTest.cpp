@@ -0,0 +1,293 @@
+/*
+ *   Copyright (C) 2026 by BrandMeister
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "Test.h"
+
+#include "DisplayDecoder.h"
+#include "DisplayEncoder.h"
+#include "DisplayProtocol.h"
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include <cstring>
+
+// Decodes a copy of exactly packet.size() bytes, so that a read past the end
+// is a read past the allocation, and checks any text view stays inside it.
+// The copy is gone on return, so the text is returned as a string.
+static bool decode(CDisplayDecoder& decoder, const std::string& packet, CDisplayMessage& message, std::string* text = NULL)
+{
+	std::vector<unsigned char> data(packet.begin(), packet.end());
+	const unsigned char* p = data.empty() ? NULL : data.data();
+
+	message = CDisplayMessage();
+
+	bool ok;
+	if (!data.empty() && data[0U] == DISPLAY_FRAME) {
+		CDisplayFrame frame;
+		ok = decoder.decodeFrame(p, data.size(), frame);
+
+		const unsigned char* update;
+		unsigned int length;
+		while (ok && frame.next(update, length)) {
+			CHECK(update >= p && update + length <= p + data.size());
+			ok = decoder.decode(update, length, message);
+		}
+	} else {
+		ok = p != NULL && decoder.decode(p, data.size(), message);
+	}
+
+	if (ok && message.m_text != NULL) {
+		CHECK(message.m_text >= p && message.m_text + message.m_textLength <= p + data.size());
+
+		if (text != NULL)
+			text->assign((const char*)message.m_text, message.m_textLength);
+	}
+
+	message.m_text = NULL;
+
+	return ok;
+}
+
+// One v1 datagram per update, as a frame of one holds it after the header and the length byte
+static void makeValid(std::vector<std::string>& packets)
+{
+	unsigned char buffer[DISPLAY_FRAME_MAX_LENGTH];
+	CDisplayEncoder encoder(buffer, sizeof(buffer));
+
+	for (unsigned int i = 0U; i < 10U; i++) {
+		encoder.begin();
+
+		switch (i) {
+		case 0U: encoder.writeDMR(1U, 2621234U, true, 91U, 'R'); break;
+		case 1U: encoder.writeDMRRSSI(2U, 87U); break;
+		case 2U: encoder.writeDMRBER(1U, 1.5F); break;
+		case 3U: encoder.writeDMRTA(1U, 'R', "DL1ABC Hans"); break;
+		case 4U: encoder.clearDMR(1U); break;
+		case 5U: encoder.writeDMR(2U, 3100001U, false, 2621234U, 'N'); break;
+		case 6U: encoder.writePOCSAG(224U, "YYYYMMDDHHMMSS260101120000"); break;
+		case 7U: encoder.clearPOCSAG(); break;
+		case 8U: encoder.setError("Modem not responding"); break;
+		default: encoder.setIdle(); break;
+		}
+
+		unsigned int length = encoder.end();
+		packets.push_back(std::string((const char*)buffer + DISPLAY_FRAME_HEADER_LENGTH + 1U, length - DISPLAY_FRAME_HEADER_LENGTH - 1U));
+	}
+}
+
+static void testValid()
+{
+	CDisplayDecoder decoder;
+	CDisplayMessage message;
+
+	std::vector<std::string> valid;
+	makeValid(valid);
+
+	for (std::vector<std::string>::const_iterator it = valid.begin(); it != valid.end(); ++it)
+		CHECK(decode(decoder, *it, message));
+
+	CHECK(decode(decoder, valid[0U], message));
+	CHECK(message.m_type == DISPLAY_DMR && message.m_slotNo == 1U && message.m_srcId == 2621234U);
+	CHECK(message.m_group && message.m_dstId == 91U && message.m_dmrType == 'R');
+
+	CHECK(decode(decoder, valid[1U], message));
+	CHECK(message.m_slotNo == 2U && message.m_rssi == 87U);
+
+	CHECK(decode(decoder, valid[2U], message));
+	CHECK(message.m_ber > 1.49F && message.m_ber < 1.51F);
+
+	std::string text;
+	CHECK(decode(decoder, valid[3U], message, &text));
+	CHECK(text == "DL1ABC Hans");
+
+	CHECK(decode(decoder, valid[6U], message));
+	CHECK(message.m_ric == 224U && message.m_textLength == 26U);
+
+	CHECK(decoder.getErrors() == 0ULL);
+}
+
+// Every truncation of each valid update, and text counts past the end
+static void testTruncated()
+{
+	CDisplayDecoder decoder;
+	CDisplayMessage message;
+
+	std::vector<std::string> valid;
+	makeValid(valid);
+
+	unsigned long long cases = 0ULL;
+	for (std::vector<std::string>::const_iterator it = valid.begin(); it != valid.end(); ++it) {
+		CHECK(!decode(decoder, std::string(), message));
+
+		for (unsigned int length = 1U; length < it->size(); length++, cases++)
+			CHECK(!decode(decoder, it->substr(0U, length), message));
+
+		unsigned char type = (unsigned char)it->at(0U);
+		if (type == DISPLAY_DMR_TA || type == DISPLAY_POCSAG || type == DISPLAY_ERROR) {
+			unsigned int offset = type == DISPLAY_DMR_TA ? 3U : type == DISPLAY_POCSAG ? 5U : 1U;
+
+			std::string packet = *it;
+			packet[offset] = char((unsigned char)packet[offset] + 1U);
+			CHECK(!decode(decoder, packet, message));
+
+			packet[offset] = char(0xFFU);
+			CHECK(!decode(decoder, packet, message));
+			cases += 2ULL;
+		}
+	}
+
+	CHECK(decoder.getErrors() == cases);
+}
+
+static void testBadSlots()
+{
+	CDisplayDecoder decoder;
+	CDisplayMessage message;
+
+	static const unsigned char SLOTS[] = {0U, 3U, 0xFFU};
+	for (unsigned int i = 0U; i < 3U; i++) {
+		const unsigned char RSSI[]  = {DISPLAY_DMR_RSSI, SLOTS[i], 80U};
+		const unsigned char CLEAR[] = {DISPLAY_DMR_CLEAR, SLOTS[i]};
+		const unsigned char BER[]   = {DISPLAY_DMR_BER, SLOTS[i], 3U, '1', '.', '5'};
+		CHECK(!decode(decoder, std::string((const char*)RSSI, sizeof(RSSI)), message));
+		CHECK(!decode(decoder, std::string((const char*)CLEAR, sizeof(CLEAR)), message));
+		CHECK(!decode(decoder, std::string((const char*)BER, sizeof(BER)), message));
+	}
+}
+
+static void testUnknownOpcodes()
+{
+	CDisplayDecoder decoder;
+	CDisplayMessage message;
+
+	for (unsigned int opcode = DISPLAY_OPCODE_COUNT; opcode < 256U; opcode++) {
+		if (opcode == DISPLAY_FRAME)
+			continue;
+
+		CHECK(!decode(decoder, std::string(16U, char(opcode)), message));
+	}
+
+	CHECK(!decode(decoder, std::string(1U, char(0x00U)), message));
+}
+
+// Counts and lengths running past the end, an update of length 0, another
+// version, a frame holding a malformed update
+static void testBadFrames()
+{
+	CDisplayDecoder decoder;
+	CDisplayMessage message;
+
+	static const unsigned char FRAMES[][9U] = {
+		{DISPLAY_FRAME, DISPLAY_FRAME_VERSION, 0U, 1U, 255U, 3U, DISPLAY_DMR_RSSI, 1U, 80U},
+		{DISPLAY_FRAME, DISPLAY_FRAME_VERSION, 0U, 2U, 1U, 200U, DISPLAY_DMR_RSSI, 1U, 80U},
+		{DISPLAY_FRAME, DISPLAY_FRAME_VERSION, 0U, 3U, 2U, 0U, 1U, DISPLAY_IDLE, 0U},
+		{DISPLAY_FRAME, DISPLAY_FRAME_VERSION + 1U, 0U, 4U, 1U, 1U, DISPLAY_IDLE, 0U, 0U},
+		{DISPLAY_FRAME, DISPLAY_FRAME_VERSION, 0U, 5U, 1U, 3U, DISPLAY_DMR_RSSI, 7U, 80U}
+	};
+
+	for (unsigned int i = 0U; i < sizeof(FRAMES) / sizeof(FRAMES[0U]); i++) {
+		for (unsigned int length = 1U; length <= sizeof(FRAMES[0U]); length++)
+			CHECK(!decode(decoder, std::string((const char*)FRAMES[i], length), message));
+	}
+}
+
+// Whatever random bytes are accepted, nothing may point outside them
+static void testRandom()
+{
+	CDisplayDecoder decoder;
+	CDisplayMessage message;
+
+	std::mt19937 random(5U);
+	for (unsigned int i = 0U; i < 200000U; i++) {
+		std::string packet(1U + random() % 40U, '\0');
+		for (unsigned int j = 0U; j < packet.size(); j++)
+			packet[j] = char(random() & 0xFFU);
+
+		// Mostly known opcodes, to get past the table
+		packet[0U] = char(i % 4U == 0U ? DISPLAY_FRAME : random() % (DISPLAY_OPCODE_COUNT + 1U));
+
+		decode(decoder, packet, message);
+	}
+}
+
+static void testSequence()
+{
+	CDisplayDecoder decoder;
+
+	CHECK(decoder.checkSequence(100U));
+	CHECK(decoder.checkSequence(101U));
+	CHECK(decoder.checkSequence(104U));
+	CHECK(decoder.getLost() == 2ULL);
+
+	// Late, then the same again
+	CHECK(decoder.checkSequence(103U));
+	CHECK(!decoder.checkSequence(103U));
+	CHECK(decoder.getLost() == 1ULL && decoder.getReordered() == 1ULL && decoder.getDuplicates() == 1ULL);
+
+	CHECK(decoder.getResyncs() == 0ULL);
+}
+
+static void testWrap()
+{
+	CDisplayDecoder decoder;
+
+	CHECK(decoder.checkSequence(65534U));
+	CHECK(decoder.checkSequence(65535U));
+	CHECK(decoder.checkSequence(1U));
+	CHECK(decoder.checkSequence(0U));
+	CHECK(decoder.getLost() == 0ULL && decoder.getReordered() == 1ULL && decoder.getResyncs() == 0ULL);
+}
+
+// A sender restarting, from high back to 0, is neither loss nor a late frame
+static void testRestart()
+{
+	CDisplayDecoder decoder;
+
+	for (unsigned int sequence = 30000U; sequence < 30100U; sequence++)
+		CHECK(decoder.checkSequence(uint16_t(sequence)));
+
+	CHECK(decoder.checkSequence(0U));
+	CHECK(decoder.checkSequence(1U));
+	CHECK(decoder.getResyncs() == 1ULL);
+	CHECK(decoder.getLost() == 0ULL && decoder.getReordered() == 0ULL && decoder.getDuplicates() == 0ULL);
+
+	// And forward by more than the window
+	CHECK(decoder.checkSequence(1U + DISPLAY_SEQUENCE_WINDOW + 2U));
+	CHECK(decoder.getResyncs() == 2ULL && decoder.getLost() == 0ULL);
+
+	// Up to the window is loss
+	CHECK(decoder.checkSequence(1U + DISPLAY_SEQUENCE_WINDOW + 3U + DISPLAY_SEQUENCE_WINDOW));
+	CHECK(decoder.getResyncs() == 2ULL && decoder.getLost() == DISPLAY_SEQUENCE_WINDOW);
+}
+
+int main()
+{
+	testValid();
+	testTruncated();
+	testBadSlots();
+	testUnknownOpcodes();
+	testBadFrames();
+	testRandom();
+	testSequence();
+	testWrap();
+	testRestart();
+
+	return TEST_RESULT();
+}
@@ -0,0 +1,298 @@
+/*
+ *   Copyright (C) 2026 by BrandMeister
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "Test.h"
+
+#include "DMRLookup.h"
+#include "Log.h"
+#include "Thread.h"
+#include "UserDB.h"
+#include "UserDBentry.h"
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+const unsigned int ROWS = 20000U;
+
+// Lookups never wait for a reload, which testHeldLock() checks without
+// timing. This bound on a single lookup only catches a reader that hangs,
+// and can be raised for a slow machine with RELOAD_TEST_MAX_LOOKUP_MS.
+const uint64_t MAX_LOOKUP_MS = 1000ULL;
+
+static uint64_t now()
+{
+	struct timespec ts;
+	::clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return uint64_t(ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+}
+
+static unsigned int getId(unsigned int n)
+{
+	return 2620000U + n * 3U;
+}
+
+// Each version of the file has the same IDs with the version in every field
+static std::string makeCSV(char version)
+{
+	std::string text = "RADIO_ID,CALLSIGN,FIRST_NAME,LAST_NAME,CITY,STATE,COUNTRY\n";
+
+	char line[200U];
+	for (unsigned int i = 0U; i < ROWS; i++) {
+		::snprintf(line, sizeof(line), "%u,DL%u%c,Name%u%c,Surname,City %u%c,State,Germany\n", getId(i), i % 10U, version, i % 500U, version, i % 900U, version);
+		text += line;
+	}
+
+	return text;
+}
+
+// Looks up every ID in turn until stopped
+class CReader : public CThread {
+public:
+	CReader(CUserDB& userDB) :
+	m_userDB(userDB),
+	m_stop(false),
+	m_lookups(0ULL),
+	m_misses(0ULL),
+	m_torn(0ULL),
+	m_maxTime(0ULL)
+	{
+	}
+
+	virtual void entry() override
+	{
+		CUserDBentry entry;
+
+		for (unsigned int n = 0U; !m_stop.load(std::memory_order_relaxed); n++) {
+			uint64_t start = now();
+			bool found = m_userDB.lookup(getId(n % ROWS), &entry);
+			uint64_t time = now() - start;
+
+			m_lookups.store(m_lookups.load(std::memory_order_relaxed) + 1U, std::memory_order_relaxed);
+			if (time > m_maxTime)
+				m_maxTime = time;
+
+			if (!found) {
+				m_misses++;
+				continue;
+			}
+
+			// Every field from the same version of the file
+			const char* callsign = entry.get(UDF_CALLSIGN);
+			char version = callsign[::strlen(callsign) - 1U];
+			const char* name = entry.get(UDF_FIRST_NAME);
+			const char* city = entry.get(UDF_CITY);
+			if (name[::strlen(name) - 1U] != version || city[::strlen(city) - 1U] != version)
+				m_torn++;
+		}
+	}
+
+	void stop()
+	{
+		m_stop.store(true, std::memory_order_relaxed);
+		wait();
+	}
+
+	// Also read while the reader runs
+	unsigned long long getLookups() const { return m_lookups.load(std::memory_order_relaxed); }
+	unsigned long long getMisses() const  { return m_misses; }
+	unsigned long long getTorn() const    { return m_torn; }
+	uint64_t           getMaxTime() const { return m_maxTime; }
+
+private:
+	CUserDB&           m_userDB;
+	std::atomic<bool>  m_stop;
+	std::atomic<unsigned long long> m_lookups;
+	unsigned long long m_misses;
+	unsigned long long m_torn;
+	uint64_t           m_maxTime;
+};
+
+static uint64_t getMaxLookup()
+{
+	const char* value = ::getenv("RELOAD_TEST_MAX_LOOKUP_MS");
+	uint64_t ms = value != NULL ? ::strtoull(value, NULL, 10) : 0ULL;
+
+	return (ms > 0ULL ? ms : MAX_LOOKUP_MS) * 1000000ULL;
+}
+
+// Reloads alternate between the two files under a reader
+static void testReload(const char* name, const std::string& file1, const std::string& file2, unsigned int reloads, bool lazy)
+{
+	CUserDB userDB;
+	userDB.setLazy(lazy);
+	CHECK(userDB.load(file1));
+
+	CReader reader(userDB);
+	CHECK(reader.run());
+
+	// Until the reader has started
+	while (reader.getLookups() == 0ULL)
+		::usleep(1000U);
+
+	unsigned int generation = userDB.getGeneration();
+	for (unsigned int i = 0U; i < reloads; i++)
+		CHECK(userDB.load(i % 2U == 0U ? file2 : file1));
+
+	reader.stop();
+
+	::fprintf(stderr, "%s: %u reloads, %llu lookups, %llu misses, %llu torn, max %.3f ms\n", name, reloads,
+		reader.getLookups(), reader.getMisses(), reader.getTorn(), double(reader.getMaxTime()) / 1000000.0);
+
+	CHECK(userDB.getGeneration() != generation);
+	CHECK(reader.getMisses() == 0ULL);
+	CHECK(reader.getTorn() == 0ULL);
+	CHECK(reader.getMaxTime() <= getMaxLookup());
+}
+
+// Saves into a file until the other end of its FIFO is opened
+class CSaver : public CThread {
+public:
+	CSaver(CUserDB& userDB, const std::string& file) :
+	m_userDB(userDB),
+	m_file(file),
+	m_ret(false)
+	{
+	}
+
+	virtual void entry() override
+	{
+		m_ret = m_userDB.save(m_file);
+	}
+
+	bool getRet() const { return m_ret; }
+
+private:
+	CUserDB&    m_userDB;
+	std::string m_file;
+	bool        m_ret;
+};
+
+// save() takes the lock that serialises reloads and saves, then blocks
+// opening its temporary file while that is a FIFO with no reader. The
+// reader must carry on looking up while the lock is held, a lookup that
+// waits for a reload or save stops it dead until the FIFO is opened.
+static void testHeldLock(CTestDir& dir, const std::string& file)
+{
+	CUserDB userDB;
+	CHECK(userDB.load(file));
+
+	std::string saved = dir.path("DMRIds-held.bin");
+	std::string fifo  = saved + ".tmp";
+	CHECK(::mkfifo(fifo.c_str(), 0600) == 0);
+
+	CReader reader(userDB);
+	CHECK(reader.run());
+
+	CSaver saver(userDB, saved);
+	CHECK(saver.run());
+
+	// Long enough for the saver to be blocked holding the lock
+	::usleep(100000U);
+
+	unsigned long long before = reader.getLookups();
+	::usleep(100000U);
+	unsigned long long during = reader.getLookups() - before;
+
+	// Let the save finish whatever happened
+	int fd = ::open(fifo.c_str(), O_RDONLY);
+	CHECK(fd >= 0);
+
+	char buffer[4096U];
+	while (fd >= 0 && ::read(fd, buffer, sizeof(buffer)) > 0)
+		;
+	if (fd >= 0)
+		::close(fd);
+
+	saver.wait();
+	reader.stop();
+
+	::fprintf(stderr, "held: %llu lookups while the lock was held\n", during);
+
+	CHECK(saver.getRet());
+	CHECK(during > 0ULL);
+	CHECK(reader.getMisses() == 0ULL);
+}
+
+// With no descriptor left for the reload thread's epoll instance, the
+// lookup still works and can be stopped, it is just never reloaded.
+// Setting up the thread used to carry on and assert in the reactor.
+static void testNoReloadThread(const std::string& file)
+{
+	struct rlimit saved;
+	CHECK(::getrlimit(RLIMIT_NOFILE, &saved) == 0);
+
+	// The lowest free descriptor is taken by the file while it loads and
+	// then by the eventfd, nothing is left for epoll
+	int fd = ::dup(0);
+	CHECK(fd >= 0);
+	::close(fd);
+
+	struct rlimit limit = saved;
+	limit.rlim_cur = fd + 1;
+	CHECK(::setrlimit(RLIMIT_NOFILE, &limit) == 0);
+
+	CDMRLookup* lookup = new CDMRLookup(file, 1U);
+	CHECK(lookup->read());
+
+	CHECK(::setrlimit(RLIMIT_NOFILE, &saved) == 0);
+
+	CHECK(::strcmp(lookup->find(getId(0U)), "DL0A") == 0);
+
+	lookup->stop();
+}
+
+int main()
+{
+	LogInitialise(0U, false);
+
+	CTestDir dir;
+
+	std::string csv1 = dir.write("DMRIds-1.dat", makeCSV('A'));
+	std::string csv2 = dir.write("DMRIds-2.dat", makeCSV('B'));
+
+	testReload("csv", csv1, csv2, 10U, false);
+	testReload("lazy", csv1, csv2, 10U, true);
+
+	std::string bin1 = dir.path("DMRIds-1.bin");
+	std::string bin2 = dir.path("DMRIds-2.bin");
+	CUserDB compiler;
+	CHECK(compiler.load(csv1) && compiler.save(bin1));
+	CHECK(compiler.load(csv2) && compiler.save(bin2));
+
+	testReload("compiled", bin1, bin2, 200U, false);
+
+	testHeldLock(dir, csv1);
+
+	testNoReloadThread(csv1);
+
+	LogFinalise();
+
+	return TEST_RESULT();
+}
@@ -0,0 +1,105 @@
+/*
+ *   Copyright (C) 2026 by BrandMeister
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <cstdio>
+#include <cstdlib>
+
+#include <unistd.h>
+
+// The tests are plain programs: each failed CHECK() is reported and the
+// test exits with TEST_RESULT(), non-zero when anything failed. A test of
+// something left out of the build exits with TEST_SKIP() instead, which
+// ctest reports as skipped.
+
+static unsigned int failures = 0U;
+
+#define CHECK(cond) \
+	do { \
+		if (!(cond)) { \
+			::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+			failures++; \
+		} \
+	} while (0)
+
+#define TEST_RESULT() (failures > 0U ? 1 : 0)
+
+#define TEST_SKIP(reason) (::fprintf(stderr, "SKIP: %s\n", reason), failures > 0U ? 1 : 77)
+
+// A temporary directory, removed with the files made in it
+class CTestDir {
+public:
+	CTestDir() :
+	m_dir(),
+	m_files()
+	{
+		char dir[] = "/tmp/DisplayServer-test.XXXXXX";
+		if (::mkdtemp(dir) != NULL)
+			m_dir = dir;
+	}
+
+	~CTestDir()
+	{
+		for (std::vector<std::string>::const_iterator it = m_files.begin(); it != m_files.end(); ++it)
+			::unlink(it->c_str());
+
+		if (!m_dir.empty())
+			::rmdir(m_dir.c_str());
+	}
+
+	// Writes text to a new file in the directory and returns its path
+	std::string write(const char* name, const std::string& text)
+	{
+		std::string filename = m_dir + "/" + name;
+		add(filename);
+
+		FILE* fp = ::fopen(filename.c_str(), "wb");
+		if (fp == NULL)
+			return filename;
+
+		::fwrite(text.data(), 1U, text.size(), fp);
+		::fclose(fp);
+
+		return filename;
+	}
+
+	// A file made in the directory some other way
+	std::string add(const std::string& filename)
+	{
+		for (std::vector<std::string>::const_iterator it = m_files.begin(); it != m_files.end(); ++it) {
+			if (*it == filename)
+				return filename;
+		}
+
+		m_files.push_back(filename);
+		return filename;
+	}
+
+	std::string path(const char* name)
+	{
+		return add(m_dir + "/" + name);
+	}
+
+private:
+	std::string              m_dir;
+	std::vector<std::string> m_files;
+};
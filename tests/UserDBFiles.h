@@ -0,0 +1,62 @@
+/*
+ *   Copyright (C) 2026 by BrandMeister
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#pragma once
+
+#include "Test.h"
+
+#include "UserDB.h"
+
+#include <string>
+
+#include <cstdio>
+
+// Shared by the tests of the ID file formats
+
+static std::string readFile(const std::string& filename)
+{
+	std::string text;
+
+	FILE* fp = ::fopen(filename.c_str(), "rb");
+	if (fp == NULL)
+		return text;
+
+	char buffer[65536U];
+	size_t n;
+	while ((n = ::fread(buffer, 1U, sizeof(buffer), fp)) > 0U)
+		text.append(buffer, n);
+
+	::fclose(fp);
+
+	return text;
+}
+
+// The loaded table as a compiled file, empty if it didn't load, so that
+// two loads can be compared byte for byte
+static std::string compile(CTestDir& dir, const std::string& filename)
+{
+	CUserDB userDB;
+	if (!userDB.load(filename))
+		return std::string();
+
+	std::string compiled = dir.path("compiled.bin");
+	if (!userDB.save(compiled))
+		return std::string();
+
+	return readFile(compiled);
+}
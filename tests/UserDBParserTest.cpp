@@ -0,0 +1,124 @@
+/*
+ *   Copyright (C) 2026 by BrandMeister
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "Test.h"
+
+#include "Log.h"
+#include "UserDB.h"
+#include "UserDBentry.h"
+#include "UserDBParser.h"
+
+#include <random>
+#include <string>
+
+#include <cstring>
+
+// The vectorised scan must find what the scalar loop finds, from every
+// start to every end, whatever the delimiters and their density
+static void testScanner()
+{
+	static const char DELIMITERS[] = {',', '\t', '\r', '\n'};
+
+	std::mt19937 random(11U);
+
+	unsigned int wrong = 0U;
+	for (unsigned int density = 1U; density <= 64U; density *= 4U) {
+		char buffer[96U];
+		for (unsigned int i = 0U; i < sizeof(buffer); i++) {
+			if (random() % density == 0U)
+				buffer[i] = DELIMITERS[random() % 4U];
+			else
+				buffer[i] = char(random() % 256U);
+		}
+
+		for (unsigned int begin = 0U; begin < sizeof(buffer); begin++) {
+			for (unsigned int end = begin; end <= sizeof(buffer); end++) {
+				if (CUserDBParser::findDelimiter(buffer + begin, buffer + end) != CUserDBParser::findDelimiterScalar(buffer + begin, buffer + end))
+					wrong++;
+			}
+		}
+	}
+
+	CHECK(wrong == 0U);
+
+	::fprintf(stderr, "scanner: %s\n", CUserDBParser::getScanner());
+}
+
+static bool hasFields(CUserDB& userDB, unsigned int id, const char* callsign, const char* name, const char* city)
+{
+	CUserDBentry entry;
+	if (!userDB.lookup(id, &entry))
+		return false;
+
+	return ::strcmp(entry.get(UDF_CALLSIGN), callsign) == 0 && ::strcmp(entry.get(UDF_FIRST_NAME), name) == 0 &&
+		::strcmp(entry.get(UDF_CITY), city) == 0;
+}
+
+static void testHeaderless(CTestDir& dir)
+{
+	CUserDB userDB;
+	CHECK(userDB.load(dir.write("headerless.dat", "2621234,dl1abc,Hans\n2621235,DL1ABD,Erika\n")));
+	CHECK(userDB.getSize() == 2U);
+	CHECK(hasFields(userDB, 2621234U, "DL1ABC", "Hans", ""));
+	CHECK(hasFields(userDB, 2621235U, "DL1ABD", "Erika", ""));
+}
+
+// Tabs, CRLF, comments, columns in another order, extra columns and short rows
+static void testColumns(CTestDir& dir)
+{
+	CUserDB userDB;
+	CHECK(userDB.load(dir.write("columns.dat",
+		"CALLSIGN\tNOTES\tRADIO_ID\tCITY\tFIRST_NAME\r\n"
+		"# a comment\r\n"
+		"dl1abc\tlorem\t2621234\tBerlin\tHans\r\n"
+		"DL1ABD\t\t2621235\tHamburg\r\n"
+		"DL1ABE\tipsum\t2621236\tBonn\tFritz\tExtra\r\n"
+		"\r\n")));
+
+	CHECK(userDB.getSize() == 3U);
+	CHECK(hasFields(userDB, 2621234U, "DL1ABC", "Hans", "Berlin"));
+	CHECK(hasFields(userDB, 2621235U, "DL1ABD", "", "Hamburg"));
+	CHECK(hasFields(userDB, 2621236U, "DL1ABE", "Fritz", "Bonn"));
+
+	// The blank CRLF line used to become ID 0
+	CHECK(!userDB.lookup(0U, NULL));
+}
+
+// A file without a final newline and fields running right to its end
+static void testEnd(CTestDir& dir)
+{
+	CUserDB userDB;
+	CHECK(userDB.load(dir.write("end.dat", "RADIO_ID,CALLSIGN,FIRST_NAME\n2621234,DL1ABC,Hans\n2621235,DL1ABD,Erika")));
+	CHECK(hasFields(userDB, 2621235U, "DL1ABD", "Erika", ""));
+}
+
+int main()
+{
+	LogInitialise(0U, false);
+
+	CTestDir dir;
+
+	testScanner();
+	testHeaderless(dir);
+	testColumns(dir);
+	testEnd(dir);
+
+	LogFinalise();
+
+	return TEST_RESULT();
+}
@@ -0,0 +1,75 @@
+/*
+ *   Copyright (C) 2026 by BrandMeister
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "Test.h"
+#include "UserDBFiles.h"
+
+#include "Log.h"
+#include "UserDBStream.h"
+
+#include <string>
+
+// DMRIds.csv.gz and DMRIds.csv.zst are DMRIds.csv compressed by the gzip
+// and zstd tools, so that the decompression is checked against files this
+// code didn't write:
+//
+//   gzip -9 -n -c DMRIds.csv > DMRIds.csv.gz
+//   zstd -19 DMRIds.csv -o DMRIds.csv.zst
+
+static void testFormats(CTestDir& dir)
+{
+	CHECK(CUserDBStream::getCompression("DMRIds.csv") == UDC_NONE);
+	CHECK(CUserDBStream::getCompression("DMRIds.csv.gz") == UDC_GZIP);
+	CHECK(CUserDBStream::getCompression("DMRIds.csv.zst") == UDC_ZSTD);
+
+	// Told from the content, not the name
+	std::string renamed = dir.write("DMRIds.dat", readFile("DMRIds.csv.zst"));
+	CHECK(CUserDBStream::getCompression(renamed) == UDC_ZSTD);
+}
+
+static void testFixtures(CTestDir& dir)
+{
+	std::string expected = compile(dir, "DMRIds.csv");
+	CHECK(!expected.empty());
+
+#if defined(HAVE_ZLIB)
+	CHECK(compile(dir, "DMRIds.csv.gz") == expected);
+#else
+	CHECK(compile(dir, "DMRIds.csv.gz").empty());
+#endif
+
+#if defined(HAVE_ZSTD)
+	CHECK(compile(dir, "DMRIds.csv.zst") == expected);
+#else
+	CHECK(compile(dir, "DMRIds.csv.zst").empty());
+#endif
+}
+
+int main()
+{
+	LogInitialise(0U, false);
+
+	CTestDir dir;
+
+	testFormats(dir);
+	testFixtures(dir);
+
+	LogFinalise();
+
+	return TEST_RESULT();
+}
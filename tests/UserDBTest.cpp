@@ -0,0 +1,247 @@
+/*
+ *   Copyright (C) 2026 by BrandMeister
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "Test.h"
+
+#include "DMRLookup.h"
+#include "Log.h"
+#include "UserDB.h"
+#include "UserDBentry.h"
+
+#include <string>
+
+#include <cstring>
+
+// n rows with repeated names, cities and countries, IDs a few apart
+static std::string makeCSV(unsigned int n)
+{
+	static const char* COUNTRIES[] = {"Germany", "United Kingdom", "United States", "France"};
+
+	std::string text = "RADIO_ID,CALLSIGN,FIRST_NAME,LAST_NAME,CITY,STATE,COUNTRY\n";
+
+	char line[200U];
+	for (unsigned int i = 0U; i < n; i++) {
+		unsigned int id = 2620000U + i * 7U;
+		::snprintf(line, sizeof(line), "%u,dl%uabc,Name%u,Surname%u,City %u,State %u,%s\n", id, i % 10U,
+			i % 500U, i % 2000U, i % 900U, i % 50U, COUNTRIES[i % 4U]);
+		text += line;
+	}
+
+	return text;
+}
+
+static bool hasFields(CUserDB& userDB, unsigned int id, const char* callsign, const char* name, const char* city, const char* country)
+{
+	CUserDBentry entry;
+	if (!userDB.lookup(id, &entry))
+		return false;
+
+	return ::strcmp(entry.get(UDF_CALLSIGN), callsign) == 0 && ::strcmp(entry.get(UDF_FIRST_NAME), name) == 0 &&
+		::strcmp(entry.get(UDF_CITY), city) == 0 && ::strcmp(entry.get(UDF_COUNTRY), country) == 0;
+}
+
+// Every row comes back whole, upper cased, and nothing else is found
+static void testTable(CTestDir& dir)
+{
+	const unsigned int ROWS = 20000U;
+
+	std::string filename = dir.write("DMRIds.dat", makeCSV(ROWS));
+
+	CUserDB userDB;
+	CHECK(userDB.load(filename));
+	CHECK(userDB.getSize() == ROWS);
+
+	unsigned int wrong = 0U;
+	for (unsigned int i = 0U; i < ROWS; i++) {
+		char callsign[20U], name[20U], city[20U];
+		::snprintf(callsign, sizeof(callsign), "DL%uABC", i % 10U);
+		::snprintf(name, sizeof(name), "Name%u", i % 500U);
+		::snprintf(city, sizeof(city), "City %u", i % 900U);
+
+		static const char* COUNTRIES[] = {"Germany", "United Kingdom", "United States", "France"};
+		if (!hasFields(userDB, 2620000U + i * 7U, callsign, name, city, COUNTRIES[i % 4U]))
+			wrong++;
+	}
+	CHECK(wrong == 0U);
+
+	unsigned int found = 0U;
+	for (unsigned int i = 0U; i < ROWS; i++) {
+		if (userDB.lookup(2620000U + i * 7U + 1U + i % 6U, NULL))
+			found++;
+	}
+	CHECK(found == 0U);
+	CHECK(!userDB.lookup(0U, NULL) && !userDB.lookup(0xFFFFFFFFU, NULL));
+
+	// An ID, a row of offsets and the few strings that aren't repeats
+	CHECK(userDB.getMemory() < ROWS * 48U);
+}
+
+// A later row for the same ID replaces the earlier one
+static void testDuplicates(CTestDir& dir)
+{
+	std::string filename = dir.write("duplicates.dat",
+		"RADIO_ID,CALLSIGN,FIRST_NAME,LAST_NAME,CITY,STATE,COUNTRY\n"
+		"2621234,DL1ABC,Hans,Mustermann,Berlin,Berlin,Germany\n"
+		"2621235,DL1ABD,Erika,Musterfrau,Hamburg,Hamburg,Germany\n"
+		"2621234,DL1XYZ,Fritz,Mustermann,Bonn,NRW,Germany\n");
+
+	CUserDB userDB;
+	CHECK(userDB.load(filename));
+	CHECK(userDB.getSize() == 2U);
+	CHECK(hasFields(userDB, 2621234U, "DL1XYZ", "Fritz", "Bonn", "Germany"));
+	CHECK(hasFields(userDB, 2621235U, "DL1ABD", "Erika", "Hamburg", "Germany"));
+}
+
+static std::string readFile(const std::string& filename)
+{
+	std::string text;
+
+	FILE* fp = ::fopen(filename.c_str(), "rb");
+	if (fp == NULL)
+		return text;
+
+	char buffer[65536U];
+	size_t n;
+	while ((n = ::fread(buffer, 1U, sizeof(buffer), fp)) > 0U)
+		text.append(buffer, n);
+
+	::fclose(fp);
+
+	return text;
+}
+
+// Any number of threads builds the same table as one, duplicates included,
+// compared as the compiled files they save
+static void testThreads(CTestDir& dir)
+{
+	// Enough for every thread to get a chunk of its own, and an ID that
+	// appears in the first and the last chunk
+	std::string text = makeCSV(60000U);
+	text += "2620000,DL9ZZZ,Last,Row,Bonn,NRW,Germany\n";
+	std::string filename = dir.write("threads.dat", text);
+
+	std::string expected;
+	static const unsigned int THREADS[] = {1U, 2U, 3U, 4U, 7U};
+	for (unsigned int i = 0U; i < sizeof(THREADS) / sizeof(THREADS[0U]); i++) {
+		CUserDB userDB(THREADS[i]);
+		CHECK(userDB.load(filename));
+		CHECK(hasFields(userDB, 2620000U, "DL9ZZZ", "Last", "Bonn", "Germany"));
+
+		std::string compiled = dir.path("threads.bin");
+		CHECK(userDB.save(compiled));
+
+		if (i == 0U)
+			expected = readFile(compiled);
+		else
+			CHECK(readFile(compiled) == expected);
+	}
+
+	CHECK(expected.size() > 0U);
+}
+
+// Rewriting a lazily loaded file in place, shorter, used to SIGBUS on the
+// next lookup past its new end
+static void testLazyRewrite(CTestDir& dir)
+{
+	const unsigned int ROWS = 20000U;
+	const unsigned int LAST = 2620000U + (ROWS - 1U) * 7U;
+
+	std::string filename = dir.write("Lazy.dat", makeCSV(ROWS));
+
+	CUserDB userDB;
+	userDB.setLazy(true);
+	CHECK(userDB.load(filename));
+	CHECK(hasFields(userDB, LAST, "DL9ABC", "Name499", "City 199", "France"));
+
+	// Truncated and written again, as cp, curl -o and wget -O do
+	dir.write("Lazy.dat", makeCSV(10U));
+
+	CHECK(!userDB.lookup(LAST, NULL));
+	CHECK(!userDB.lookup(2620007U, NULL));
+
+	// Until it is loaded again
+	CHECK(userDB.load(filename));
+	CHECK(userDB.getSize() == 10U);
+	CHECK(hasFields(userDB, 2620007U, "DL1ABC", "Name1", "City 1", "United Kingdom"));
+	CHECK(!userDB.lookup(LAST, NULL));
+}
+
+// The lines the displays draw, built once when an ID is cached
+static void testLines(CTestDir& dir)
+{
+	CUserDBentry entry;
+	entry.set(UDF_CALLSIGN, "DL1ABC");
+	entry.set(UDF_FIRST_NAME, "Hans");
+	entry.set(UDF_LAST_NAME, "Mustermann");
+	entry.format();
+	CHECK(::strcmp(entry.getLine(UDL_CALL_NAME), "DL1ABC Hans") == 0);
+	CHECK(::strcmp(entry.getLine(UDL_FULL_NAME), "Hans Mustermann") == 0);
+
+	// No space for a missing part
+	entry.clear();
+	entry.set(UDF_CALLSIGN, "DL1ABC");
+	entry.set(UDF_LAST_NAME, "Mustermann");
+	entry.format();
+	CHECK(::strcmp(entry.getLine(UDL_CALL_NAME), "DL1ABC") == 0);
+	CHECK(::strcmp(entry.getLine(UDL_FULL_NAME), "Mustermann") == 0);
+
+	entry.clear();
+	CHECK(::strcmp(entry.getLine(UDL_CALL_NAME), "") == 0);
+
+	// Without room for both parts, just the first
+	std::string name(100U, 'N');
+	entry.set(UDF_CALLSIGN, "DL1ABC");
+	entry.set(UDF_FIRST_NAME, name.c_str());
+	entry.format();
+	CHECK(::strcmp(entry.getLine(UDL_CALL_NAME), "DL1ABC") == 0);
+
+	std::string filename = dir.write("lines.dat", makeCSV(10U));
+	CDMRLookup* lookup = new CDMRLookup(filename, 0U);
+	CHECK(lookup->read());
+
+	// The second lookup comes from the cache
+	for (unsigned int i = 0U; i < 2U; i++) {
+		lookup->findUser(2620007U, entry);
+		CHECK(::strcmp(entry.getLine(UDL_CALL_NAME), "DL1ABC Name1") == 0);
+		CHECK(::strcmp(entry.getLine(UDL_FULL_NAME), "Name1 Surname1") == 0);
+	}
+	CHECK(lookup->getCacheHits() == 1ULL);
+
+	// An unknown ID is shown as its number
+	lookup->findUser(1234567U, entry);
+	CHECK(::strcmp(entry.getLine(UDL_CALL_NAME), "1234567") == 0);
+
+	lookup->stop();
+}
+
+int main()
+{
+	LogInitialise(0U, false);
+
+	CTestDir dir;
+
+	testTable(dir);
+	testDuplicates(dir);
+	testThreads(dir);
+	testLazyRewrite(dir);
+	testLines(dir);
+
+	LogFinalise();
+
+	return TEST_RESULT();
+}
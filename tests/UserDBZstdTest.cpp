@@ -0,0 +1,122 @@
+/*
+ *   Copyright (C) 2026 by BrandMeister
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "Test.h"
+
+#if defined(HAVE_ZSTD)
+#include "UserDBFiles.h"
+
+#include "Log.h"
+
+#include <zstd.h>
+#endif
+
+#include <string>
+
+#include <cstdint>
+#include <cstdio>
+
+#if defined(HAVE_ZSTD)
+// Rows that hardly compress, so that the compressed file spans many of
+// the stream's reads
+static std::string makeCSV(unsigned int n)
+{
+	std::string text = "RADIO_ID,CALLSIGN,FIRST_NAME,LAST_NAME,CITY,STATE,COUNTRY\n";
+
+	uint32_t state = 2620U;
+	char line[200U];
+	for (unsigned int i = 0U; i < n; i++) {
+		char random[4U][9U];
+		for (unsigned int j = 0U; j < 4U; j++) {
+			for (unsigned int k = 0U; k < 8U; k++) {
+				state = state * 1103515245U + 12345U;
+				random[j][k] = 'a' + (state >> 16) % 26U;
+			}
+			random[j][8U] = '\0';
+		}
+
+		::snprintf(line, sizeof(line), "%u,DL%u%.3s,%s,%s,%s,%s,Germany\n", 2620000U + i * 3U, i % 10U, random[0U], random[1U],
+			random[2U], random[3U], random[0U] + 3);
+		text += line;
+	}
+
+	return text;
+}
+
+// One frame with a checksum, as the zstd tool writes
+static std::string compress(const std::string& text)
+{
+	std::string out(::ZSTD_compressBound(text.size()), '\0');
+
+	ZSTD_CCtx* ctx = ::ZSTD_createCCtx();
+	::ZSTD_CCtx_setParameter(ctx, ZSTD_c_checksumFlag, 1);
+
+	size_t n = ::ZSTD_compress2(ctx, &out[0U], out.size(), text.data(), text.size());
+	::ZSTD_freeCCtx(ctx);
+
+	if (::ZSTD_isError(n))
+		return std::string();
+
+	out.resize(n);
+	return out;
+}
+
+// Larger than the stream's input and output blocks, in one frame and in
+// several, and cut short or corrupted
+static void testZstdStream(CTestDir& dir)
+{
+	std::string csv = makeCSV(40000U);
+	std::string expected = compile(dir, dir.write("large.csv", csv));
+	CHECK(!expected.empty());
+
+	std::string zst = compress(csv);
+	CHECK(zst.size() > 4U * ::ZSTD_DStreamInSize());
+	CHECK(compile(dir, dir.write("large.zst", zst)) == expected);
+
+	// Frames split part way through a line, as zstd writes for a file made by
+	// concatenating .zst files
+	size_t half = csv.size() / 2U + 7U;
+	std::string frames = compress(csv.substr(0U, half)) + compress(csv.substr(half));
+	CHECK(compile(dir, dir.write("frames.zst", frames)) == expected);
+
+	std::string truncated = zst.substr(0U, zst.size() - 100U);
+	CHECK(compile(dir, dir.write("truncated.zst", truncated)).empty());
+
+	std::string corrupt = zst;
+	for (size_t i = corrupt.size() / 2U; i < corrupt.size() / 2U + 64U; i++)
+		corrupt[i] = ~corrupt[i];
+	CHECK(compile(dir, dir.write("corrupt.zst", corrupt)).empty());
+}
+#endif
+
+int main()
+{
+#if defined(HAVE_ZSTD)
+	LogInitialise(0U, false);
+
+	CTestDir dir;
+
+	testZstdStream(dir);
+
+	LogFinalise();
+
+	return TEST_RESULT();
+#else
+	return TEST_SKIP("built without zstd, set ZSTD_INCLUDE_DIR and ZSTD_LIBRARY to test it");
+#endif
+}